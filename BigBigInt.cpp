@@ -35,37 +35,390 @@
 //  in any way.
 //
 // ------------------------------------------------------------
-//  A note about Endianness
 // ------------------------------------------------------------
+//  A note about the storage layout
+// ------------------------------------------------------------
+//
+//  The number is kept as a magnitude plus a sign flag (_flags).
+//  The magnitude is an array of BBI_BASE_TYPE "limbs" (64-bit
+//  words) stored least significant limb first, each limb in the
+//  machine's native byte order.  This is the opposite of the
+//  "written" order, but it lets every loop below work a whole
+//  machine word at a time and lets carries run upwards through
+//  memory.
+//
+//  Earlier versions kept the number as a big endian byte string
+//  and had to flip the bytes of every value on its way in and out
+//  (REVERSE_BYTE_ORDER).  Since the limbs are native now, the
+//  endianness of the architecture only matters when a bigbigint is
+//  exchanged as raw bytes with the outside world.
+//
+//  _length is the number of limbs allocated.  The limbs past the
+//  most significant non-zero limb are always zero.
 //
-//  For readability purposes, the BigBigInt class always uses
-//  Big Endian.  Essentially, this means that the larger
-//  numbers are stored on the left (like you'd normally see it
-//  written).  Little endian, by comparison, stores the numbers
-//  in reverse order.  The hexedecimal value of 0x1234 would
-//  be stored as 0x3412.  0x12345678 would be 0x78563412.  (The
-//  bytes are reversed, not the numbers--i.e. reverse byte order.)
-//
-//  Because some computer architecture stores them in little
-//  endian format (which is the case with all Intel architecture),
-//  we have to reverse the bytes in the integer before we store
-//  them into our BigBigInt.
-//
-//  The following #define allows us to declare the architecture
-//  as Big Endian, if we need to.  Simply uncomment the define
-//  below and add a # sign.
-//  
-//  define MEM_ARCH_USES_BIG_ENDIAN true
-//
-//  Note: This must be defined before the BigBigInt.h header
-//
-//  Note: Only do this if you fully understand the impact.  
-//  If you're on a standard Intel machine (which is probably  
-//  the case), you don't want to mess with this.
 // ------------------------------------------------------------
 #include "BigBigInt.h"
+#include "BigBigIntMpn.h"
 #include <stdio.h>
 #include <memory.h>
+#include <string>
+#include <istream>
+#include <ostream>
+#include <errno.h>
+#if defined(WIN32)
+    #include <io.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/uio.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+#if defined(BBI_ENABLE_STATS) || defined(BBI_ENABLE_TRACE)
+    #include <atomic>
+    #include <mutex>
+#endif
+#if defined(BBI_ENABLE_TRACE)
+    #include <chrono>
+    #include <vector>
+#endif
+
+
+/*******************************************
+ *               STATISTICS                *
+ *******************************************/
+//
+//  Each thread counts into a block of its own, so counting is a 
+//  plain add:  no lock, and no cache line shared with other threads.
+//  The counters are relaxed atomics only so that stats(true) can 
+//  read them from another thread; the owner's load/add/store 
+//  compiles to the same instructions as a plain +=.
+//
+//  The blocks are kept on a list (under bbi_stats_lock) for 
+//  stats(true) to walk, and a thread's counts move over to 
+//  bbi_stats_retired when it exits.
+//
+//  Without BBI_ENABLE_STATS the BBI_STAT_ macros are empty.
+//
+#if defined(BBI_ENABLE_STATS)
+
+//  The counters in a block, in bbi_stats order
+#define BBI_STATS_CALLS             0
+#define BBI_STATS_LIMBS             BBI_STAT_NUM_OPS
+#define BBI_STATS_MALLOCS           (2 * BBI_STAT_NUM_OPS)
+#define BBI_STATS_UPSIZES           (BBI_STATS_MALLOCS + 1)
+#define BBI_STATS_COPIES            (BBI_STATS_MALLOCS + 2)
+#define BBI_STATS_BYTES_ALLOCATED   (BBI_STATS_MALLOCS + 3)
+#define BBI_STATS_BYTES_COPIED      (BBI_STATS_MALLOCS + 4)
+#define BBI_STATS_NUM_COUNTERS      (BBI_STATS_MALLOCS + 5)
+
+struct bbi_stats_block
+{
+    std::atomic<uint64_t> counters[BBI_STATS_NUM_COUNTERS];
+    bbi_stats_block *prev, *next;
+
+    bbi_stats_block();
+    ~bbi_stats_block();
+
+    void add(int counter, uint64_t amount)
+    {
+        this->counters[counter].store(
+            this->counters[counter].load(std::memory_order_relaxed) + amount, 
+            std::memory_order_relaxed);
+    }
+};
+
+static std::mutex bbi_stats_lock;
+static bbi_stats_block *bbi_stats_threads = NULL;
+static uint64_t bbi_stats_retired[BBI_STATS_NUM_COUNTERS];
+
+bbi_stats_block::bbi_stats_block()
+{
+    int i;
+
+    for (i = 0; i < BBI_STATS_NUM_COUNTERS; i++) {
+        this->counters[i].store(0, std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> guard(bbi_stats_lock);
+    this->prev = NULL;
+    this->next = bbi_stats_threads;
+    if (this->next != NULL) {
+        this->next->prev = this;
+    }
+    bbi_stats_threads = this;
+}
+
+bbi_stats_block::~bbi_stats_block()
+{
+    int i;
+
+    std::lock_guard<std::mutex> guard(bbi_stats_lock);
+    for (i = 0; i < BBI_STATS_NUM_COUNTERS; i++) {
+        bbi_stats_retired[i] += this->counters[i].load(std::memory_order_relaxed);
+    }
+    if (this->prev != NULL) {
+        this->prev->next = this->next;
+    }
+    else {
+        bbi_stats_threads = this->next;
+    }
+    if (this->next != NULL) {
+        this->next->prev = this->prev;
+    }
+}
+
+static thread_local bbi_stats_block bbi_thread_stats;
+
+#define BBI_STAT_OP(__op, __limbs)                                      \
+    {                                                                   \
+        bbi_thread_stats.add(BBI_STATS_CALLS + (__op), 1);              \
+        bbi_thread_stats.add(BBI_STATS_LIMBS + (__op), (__limbs));      \
+    }
+#define BBI_STAT_ALLOC(__counter, __bytes)                              \
+    {                                                                   \
+        bbi_thread_stats.add(__counter, 1);                             \
+        bbi_thread_stats.add(BBI_STATS_BYTES_ALLOCATED, (__bytes));     \
+    }
+#define BBI_STAT_COPY(__bytes)                                          \
+    {                                                                   \
+        bbi_thread_stats.add(BBI_STATS_COPIES, 1);                      \
+        bbi_thread_stats.add(BBI_STATS_BYTES_COPIED, (__bytes));        \
+    }
+
+//  Prints the table at exit for write_stats_at_exit() or 
+//  BBI_STATS_DUMP.  The main thread's block is gone by then, but its
+//  counts have been retired.
+static int bbi_stats_exit_fd = -1;
+
+struct bbi_stats_exit
+{
+    bbi_stats_exit()
+    {
+        if (bbi_stats_exit_fd < 0 && getenv("BBI_STATS_DUMP") != NULL) {
+            bbi_stats_exit_fd = 2;
+        }
+    }
+    ~bbi_stats_exit()
+    {
+        if (bbi_stats_exit_fd >= 0) {
+            bigbigint::write_stats(bbi_stats_exit_fd, true);
+        }
+    }
+};
+
+static bbi_stats_exit bbi_stats_at_exit;
+
+#else
+
+#define BBI_STAT_OP(__op, __limbs)
+#define BBI_STAT_ALLOC(__counter, __bytes)
+#define BBI_STAT_COPY(__bytes)
+
+#endif
+
+
+/*******************************************
+ *                TRACING                  *
+ *******************************************/
+//
+//  BBI_TRACE(op, limbs) at the top of an operation puts a 
+//  bbi_trace_scope on the stack that times it to the end of the 
+//  function.  While tracing is stopped bbi_trace_min is ULONG_MAX, so
+//  all an operation pays is the load and compare.
+//
+//  The histograms are log-linear like HDR histograms:  exact below 
+//  2*BBI_HIST_SUB ns, and above that BBI_HIST_SUB buckets for every
+//  power of two, so a value is off by less than 1/BBI_HIST_SUB 
+//  (6.25%) from 1ns to 584 years.  There is one for each operation 
+//  and size class, allocated the first time it's needed and only ever
+//  cleared after that.  They're shared by all threads; the operations
+//  timed are big enough that a few atomic adds don't show.
+//
+//  The events go on one list under bbi_trace_lock, up to the number
+//  asked for in trace_start().  They nest (a powmod holds its muls and
+//  divs), which the trace viewers draw as a stack.
+//
+//  Without BBI_ENABLE_TRACE BBI_TRACE is empty.
+//
+#if defined(BBI_ENABLE_TRACE)
+
+#define BBI_HIST_SUB_BITS   4
+#define BBI_HIST_SUB        (1 << BBI_HIST_SUB_BITS)
+#define BBI_HIST_BUCKETS    ((BBI_BASE_BITS - BBI_HIST_SUB_BITS + 1) * BBI_HIST_SUB)
+#define BBI_TRACE_CLASSES   BBI_BASE_BITS
+
+struct bbi_histogram
+{
+    std::atomic<uint64_t> count, total_ns, min_ns, max_ns;
+    std::atomic<uint64_t> buckets[BBI_HIST_BUCKETS];
+};
+
+struct bbi_trace_event
+{
+    uint64_t start_ns, ns;
+    unsigned long limbs;
+    unsigned int thread;
+    int op;
+};
+
+static std::atomic<unsigned long> bbi_trace_min(ULONG_MAX);
+static std::atomic<bbi_histogram *> bbi_trace_hists[BBI_STAT_NUM_OPS][BBI_TRACE_CLASSES];
+static std::atomic<bbi_trace_begin_hook> bbi_trace_begin_fn(NULL);
+static std::atomic<bbi_trace_end_hook> bbi_trace_end_fn(NULL);
+static std::atomic<void *> bbi_trace_user(NULL);
+
+static std::mutex bbi_trace_lock;
+static std::vector<bbi_trace_event> bbi_trace_events;
+static unsigned long bbi_trace_max_events = 0;
+static unsigned long bbi_trace_dropped = 0;
+static uint64_t bbi_trace_epoch = 0;
+static std::atomic<unsigned int> bbi_trace_next_thread(1);
+static thread_local unsigned int bbi_trace_thread = 0;
+
+static uint64_t bbi_trace_now()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//  Size class:  the number of bits in limbs, so class c holds 
+//  2^(c-1) through 2^c - 1 limbs
+static unsigned int bbi_trace_class(unsigned long limbs)
+{
+    return (limbs == 0) ? 0 : (unsigned int)(BBI_BASE_BITS - BBI_CLZ((BBI_BASE_TYPE)limbs));
+}
+
+static unsigned int bbi_hist_bucket(uint64_t ns)
+{
+    unsigned int top;
+
+    if (ns < BBI_HIST_SUB) {
+        return (unsigned int)ns;
+    }
+    top = BBI_BASE_BITS - 1 - BBI_CLZ(ns);
+    return ((top - BBI_HIST_SUB_BITS + 1) << BBI_HIST_SUB_BITS) + 
+           (unsigned int)((ns >> (top - BBI_HIST_SUB_BITS)) & (BBI_HIST_SUB - 1));
+}
+
+//  The largest value that goes in a bucket
+static uint64_t bbi_hist_bucket_top(unsigned int bucket)
+{
+    unsigned int top;
+
+    if (bucket < 2 * BBI_HIST_SUB) {
+        return bucket;
+    }
+    top = (bucket >> BBI_HIST_SUB_BITS) + BBI_HIST_SUB_BITS - 1;
+    return ((((uint64_t)BBI_HIST_SUB + (bucket & (BBI_HIST_SUB - 1)) + 1) << (top - BBI_HIST_SUB_BITS)) - 1);
+}
+
+static void bbi_hist_record(int op, unsigned long limbs, uint64_t ns)
+{
+    std::atomic<bbi_histogram *> &slot = bbi_trace_hists[op][bbi_trace_class(limbs)];
+    bbi_histogram *hist, *expected;
+    uint64_t seen;
+
+    hist = slot.load(std::memory_order_acquire);
+    if (hist == NULL) {
+        //  First one of its kind.  If another thread gets there first
+        //  its histogram is used and this one thrown away.
+        hist = new bbi_histogram();
+        hist->min_ns.store(UINT64_MAX, std::memory_order_relaxed);
+        expected = NULL;
+        if (!slot.compare_exchange_strong(expected, hist, std::memory_order_acq_rel)) {
+            delete hist;
+            hist = expected;
+        }
+    }
+
+    hist->count.fetch_add(1, std::memory_order_relaxed);
+    hist->total_ns.fetch_add(ns, std::memory_order_relaxed);
+    hist->buckets[bbi_hist_bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    seen = hist->min_ns.load(std::memory_order_relaxed);
+    while (ns < seen && !hist->min_ns.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+    }
+    seen = hist->max_ns.load(std::memory_order_relaxed);
+    while (ns > seen && !hist->max_ns.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+    }
+}
+
+static uint64_t bbi_trace_begin(int op, unsigned long limbs)
+{
+    bbi_trace_begin_hook begin = bbi_trace_begin_fn.load(std::memory_order_acquire);
+
+    if (begin != NULL) {
+        begin(op, limbs, bbi_trace_user.load(std::memory_order_relaxed));
+    }
+    return bbi_trace_now();
+}
+
+static void bbi_trace_end(int op, unsigned long limbs, uint64_t start_ns)
+{
+    bbi_trace_end_hook end;
+    bbi_trace_event event;
+    uint64_t ns = bbi_trace_now() - start_ns;
+
+    bbi_hist_record(op, limbs, ns);
+
+    {
+        std::lock_guard<std::mutex> guard(bbi_trace_lock);
+        if (bbi_trace_events.size() < bbi_trace_max_events) {
+            if (bbi_trace_thread == 0) {
+                bbi_trace_thread = bbi_trace_next_thread.fetch_add(1, std::memory_order_relaxed);
+            }
+            event.start_ns = start_ns - bbi_trace_epoch;
+            event.ns = ns;
+            event.limbs = limbs;
+            event.thread = bbi_trace_thread;
+            event.op = op;
+            bbi_trace_events.push_back(event);
+        }
+        else if (bbi_trace_max_events != 0) {
+            bbi_trace_dropped++;
+        }
+    }
+
+    end = bbi_trace_end_fn.load(std::memory_order_acquire);
+    if (end != NULL) {
+        end(op, limbs, ns, bbi_trace_user.load(std::memory_order_relaxed));
+    }
+}
+
+class bbi_trace_scope
+{
+public:
+    bbi_trace_scope(int op, unsigned long limbs)
+    {
+        this->_op = -1;
+        if (limbs >= bbi_trace_min.load(std::memory_order_relaxed)) {
+            this->_op = op;
+            this->_limbs = limbs;
+            this->_start_ns = bbi_trace_begin(op, limbs);
+        }
+    }
+    ~bbi_trace_scope()
+    {
+        if (this->_op >= 0) {
+            bbi_trace_end(this->_op, this->_limbs, this->_start_ns);
+        }
+    }
+
+private:
+    int _op;
+    unsigned long _limbs;
+    uint64_t _start_ns;
+};
+
+#define BBI_TRACE(__op, __limbs)    bbi_trace_scope bbi_trace_this_op((__op), (__limbs))
+
+#else
+
+#define BBI_TRACE(__op, __limbs)
+
+#endif
 
 
 /*******************************************
@@ -77,6 +430,39 @@ bigbigint::bigbigint(bigbigint const& copy)
     this->copy((bigbigint*)&copy);
 }
 
+//
+//  A zero view may have no limbs at all (_limbs NULL), so there's 
+//  nothing to copy.
+bigbigint::bigbigint(const bigbigint_view &view)
+{
+    this->_constructor(view._size);
+    if (view._size != 0) {
+        memcpy(this->_limbs, view._limbs, view._size * sizeof(BBI_BASE_TYPE));
+        BBI_STAT_COPY(view._size * sizeof(BBI_BASE_TYPE));
+    }
+    this->_flags = (view._negative ? BBI_NEGATIVE : 0);
+}
+
+//
+//  Borrows the view's limbs (see BBI_STORAGE_BORROWED).  Zero gets 
+//  limbs of its own, so _limbs is never NULL.
+bigbigint::bigbigint(const bigbigint_view &view, _borrow_tag)
+{
+    static const BBI_BASE_TYPE zero[BBI_MIN_SIZE] = { 0 };
+
+    if (view._size == 0) {
+        this->_limbs = (BBI_BASE_TYPE *)zero;
+        this->_length = BBI_MIN_SIZE;
+    }
+    else {
+        this->_limbs = (BBI_BASE_TYPE *)view._limbs;
+        this->_length = view._size;
+    }
+    this->_num_bytes = this->_length * sizeof(BBI_BASE_TYPE);
+    this->_flags = (view._negative ? BBI_NEGATIVE : 0);
+    this->_storage = BBI_STORAGE_BORROWED;
+}
+
 bigbigint::bigbigint(long size)
 {
     this->_constructor(size);
@@ -100,9 +486,11 @@ void bigbigint::_constructor(long size)
     // Setup internal vars
     this->_length = size;
     this->_num_bytes = size * sizeof(BBI_BASE_TYPE);
+    this->_flags = 0;
 
     // Malloc size.
     this->_malloc(this->_num_bytes);
+    this->zero_fill();
 }
 
 
@@ -110,109 +498,2777 @@ void bigbigint::_constructor(long size)
  *           INTERNAL FUNCTIONS            *
  *******************************************/
 
+//
+//  Unmaps limbs that load_mapped() left in a file mapping.  The 
+//  mapping starts at the page holding the first limb.
+static void bbi_unmap_limbs(BBI_BASE_TYPE *limbs, unsigned long num_bytes)
+{
+#if defined(WIN32)
+    (void)limbs;
+    (void)num_bytes;
+#else
+    uintptr_t start, page_size;
+
+    page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+    start = (uintptr_t)limbs & ~(page_size - 1);
+    munmap((void *)start, ((uintptr_t)limbs - start) + num_bytes);
+#endif
+}
+
 //
 //  Malloc / Free (internal)
 //
 void bigbigint::_free()
 {    
-    free((void*)this->_first_byte);
-    this->_first_byte = NULL;
+    if (this->_storage == BBI_STORAGE_MAPPED || 
+        this->_storage == BBI_STORAGE_MAPPED_READ) {
+        bbi_unmap_limbs(this->_limbs, this->_num_bytes);
+    }
+    else if (this->_storage == BBI_STORAGE_MALLOC) {
+        free((void*)this->_limbs);
+    }
+    this->_limbs = NULL;
     this->_num_bytes = 0;
     this->_length = 0;
+    this->_storage = BBI_STORAGE_MALLOC;
 }
 
 
 void bigbigint::_malloc(unsigned long num_bytes)
 {    
-    this->_first_byte = (unsigned char*)malloc(num_bytes);
-    if (this->_first_byte == NULL)
+    this->_limbs = (BBI_BASE_TYPE*)malloc(num_bytes);
+    if (this->_limbs == NULL)
         exit(2);
+    this->_storage = BBI_STORAGE_MALLOC;
+    BBI_STAT_ALLOC(BBI_STATS_MALLOCS, num_bytes);
 }
 
 //
 //  UpSize (internal utility)
 //
+//  Grows the number to new_length limbs, keeping the value.
+//  The new (most significant) limbs are zeroed.
 void bigbigint::_upsize(unsigned long new_length)
 {
-    unsigned char* save_ptr;
-    unsigned long save_num_bytes, offset;
-
-    save_ptr = (unsigned char*)this->_first_byte;
-    save_num_bytes = this->_num_bytes;
+    BBI_BASE_TYPE* new_ptr;
+    unsigned long save_length;
+
+    save_length = this->_length;
+    BBI_STAT_ALLOC(BBI_STATS_UPSIZES, new_length * sizeof(BBI_BASE_TYPE));
+
+    if (this->_storage != BBI_STORAGE_MALLOC) {
+        // Off the file (or someone else's limbs) and onto the heap
+        new_ptr = (BBI_BASE_TYPE*)malloc(new_length * sizeof(BBI_BASE_TYPE));
+        if (new_ptr == NULL)
+            exit(2);
+        memcpy(new_ptr, this->_limbs, save_length * sizeof(BBI_BASE_TYPE));
+        if (this->_storage == BBI_STORAGE_MAPPED || 
+            this->_storage == BBI_STORAGE_MAPPED_READ) {
+            bbi_unmap_limbs(this->_limbs, this->_num_bytes);
+        }
+        this->_storage = BBI_STORAGE_MALLOC;
+    }
+    else {
+        new_ptr = (BBI_BASE_TYPE*)realloc(this->_limbs, new_length * sizeof(BBI_BASE_TYPE));
+        if (new_ptr == NULL)
+            exit(2);
+    }
 
+    this->_limbs = new_ptr;
     this->_length = new_length;
     this->_num_bytes = new_length * sizeof(BBI_BASE_TYPE);
 
-    this->_malloc(this->_num_bytes);
+    memset(this->_limbs + save_length, 0, 
+        (new_length - save_length) * sizeof(BBI_BASE_TYPE));
+}
+
+//
+//  PreSize (internal utility)
+//
+//  Makes sure there is room for new_length limbs.  Unlike _upsize,
+//  the current value is thrown away (the caller is about to
+//  overwrite it), so nothing gets copied.
+void bigbigint::_presize(unsigned long new_length)
+{
+    if (new_length <= this->_length) {
+        this->_writable(false);
+        return;
+    }
 
-    offset = this->_num_bytes - save_num_bytes;
-    memset(this->_first_byte, 0, offset);
-    memcpy(this->_first_byte + offset, save_ptr, save_num_bytes);
-    
-    free(save_ptr);
+    this->_free();
+    this->_constructor(new_length);
 }
 
 //
-//  Zero Fill (internal utility)
+//  Reserve (internal utility)
+//
+//  Same as _upsize, but only ever grows.
+void bigbigint::_reserve(unsigned long new_length)
+{
+    if (new_length > this->_length) {
+        this->_upsize(new_length);
+    }
+    else {
+        this->_writable();
+    }
+}
+
+//
+//  Writable (internal utility)
+//
+//  Anything that writes to the limbs in place calls this (or one of
+//  the sizing functions above, which do) first.  A read-only mapping
+//  would fault, so the first write moves it to the heap, copying the
+//  value unless keep is false (the caller is about to overwrite it).
+void bigbigint::_writable(bool keep)
+{
+    BBI_BASE_TYPE *new_ptr;
+
+    if (this->_storage != BBI_STORAGE_MAPPED_READ) return;
+
+    new_ptr = (BBI_BASE_TYPE*)malloc(this->_num_bytes);
+    if (new_ptr == NULL)
+        exit(2);
+    BBI_STAT_ALLOC(BBI_STATS_MALLOCS, this->_num_bytes);
+    if (keep) {
+        memcpy(new_ptr, this->_limbs, this->_num_bytes);
+    }
+    bbi_unmap_limbs(this->_limbs, this->_num_bytes);
+    this->_limbs = new_ptr;
+    this->_storage = BBI_STORAGE_MALLOC;
+}
+
+//
+//  Swap (internal utility)
 //
-void bigbigint::zero_fill(unsigned long num_byts_to_fill)
+void bigbigint::_swap(bigbigint &other)
 {
-    if (num_byts_to_fill == 0) return;
-    memset(this->_first_byte, '\0', num_byts_to_fill);
+    BBI_BASE_TYPE *save_limbs;
+    unsigned long save_num_bytes, save_length;
+    unsigned char save_flags, save_storage;
+
+    save_limbs = this->_limbs;
+    save_num_bytes = this->_num_bytes;
+    save_length = this->_length;
+    save_flags = this->_flags;
+    save_storage = this->_storage;
+
+    this->_limbs = other._limbs;
+    this->_num_bytes = other._num_bytes;
+    this->_length = other._length;
+    this->_flags = other._flags;
+    this->_storage = other._storage;
+
+    other._limbs = save_limbs;
+    other._num_bytes = save_num_bytes;
+    other._length = save_length;
+    other._flags = save_flags;
+    other._storage = save_storage;
 }
 
+//
+//  Zero Fill (internal utility)
+//
 void bigbigint::zero_fill()
 {
-    memset(this->_first_byte, '\0', this->_num_bytes);
+    this->_writable(false);
+    memset(this->_limbs, '\0', this->_num_bytes);
+}
+
+
+/*******************************************
+ *          SIGNED LIMB KERNELS            *
+ *******************************************/
+//
+//  The unsigned limb kernels are the public layer in BigBigIntMpn.h.
+//  These two add our sign rules on top of them, still working on 
+//  raw limb arrays.
+//
+
+//
+//  r = a + b on signed values  (a_neg/b_neg give the signs)
+//
+//  This is the one place the sign rules for adding and subtracting
+//  live; subtraction is just adding with b_neg flipped.  Same signs
+//  add the magnitudes.  Different signs compare the magnitudes once
+//  and take the smaller from the larger, and the result gets the
+//  larger one's sign.
+//
+//  an and bn must be the normalized sizes.  r needs room for
+//  MAX(an, bn) + 1 limbs and may be a or b.  *rn gets the number of
+//  limbs written; anything above that is left alone.  Returns true
+//  when the result is negative (never for zero).
+static bool bbi_add_signed(BBI_BASE_TYPE *r, 
+                           const BBI_BASE_TYPE *a, unsigned long an, bool a_neg, 
+                           const BBI_BASE_TYPE *b, unsigned long bn, bool b_neg, 
+                           unsigned long *rn)
+{
+    int comp_result;
+
+    if (a_neg == b_neg) {
+        if (an >= bn) {
+            r[an] = bbi_add(r, a, an, b, bn);
+            *rn = an + 1;
+        }
+        else {
+            r[bn] = bbi_add(r, b, bn, a, an);
+            *rn = bn + 1;
+        }
+        return (a_neg && (an != 0 || bn != 0));
+    }
+
+    comp_result = bbi_cmp(a, an, b, bn);
+    if (comp_result >= 0) {
+        bbi_sub(r, a, an, b, bn);
+        *rn = an;
+        return (a_neg && comp_result != 0);
+    }
+    bbi_sub(r, b, bn, a, an);
+    *rn = bn;
+    return b_neg;
+}
+
+//
+//  r = a op b  (op is '&', '|' or '^') on signed values, with the 
+//  meaning they have for two's complement:  a negative value acts 
+//  as if it were -|a| with an endless run of 1 bits above its top
+//  limb.  Returns true when the result is negative, r holds its 
+//  magnitude.
+//
+//  Each operand is negated on the fly (~m + carry) while we walk up
+//  the limbs, and a negative result is negated back the same way,
+//  so this is still a single pass.  n must be at least one more 
+//  than the longer operand to leave room for the sign limb.  r may
+//  be a (but not b).
+static bool bbi_logic_signed(BBI_BASE_TYPE *r, unsigned long n, char op,
+                             const BBI_BASE_TYPE *a, unsigned long an, bool a_negative,
+                             const BBI_BASE_TYPE *b, unsigned long bn, bool b_negative)
+{
+    BBI_BASE_TYPE a_mask, b_mask, r_mask, a_carry, b_carry, r_carry;
+    BBI_BASE_TYPE a_limb, b_limb, r_limb;
+    unsigned long i;
+    bool r_negative;
+
+    if (op == '&') {
+        r_negative = (a_negative && b_negative);
+    }
+    else if (op == '|') {
+        r_negative = (a_negative || b_negative);
+    }
+    else {
+        r_negative = (a_negative != b_negative);
+    }
+
+    a_mask = (a_negative ? ~(BBI_BASE_TYPE)0 : 0);
+    b_mask = (b_negative ? ~(BBI_BASE_TYPE)0 : 0);
+    r_mask = (r_negative ? ~(BBI_BASE_TYPE)0 : 0);
+    a_carry = a_negative;
+    b_carry = b_negative;
+    r_carry = r_negative;
+
+    for (i = 0; i < n; i++) {
+        a_limb = ((i < an ? a[i] : 0) ^ a_mask) + a_carry;
+        a_carry = (a_carry && a_limb == 0);
+        b_limb = ((i < bn ? b[i] : 0) ^ b_mask) + b_carry;
+        b_carry = (b_carry && b_limb == 0);
+
+        if (op == '&') {
+            r_limb = a_limb & b_limb;
+        }
+        else if (op == '|') {
+            r_limb = a_limb | b_limb;
+        }
+        else {
+            r_limb = a_limb ^ b_limb;
+        }
+
+        r_limb = (r_limb ^ r_mask) + r_carry;
+        r_carry = (r_carry && r_limb == 0);
+        r[i] = r_limb;
+    }
+    return r_negative;
+}
+
+//
+//  Load Scalar (internal utility)
+//
+//  Reads a native integer of plus_size bytes through a void pointer
+//  and splits it into a magnitude and a sign.  Returns true when the
+//  value is negative.  Reading it as its real type means we don't
+//  care which end of the value the bytes are stored at.
+static bool bbi_load_scalar(const void *value, unsigned long size, 
+                            bool is_signed, BBI_BASE_TYPE *magnitude)
+{
+    D_LONG signed_val;
+    BBI_BASE_TYPE unsigned_val;
+
+    switch (size) {
+        case 1:
+            signed_val = *(const signed char *)value;
+            unsigned_val = *(const unsigned char *)value;
+            break;
+        case 2:
+            signed_val = *(const int16_t *)value;
+            unsigned_val = *(const uint16_t *)value;
+            break;
+        case 4:
+            signed_val = *(const int32_t *)value;
+            unsigned_val = *(const uint32_t *)value;
+            break;
+        default:
+            signed_val = *(const int64_t *)value;
+            unsigned_val = *(const uint64_t *)value;
+            break;
+    }
+
+    if (is_signed && signed_val < 0) {
+        *magnitude = 0 - (BBI_BASE_TYPE)signed_val;
+        return true;
+    }
+    *magnitude = unsigned_val;
+    return false;
+}
+
+
+/*******************************************
+ *          EXPRESSION EVALUATION          *
+ *******************************************/
+//
+//  These are the in-place building blocks the expression templates
+//  (BigBigIntExpr.h) are evaluated with.  None of them create a
+//  temporary bigbigint.
+//
+
+//
+//  Size (internal utility):  number of limbs in use
+unsigned long bigbigint::_size() const
+{
+    return bbi_normalize(this->_limbs, this->_length);
+}
+
+//
+//  *this += val  (or -= val when negate is set)
+//
+//  See bbi_add_signed for the sign rules.
+void bigbigint::_add_signed(const bigbigint &val, bool negate)
+{
+    unsigned long this_size, val_size, num_limbs;
+    bool negative;
+
+    this_size = this->_size();
+    val_size = val._size();
+    BBI_STAT_OP(BBI_STAT_ADD, this_size + val_size);
+    if (val_size == 0) return;
+
+    // Note: val may be *this, so only look at its limbs after
+    // we've (possibly) grown.
+    this->_reserve(MAX(this_size, val_size) + 1);
+    negative = bbi_add_signed(this->_limbs, 
+                    this->_limbs, this_size, (IS_NEGATIVE(this->_flags) != 0), 
+                    val._limbs, val_size, ((IS_NEGATIVE(val._flags) != 0) != negate), 
+                    &num_limbs);
+    this->_flags = (this->_flags & ~BBI_NEGATIVE) | (negative ? BBI_NEGATIVE : 0);
+}
+
+//
+//  *this = val1 + val2  (or val1 - val2 when negate is set)
+//
+//  One pass over the limbs; val1 isn't copied in first.
+//  val1 and val2 must not be *this.
+void bigbigint::_assign_sum(const bigbigint &val1, const bigbigint &val2, bool negate)
+{
+    unsigned long n1, n2, num_limbs;
+    bool negative;
+
+    n1 = val1._size();
+    n2 = val2._size();
+    BBI_STAT_OP(BBI_STAT_ADD, n1 + n2);
+
+    this->_presize(MAX(n1, n2) + 1);
+    negative = bbi_add_signed(this->_limbs, 
+                    val1._limbs, n1, (IS_NEGATIVE(val1._flags) != 0), 
+                    val2._limbs, n2, ((IS_NEGATIVE(val2._flags) != 0) != negate), 
+                    &num_limbs);
+    memset(this->_limbs + num_limbs, 0, 
+        (this->_length - num_limbs) * sizeof(BBI_BASE_TYPE));
+    this->_flags = (negative ? BBI_NEGATIVE : 0);
 }
 
+//
+//  *this += val1 * val2  (or -= when negate is set)
+//
+//  A fused multiply-add:  the product is never formed on its own.
+//  Each limb of val2 adds (or subtracts) one row straight into
+//  *this.  If a subtraction goes below zero, the limbs end up
+//  holding the two's complement of the answer, so we flip them
+//  back and change the sign.
+//
+//  Once the shorter operand is big enough for Karatsuba the rows
+//  would cost more than they save, so the product is formed on the
+//  scratch stack and added in with bbi_add_signed.
+//
+//  val1 and val2 must not be *this.
+void bigbigint::_add_product(const bigbigint &val1, const bigbigint &val2, bool negate)
+{
+    unsigned long this_size, n1, n2, num_limbs, j;
+    const bigbigint *p_long, *p_short;
+    BBI_BASE_TYPE carry, borrow, *product;
+    bool prod_negative;
+
+    n1 = val1._size();
+    n2 = val2._size();
+    BBI_STAT_OP(BBI_STAT_MUL, n1 + n2);
+    BBI_TRACE(BBI_STAT_MUL, n1 + n2);
+    if (n1 == 0 || n2 == 0) return;
+
+    // Run the rows along the longer operand
+    if (n1 >= n2) {
+        p_long = &val1;
+        p_short = &val2;
+    }
+    else {
+        p_long = &val2;
+        p_short = &val1;
+        j = n1; n1 = n2; n2 = j;
+    }
+
+    prod_negative = ((IS_NEGATIVE(val1._flags) != 0) != 
+                     (IS_NEGATIVE(val2._flags) != 0)) != negate;
+    this_size = this->_size();
+
+    if (n2 >= BBI_MUL_KARATSUBA_THRESHOLD) {
+        bbi_tmp_scope tmp;
+
+        product = tmp.alloc(n1 + n2);
+        bbi_mul(product, p_long->_limbs, n1, p_short->_limbs, n2);
+        num_limbs = MAX(this_size, n1 + n2) + 1;
+        this->_reserve(num_limbs);
+        if (bbi_add_signed(this->_limbs, 
+                           this->_limbs, this_size, IS_NEGATIVE(this->_flags) != 0, 
+                           product, bbi_normalize(product, n1 + n2), prod_negative, 
+                           &num_limbs)) {
+            this->_flags |= BBI_NEGATIVE;
+        }
+        else {
+            this->_flags &= ~BBI_NEGATIVE;
+        }
+        return;
+    }
+
+    if (this_size == 0 || prod_negative == (IS_NEGATIVE(this->_flags) != 0)) {
+        num_limbs = MAX(this_size, n1 + n2) + 1;
+        this->_reserve(num_limbs);
+
+        for (j = 0; j < n2; j++) {
+            carry = bbi_addmul_1(this->_limbs + j, p_long->_limbs, n1, p_short->_limbs[j]);
+            bbi_add_1(this->_limbs + j + n1, this->_limbs + j + n1, 
+                      num_limbs - j - n1, carry);
+        }
+        this->_flags = (this->_flags & ~BBI_NEGATIVE) | 
+                       (prod_negative ? BBI_NEGATIVE : 0);
+        return;
+    }
+
+    num_limbs = MAX(this_size, n1 + n2);
+    this->_reserve(num_limbs);
+
+    borrow = 0;
+    for (j = 0; j < n2; j++) {
+        carry = bbi_submul_1(this->_limbs + j, p_long->_limbs, n1, p_short->_limbs[j]);
+        borrow |= bbi_sub_1(this->_limbs + j + n1, this->_limbs + j + n1, 
+                            num_limbs - j - n1, carry);
+    }
+
+    if (borrow) {
+        bbi_neg(this->_limbs, this->_limbs, num_limbs);
+        this->_flags ^= BBI_NEGATIVE;
+    }
+    if (this->_size() == 0) {
+        this->_flags &= ~BBI_NEGATIVE;
+    }
+}
+
+//
+//  *this = val1 * val2
+//
+//  val1 and val2 must not be *this.  (Views can share limbs without
+//  being the same number, so squaring checks the sizes too.)
+void bigbigint::_assign_product(const bigbigint &val1, const bigbigint &val2)
+{
+    unsigned long n1, n2;
+
+    n1 = val1._size();
+    n2 = val2._size();
+    BBI_STAT_OP(BBI_STAT_MUL, n1 + n2);
+    BBI_TRACE(BBI_STAT_MUL, n1 + n2);
+
+    this->_presize(n1 + n2);
+    this->zero_fill();
+    this->_flags = 0;
+
+    if (n1 == 0 || n2 == 0) return;
+
+    if (val1._limbs == val2._limbs && n1 == n2) {
+        bbi_sqr(this->_limbs, val1._limbs, n1);
+    }
+    else if (n1 >= n2) {
+        bbi_mul(this->_limbs, val1._limbs, n1, val2._limbs, n2);
+    }
+    else {
+        bbi_mul(this->_limbs, val2._limbs, n2, val1._limbs, n1);
+    }
+
+    if ((IS_NEGATIVE(val1._flags) != 0) != (IS_NEGATIVE(val2._flags) != 0)) {
+        this->_flags |= BBI_NEGATIVE;
+    }
+}
+
+
+/*******************************************
+ *           IN-PLACE OPERATIONS           *
+ *******************************************/
+//
+//  The compound operators (+=, -=, *=, <<=, >>=, |=) are built on
+//  these.  They change *this directly instead of building a new
+//  bigbigint and copying it back.
+//
+
+//
+//  *this += <native value>  (or -= when negate is set)
+//
+//  The value fits in a single limb, so the carry (or borrow) only
+//  runs as far as it has to; most of the time that's one limb.
+void bigbigint::_add_scalar(const void *value, unsigned long size, 
+                            bool is_signed, bool negate)
+{
+    BBI_BASE_TYPE magnitude;
+    unsigned long this_size, num_limbs;
+    bool val_negative, negative;
+
+    val_negative = (bbi_load_scalar(value, size, is_signed, &magnitude) != negate);
+    if (magnitude == 0) return;
+
+    this_size = this->_size();
+    BBI_STAT_OP(BBI_STAT_ADD, this_size + 1);
+    this->_reserve(this_size + 1);
+    negative = bbi_add_signed(this->_limbs, 
+                    this->_limbs, this_size, (IS_NEGATIVE(this->_flags) != 0), 
+                    &magnitude, 1, val_negative, &num_limbs);
+    this->_flags = (this->_flags & ~BBI_NEGATIVE) | (negative ? BBI_NEGATIVE : 0);
+}
+
+//
+//  *this += 1  (or -= 1 when down is set)
+//
+//  Only the limbs the carry (or borrow) actually reaches are
+//  touched, so this is O(1) on average.  No _size() scan either.
+void bigbigint::_step(bool down)
+{
+    unsigned long i;
+
+    BBI_STAT_OP(BBI_STAT_ADD, 1);
+    this->_writable();
+
+    // Going up on a positive number (or down on a negative one)
+    // grows the magnitude
+    if ((IS_NEGATIVE(this->_flags) != 0) == down) {
+        for (i = 0; i < this->_length; i++) {
+            if (++this->_limbs[i] != 0) return;
+        }
+        // Carried out of the top limb
+        this->_upsize(this->_length + 1);
+        this->_limbs[i] = 1;
+        return;
+    }
+
+    // Otherwise it shrinks.  Find the first non-zero limb; everything
+    // below it borrows (and turns into all ones).
+    for (i = 0; i < this->_length; i++) {
+        if (this->_limbs[i]-- != 0) break;
+    }
+
+    if (i == this->_length) {
+        // We were zero (only reachable going down):  0 - 1 = -1
+        this->zero_fill();
+        this->_limbs[0] = 1;
+        this->_flags |= BBI_NEGATIVE;
+        return;
+    }
+
+    // -1 + 1 lands on zero, which is never negative
+    if (i == 0 && this->_limbs[0] == 0) {
+        for (i = 1; i < this->_length && this->_limbs[i] == 0; i++);
+        if (i == this->_length) {
+            this->_flags &= ~BBI_NEGATIVE;
+        }
+    }
+}
+
+//
+//  *this *= <native value>
+void bigbigint::_mul_scalar(const void *value, unsigned long size, bool is_signed)
+{
+    BBI_BASE_TYPE magnitude;
+    unsigned long this_size;
+
+    if (bbi_load_scalar(value, size, is_signed, &magnitude)) {
+        this->_flags ^= BBI_NEGATIVE;
+    }
+
+    this_size = this->_size();
+    BBI_STAT_OP(BBI_STAT_MUL_SCALAR, this_size);
+    if (magnitude == 0 || this_size == 0) {
+        this->zero_fill();
+        this->_flags = 0;
+        return;
+    }
+
+    this->_reserve(this_size + 1);
+    this->_limbs[this_size] = bbi_mul_1(this->_limbs, this->_limbs, 
+                                        this_size, magnitude);
+}
+
+//
+//  *this /= <native value>  (truncates toward zero, like C)
+void bigbigint::_div_scalar(const void *value, unsigned long size, bool is_signed)
+{
+    BBI_BASE_TYPE magnitude;
+
+    if (bbi_load_scalar(value, size, is_signed, &magnitude)) {
+        this->_flags ^= BBI_NEGATIVE;
+    }
+    if (magnitude == 0) {
+        exit(199);  // @RLA - Same as _perform_integral_division
+    }
+    BBI_STAT_OP(BBI_STAT_DIV_SCALAR, this->_size());
+
+    this->_writable();
+    bbi_divrem_1(this->_limbs, this->_limbs, this->_size(), magnitude);
+    if (this->_size() == 0) {
+        this->_flags = 0;
+    }
+}
+
+//
+//  *this % <native value>, as a magnitude.  The remainder takes
+//  the sign of *this (like C).
+BBI_BASE_TYPE bigbigint::_mod_scalar(const void *value, unsigned long size, bool is_signed) const
+{
+    BBI_BASE_TYPE magnitude;
+
+    bbi_load_scalar(value, size, is_signed, &magnitude);
+    if (magnitude == 0) {
+        exit(199);
+    }
+    BBI_STAT_OP(BBI_STAT_DIV_SCALAR, this->_size());
+    return bbi_mod_1(this->_limbs, this->_size(), magnitude);
+}
+
+//
+//  *this *= val
+//
+//  A product can't be built on top of its own operand, so it goes
+//  into a per-thread scratch number which then trades buffers with
+//  *this.  Our old buffer becomes the next scratch, so a loop of *=
+//  stops allocating once the buffers are big enough.
+void bigbigint::_mul_signed(const bigbigint &val)
+{
+    static thread_local bigbigint scratch;
+
+    scratch._assign_product(*this, val);
+    this->_swap(scratch);
+}
+
+//
+//  *this <<= Shift
+//
+//  Never loses bits:  the buffer grows if the result needs it.
+//  Otherwise the whole limbs move and the bits shift in one pass
+//  over the buffer we already have, so a big shift costs about as
+//  much as a memmove.
+void bigbigint::_shift_left(unsigned long Shift)
+{
+    unsigned long offset, this_size;
+    unsigned int shift_value;
+
+    this_size = this->_size();
+    BBI_STAT_OP(BBI_STAT_SHIFT, this_size);
+    if (this_size == 0) return;
+
+    //Load based on the offset (whole limbs) and shift_value (bits)
+    offset = Shift / BBI_BASE_BITS;
+    shift_value = Shift % BBI_BASE_BITS;
+
+    this->_reserve(this_size + offset + 1);
+    if (shift_value == 0) {
+        memmove(this->_limbs + offset, this->_limbs, 
+                this_size * sizeof(BBI_BASE_TYPE));
+    }
+    else {
+        this->_limbs[this_size + offset] = bbi_lshift(this->_limbs + offset, 
+                this->_limbs, this_size, shift_value);
+    }
+    memset(this->_limbs, 0, offset * sizeof(BBI_BASE_TYPE));
+}
+
+//
+//  *this >>= Shift
+//
+//  A negative number rounds down (-5 >> 1 == -3), as it would in 
+//  two's complement, so >> agrees with &, | and ^ below.  The shift
+//  works on the magnitude, so for a negative value that lost any set
+//  bits off the bottom the magnitude goes up by one.
+void bigbigint::_shift_right(unsigned long Shift)
+{
+    unsigned long offset, this_size, num_limbs, i;
+    unsigned int shift_value;
+    BBI_BASE_TYPE lost;
+
+    this_size = this->_size();
+    BBI_STAT_OP(BBI_STAT_SHIFT, this_size);
+    this->_writable();
+    offset = Shift / BBI_BASE_BITS;
+    shift_value = Shift % BBI_BASE_BITS;
+
+    // Everything got shifted off the bottom:  0, or -1 if negative
+    if (offset >= this_size) {
+        memset(this->_limbs, 0, this_size * sizeof(BBI_BASE_TYPE));
+        if (IS_NEGATIVE(this->_flags)) {
+            this->_limbs[0] = 1;
+        }
+        return;
+    }
+
+    // Only a negative value cares what was shifted out
+    lost = 0;
+    if (IS_NEGATIVE(this->_flags)) {
+        for (i = 0; i < offset; i++) {
+            lost |= this->_limbs[i];
+        }
+    }
+
+    num_limbs = this_size - offset;
+    if (shift_value == 0) {
+        memmove(this->_limbs, this->_limbs + offset, 
+                num_limbs * sizeof(BBI_BASE_TYPE));
+    }
+    else {
+        lost |= bbi_rshift(this->_limbs, this->_limbs + offset, num_limbs, shift_value);
+    }
+    memset(this->_limbs + num_limbs, 0, offset * sizeof(BBI_BASE_TYPE));
+
+    // A carry out of the top only happens when whole limbs were shifted
+    // out (so offset > 0 and the limb above num_limbs is ours)
+    if (IS_NEGATIVE(this->_flags) && lost != 0) {
+        if (bbi_add_1(this->_limbs, this->_limbs, num_limbs, 1) != 0) {
+            this->_limbs[num_limbs] = 1;
+        }
+    }
+
+    if (this->_size() == 0) {
+        this->_flags = 0;
+    }
+}
+
+//
+//  *this = *this op val  (op is '&', '|' or '^')
+//
+//  Negative values behave as two's complement (the same as the
+//  native signed types, and as Python or GMP do for big values):
+//  -1 & x == x, x | -1 == -1, x ^ -1 == ~x.  When both sides are 
+//  non-negative, which is the common case, this is one vectorized
+//  word-wise pass over the limbs.
+//
+//  val must not be our own limbs (we may reallocate them).
+void bigbigint::_bitwise(const BBI_BASE_TYPE *val, unsigned long val_size, 
+                         bool val_negative, char op)
+{
+    unsigned long this_size, num_limbs;
+    bool this_negative;
+
+    this_size = this->_size();
+    this_negative = IS_NEGATIVE(this->_flags);
+    BBI_STAT_OP(BBI_STAT_BITWISE, this_size + val_size);
+    this->_writable();
+
+    if (!this_negative && !val_negative) {
+        if (op == '&') {
+            num_limbs = MIN(this_size, val_size);
+            bbi_and_n(this->_limbs, this->_limbs, val, num_limbs);
+            memset(this->_limbs + num_limbs, 0, 
+                   (this_size - num_limbs) * sizeof(BBI_BASE_TYPE));
+            return;
+        }
+
+        this->_reserve(val_size);
+        num_limbs = MIN(this_size, val_size);
+        if (op == '|') {
+            bbi_ior_n(this->_limbs, this->_limbs, val, num_limbs);
+        }
+        else {
+            bbi_xor_n(this->_limbs, this->_limbs, val, num_limbs);
+        }
+        if (val_size > this_size) {
+            memcpy(this->_limbs + this_size, val + this_size, 
+                   (val_size - this_size) * sizeof(BBI_BASE_TYPE));
+        }
+        return;
+    }
+
+    num_limbs = MAX(this_size, val_size) + 1;
+    this->_reserve(num_limbs);
+    if (bbi_logic_signed(this->_limbs, num_limbs, op, 
+                         this->_limbs, this_size, this_negative, 
+                         val, val_size, val_negative)) {
+        this->_flags |= BBI_NEGATIVE;
+    }
+    else {
+        this->_flags &= ~BBI_NEGATIVE;
+    }
+}
+
+//
+//  *this op= val for a bigbigint (op is '&', '|' or '^')
+void bigbigint::_bitwise(const bigbigint &val, char op)
+{
+    // x & x == x | x == x, x ^ x == 0
+    if (&val == this) {
+        if (op == '^') {
+            this->zero_fill();
+            this->_flags = 0;
+        }
+        return;
+    }
+    this->_bitwise(val._limbs, val._size(), IS_NEGATIVE(val._flags), op);
+}
+
+//
+//  *this op= <native value>
+void bigbigint::_bitwise_scalar(const void *value, unsigned long size, 
+                                bool is_signed, char op)
+{
+    BBI_BASE_TYPE magnitude;
+    bool negative;
+
+    negative = bbi_load_scalar(value, size, is_signed, &magnitude);
+    this->_bitwise(&magnitude, (magnitude != 0 ? 1 : 0), negative, op);
+}
+
+
+/*******************************************
+ *           EXTERNAL FUNCTIONS            *
+ *******************************************/
+
+//
+// Length function
+//
+long bigbigint::length()
+{
+    return this->_length;
+}
+
+//
+// Bit queries
+//
+//  bit_length, popcount and count_trailing_zeros look at the 
+//  magnitude (count_trailing_zeros is the same either way).  The
+//  single bit functions treat a negative value as two's complement,
+//  the same as &, | and ^ do.
+//
+
+//  (The work is done by bigbigint_view, see below)
+unsigned long bigbigint::bit_length() const
+{
+    return bigbigint_view(*this).bit_length();
+}
+
+unsigned long bigbigint::popcount() const
+{
+    return bigbigint_view(*this).popcount();
+}
+
+unsigned long bigbigint::count_trailing_zeros() const
+{
+    return bigbigint_view(*this).count_trailing_zeros();
+}
+
+bool bigbigint::test_bit(unsigned long bit) const
+{
+    return bigbigint_view(*this).test_bit(bit);
+}
+
+void bigbigint::set_bit(unsigned long bit)
+{
+    if (!this->test_bit(bit)) {
+        this->flip_bit(bit);
+    }
+}
+
+void bigbigint::clear_bit(unsigned long bit)
+{
+    if (this->test_bit(bit)) {
+        this->flip_bit(bit);
+    }
+}
+
+//
+//  Flipping a bit adds or subtracts 2^bit.  Once the sign is taken
+//  into account the magnitude shrinks exactly when the (two's 
+//  complement) bit differs from the sign, and in that case the 
+//  magnitude is always at least 2^bit, so the sign never changes.
+void bigbigint::flip_bit(unsigned long bit)
+{
+    unsigned long offset, num_limbs;
+    BBI_BASE_TYPE mask;
+
+    offset = bit / BBI_BASE_BITS;
+    mask = (BBI_BASE_TYPE)1 << (bit % BBI_BASE_BITS);
+
+    if (this->test_bit(bit) != IS_NEGATIVE(this->_flags)) {
+        this->_writable();
+        num_limbs = this->_size();
+        bbi_sub_1(this->_limbs + offset, this->_limbs + offset, 
+                  num_limbs - offset, mask);
+        if (this->_size() == 0) {
+            this->_flags = 0;
+        }
+        return;
+    }
+
+    num_limbs = MAX(this->_size(), offset + 1);
+    this->_reserve(num_limbs + 1);
+    this->_limbs[num_limbs] = bbi_add_1(this->_limbs + offset, 
+            this->_limbs + offset, num_limbs - offset, mask);
+}
+
+//
+// Modular exponentiation
+//
+//  Left to right, four exponent bits at a time:  base^0 .. base^15 
+//  are made up front, then each window is four squarings and (unless
+//  the window is zero) one multiply, every product reduced with the 
+//  long division straight away.  That's about a fifth fewer multiplies
+//  than going a bit at a time.
+//
+#define BBI_POWMOD_WINDOW   4
+
+//
+//  (*this ^ exponent) mod modulus, from 0 to |modulus| - 1 whatever 
+//  the signs.  A negative exponent gives 0 (there's no integer 
+//  answer), and a zero modulus exits the same as dividing by zero.
+bigbigint bigbigint::powmod(const bigbigint &exponent, const bigbigint &modulus) const
+{
+    bigbigint powers[1 << BBI_POWMOD_WINDOW], tModulus(modulus), tVal, product, quotient;
+    unsigned long num_windows, window, digit, i;
+
+    BBI_STAT_OP(BBI_STAT_POWMOD, this->_size() + exponent._size() + modulus._size());
+    BBI_TRACE(BBI_STAT_POWMOD, this->_size() + exponent._size() + modulus._size());
+    tModulus._flags = 0;
+    if (IS_NEGATIVE(exponent._flags)) {
+        return tVal;
+    }
+
+    // base^0 and base^1, both reduced (and made positive)
+    powers[0] = 1;
+    _perform_integral_division(powers[0], tModulus, &quotient, &tVal);
+    powers[0] = tVal;
+    _perform_integral_division(*this, tModulus, &quotient, &powers[1]);
+    if (IS_NEGATIVE(powers[1]._flags)) {
+        powers[1] += tModulus;
+    }
+    for (i = 2; i < (1 << BBI_POWMOD_WINDOW); i++) {
+        product = powers[i - 1] * powers[1];
+        _perform_integral_division(product, tModulus, &quotient, &powers[i]);
+    }
+
+    bigbigint_view exp_view(exponent);
+    num_windows = (exp_view.bit_length() + BBI_POWMOD_WINDOW - 1) / BBI_POWMOD_WINDOW;
+    tVal = powers[0];
+    for (window = num_windows; window > 0; window--) {
+        digit = 0;
+        for (i = BBI_POWMOD_WINDOW; i > 0; i--) {
+            digit = (digit << 1) | exp_view.test_bit(((window - 1) * BBI_POWMOD_WINDOW) + i - 1);
+        }
+
+        // The first window just picks its power
+        if (window == num_windows) {
+            tVal = powers[digit];
+            continue;
+        }
+        for (i = 0; i < BBI_POWMOD_WINDOW; i++) {
+            product = tVal * tVal;
+            _perform_integral_division(product, tModulus, &quotient, &tVal);
+        }
+        if (digit != 0) {
+            product = tVal * powers[digit];
+            _perform_integral_division(product, tModulus, &quotient, &tVal);
+        }
+    }
+    return tVal;
+}
+
+//
+// Copy function
+//
+
+bigbigint * bigbigint::copy(bigbigint *copy)
+{
+    // Setup internal vars
+    this->_length = copy->_length;
+    this->_num_bytes = copy->_num_bytes;
+    this->_flags = copy->_flags;
+
+    // Malloc size.
+    this->_malloc(this->_num_bytes);
+
+    memcpy(this->_limbs, copy->_limbs, copy->_num_bytes);
+    BBI_STAT_COPY(copy->_num_bytes);
+    return this;
+}
+
+//
+// String conversion
+//
+//  Small numbers go straight to bbi_get_str (one limb division per 
+//  19 decimal digits, or plain bit picking for power of two bases).
+//  That's quadratic, so bigger numbers are split first:  divide by 
+//  the power of the big base that gives the quotient and remainder 
+//  about half the digits each, and convert both halves the same way,
+//  the remainder padded with zeros to exactly its share.  
+//
+//  The divisions are Barrett reductions (two multiplications against a
+//  precomputed reciprocal), so with Karatsuba and the FFT underneath 
+//  the whole conversion is subquadratic:  about 17 products of the 
+//  full size for to_string, 5 for parsing.  The powers and their reciprocals are 
+//  cached per thread for the last base used, so printing a run of 
+//  same sized numbers only pays for them once.
+//
+//  Parsing runs the same split the other way:  convert the top and
+//  bottom halves of the digits and put them back together with one
+//  multiplication by the power.  Power of two bases are packed 
+//  straight into the limbs in one pass.
+//
+//  The thresholds are measured by BigBigIntTune along with the 
+//  multiplication ones (see BigBigIntMpn.h).
+//
+#ifndef BBI_GET_STR_DC_THRESHOLD
+    #define BBI_GET_STR_DC_THRESHOLD    24  // limbs
+#endif
+#ifndef BBI_SET_STR_DC_THRESHOLD
+    #define BBI_SET_STR_DC_THRESHOLD    24  // limbs
+#endif
+#if BBI_GET_STR_DC_THRESHOLD < 2 || BBI_SET_STR_DC_THRESHOLD < 2
+    #error The string conversion thresholds must be at least 2
+#endif
+#if defined(BBI_TUNE_PROGRAM)
+    #undef BBI_GET_STR_DC_THRESHOLD
+    #undef BBI_SET_STR_DC_THRESHOLD
+    #define BBI_GET_STR_DC_THRESHOLD    bbi_tune.get_str_dc
+    #define BBI_SET_STR_DC_THRESHOLD    bbi_tune.set_str_dc
+    #define BBI_GET_STR_BUFFER          (BBI_TUNE_GET_STR_LIMIT * BBI_BASE_BITS)
+#else
+    #define BBI_GET_STR_BUFFER          (BBI_GET_STR_DC_THRESHOLD * BBI_BASE_BITS)
+#endif
+#define BBI_RECIPROCAL_THRESHOLD    (16 * BBI_BASE_BITS)    // bits
+#define BBI_MAX_POWERS              128
+
+//  floor(2^(2 * bits) / m), where m has exactly that many bits.
+//
+//  Newton's method:  get the reciprocal of the top half of m (plus
+//  some guard bits), which is good to about half the bits we need, 
+//  then one step of x += x * (2^(2 * bits) - m * x) / 2^(2 * bits) 
+//  squares the error.  The last few units are fixed up against the 
+//  remainder.
+static bigbigint bbi_reciprocal(const bigbigint &m, unsigned long bits)
+{
+    bigbigint x, top, one, e, t;
+    unsigned long half, shift;
+
+    one = 1;
+    one <<= 2 * bits;
+    if (bits <= BBI_RECIPROCAL_THRESHOLD) {
+        x = one / m;
+        return x;
+    }
+
+    half = (bits / 2) + 32;
+    shift = bits - half;
+    top = m;
+    top >>= shift;
+    x = bbi_reciprocal(top, half);
+
+    // The starting point is x << shift, so the products below are 
+    // taken with the short x and shifted afterwards.  Only the top 
+    // half of the error e affects the correction (dropping the rest 
+    // changes t by less than 1/8), and t is only about half length, 
+    // so the new error comes from e - m * t rather than another full
+    // product.
+    t = m * x;
+    t <<= shift;
+    e = one - t;
+    t = e;
+    t >>= bits - 4;
+    t = x * t;
+    t >>= half + 4;
+    x <<= shift;
+    x += t;
+    e -= m * t;
+
+    while (e < 0) {
+        x -= 1;
+        e += m;
+    }
+    while (e >= m) {
+        x += 1;
+        e -= m;
+    }
+    return x;
+}
+
+//  One cached power of the big base, big_base^exponent
+struct bbi_str_power
+{
+    unsigned long exponent;
+    bigbigint power;
+    bigbigint reciprocal;       // bbi_reciprocal(power, bits)
+    unsigned long bits;         // power.bit_length(), 0 until the 
+                                // reciprocal has been made
+};
+
+struct bbi_str_cache
+{
+    int base;
+    int num_powers;
+    BBI_BASE_TYPE big_base;
+    unsigned long digits;       // digits in the big base
+    bbi_str_power powers[BBI_MAX_POWERS];
+};
+
+static thread_local bbi_str_cache bbi_str_powers;
+
+//  Gets the cache ready for a conversion in the given base
+static bbi_str_cache &bbi_str_cache_for(int base)
+{
+    bbi_str_cache &cache = bbi_str_powers;
+    BBI_BASE_TYPE big_base;
+    unsigned long digits;
+
+    if (cache.base != base) {
+        big_base = (BBI_BASE_TYPE)base;
+        digits = 1;
+        while (big_base <= BBI_BASE_MAX / (BBI_BASE_TYPE)base) {
+            big_base *= (BBI_BASE_TYPE)base;
+            digits++;
+        }
+        cache.base = base;
+        cache.num_powers = 0;
+        cache.big_base = big_base;
+        cache.digits = digits;
+    }
+    return cache;
+}
+
+//  big_base^exponent, from the cache or built by squaring the power 
+//  for exponent / 2
+static bbi_str_power &bbi_str_power_for(bbi_str_cache &cache, unsigned long exponent)
+{
+    bbi_str_power *entry;
+    int i;
+
+    for (i = 0; i < cache.num_powers; i++) {
+        if (cache.powers[i].exponent == exponent) {
+            return cache.powers[i];
+        }
+    }
+
+    // Full:  start over (nothing holds on to an entry while we build)
+    if (cache.num_powers == BBI_MAX_POWERS) {
+        cache.num_powers = 0;
+    }
+
+    if (exponent == 1) {
+        entry = &cache.powers[cache.num_powers];
+        entry->power = (unsigned long)cache.big_base;
+    }
+    else {
+        const bbi_str_power &half = bbi_str_power_for(cache, exponent / 2);
+        entry = &cache.powers[cache.num_powers];
+        entry->power = half.power * half.power;
+        if (exponent & 1) {
+            entry->power *= (unsigned long)cache.big_base;
+        }
+    }
+    entry->exponent = exponent;
+    entry->bits = 0;
+    cache.num_powers++;
+    return *entry;
+}
+
+//
+//  Splits the magnitude for a num_digits digit conversion:  quotient 
+//  and remainder by big_base^(chunks / 2, rounded up), with the number
+//  of digits the remainder stands for in low_digits.  The magnitude 
+//  is below base^num_digits <= power^2 < 2^(2 * bits), which is what 
+//  the Barrett step needs.
+void bigbigint::_split_digits(unsigned long num_digits, bigbigint &quotient, 
+                              bigbigint &remainder, unsigned long &low_digits) const
+{
+    unsigned long chunks;
+
+    bbi_str_cache &cache = bbi_str_powers;
+    chunks = (num_digits + cache.digits - 1) / cache.digits;
+    bbi_str_power &power = bbi_str_power_for(cache, (chunks + 1) / 2);
+    low_digits = power.exponent * cache.digits;
+    if (power.bits == 0) {
+        power.bits = power.power.bit_length();
+        power.reciprocal = bbi_reciprocal(power.power, power.bits);
+    }
+
+    remainder = *this;
+    remainder._flags = 0;
+    quotient = remainder;
+    quotient >>= (power.bits - 1);
+    quotient = quotient * power.reciprocal;
+    quotient >>= (power.bits + 1);
+    remainder -= quotient * power.power;
+    while (remainder >= power.power) {
+        remainder -= power.power;
+        quotient += 1;
+    }
+}
+
+//
+//  Writes the digits of the value's magnitude to out, using no more 
+//  than space characters.  With pad it writes exactly num_digits, zero
+//  padded on the left (the magnitude must be below base^num_digits).
+//  Without it num_digits is only an upper bound and the digits start
+//  at out with no leading zeros.  Returns the number written, or 0 if
+//  they don't fit.
+unsigned long bigbigint::_write_digits(char *out, unsigned long num_digits, 
+                                       unsigned long space, int base, bool pad) const
+{
+    char buffer[BBI_GET_STR_BUFFER];
+    unsigned long this_size, count, low_digits;
+    bigbigint quotient, remainder;
+
+    this_size = this->_size();
+    if (this_size < BBI_GET_STR_DC_THRESHOLD) {
+        count = bbi_get_str(buffer, base, this->_limbs, this_size);
+        if (!pad) {
+            num_digits = count;
+        }
+        if (num_digits > space) {
+            return 0;
+        }
+        memset(out, '0', num_digits - count);
+        memcpy(out + num_digits - count, buffer, count);
+        return num_digits;
+    }
+
+    this->_split_digits(num_digits, quotient, remainder, low_digits);
+    if (low_digits > space) {
+        return 0;
+    }
+    if (!pad && quotient._size() == 0) {
+        return remainder._write_digits(out, low_digits, space, base, false);
+    }
+    count = quotient._write_digits(out, num_digits - low_digits, 
+                                   space - low_digits, base, pad);
+    if (count == 0) {
+        return 0;
+    }
+    remainder._write_digits(out + count, low_digits, low_digits, base, true);
+    return count + low_digits;
+}
+
+//
+//  Same as _write_digits, but the digits go to a sink as each piece is
+//  converted.  Returns false if the sink does.
+bool bigbigint::_emit_digits(bbi_digit_sink &sink, unsigned long num_digits, int base, bool pad) const
+{
+    char buffer[BBI_GET_STR_BUFFER];
+    unsigned long this_size, count, zeros, piece, low_digits;
+    bigbigint quotient, remainder;
+
+    this_size = this->_size();
+    if (this_size < BBI_GET_STR_DC_THRESHOLD) {
+        count = bbi_get_str(buffer, base, this->_limbs, this_size);
+        if (pad && num_digits > count) {
+            // A long run of zeros (a remainder that came out small)
+            // goes out a buffer at a time
+            char padding[BBI_GET_STR_BUFFER];
+
+            memset(padding, '0', sizeof(padding));
+            for (zeros = num_digits - count; zeros > 0; zeros -= piece) {
+                piece = MIN(zeros, (unsigned long)sizeof(padding));
+                if (!sink.put(padding, piece)) {
+                    return false;
+                }
+            }
+        }
+        return sink.put(buffer, count);
+    }
+
+    this->_split_digits(num_digits, quotient, remainder, low_digits);
+    if (!pad && quotient._size() == 0) {
+        return remainder._emit_digits(sink, low_digits, base, false);
+    }
+    if (!quotient._emit_digits(sink, num_digits - low_digits, base, pad)) {
+        return false;
+    }
+
+    // The quotient's been written, so let it go before the remainder
+    // is converted
+    quotient._free();
+    quotient._constructor(0);
+    return remainder._emit_digits(sink, low_digits, base, true);
+}
+
+//
+//  The value in the given base (2 - 36), with a leading '-' if it's
+//  negative.  Digits past 9 are lower case letters.  Returns an empty
+//  string for a base outside 2 - 36.
+std::string bigbigint::to_string(int base) const
+{
+    std::string str;
+    bbi_to_chars_result result;
+
+    if (base < 2 || base > 36) {
+        return str;
+    }
+
+    str.resize(this->digits_upper_bound(base));
+    result = to_chars(&str[0], &str[0] + str.size(), *this, base);
+    str.resize(result.ptr - &str[0]);
+    return str;
+}
+
+//
+//  Characters to_chars() can need for the value in the given base, 
+//  counting the '-' (either exact or one too many)
+unsigned long bigbigint::digits_upper_bound(int base) const
+{
+    unsigned long this_size;
+
+    this_size = this->_size();
+    return bbi_sizeinbase(this->_limbs, this_size, base) + (IS_NEGATIVE(this->_flags) ? 1 : 0);
+}
+
+//
+//  Writes the value to [first, last) in the given base (2 - 36), the 
+//  same as std::to_chars:  a '-' if it's negative, lower case letters,
+//  no terminator.  Returns the end of what was written, or last and 
+//  value_too_large if it doesn't fit.  Values below 
+//  BBI_GET_STR_DC_THRESHOLD limbs are converted without touching the
+//  heap.
+bbi_to_chars_result to_chars(char *first, char *last, const bigbigint &value, int base)
+{
+    bbi_to_chars_result result;
+    unsigned long this_size, num_digits, space, count;
+    char *out;
+
+    result.ptr = last;
+    result.ec = std::errc::value_too_large;
+    if (base < 2 || base > 36) {
+        result.ptr = first;
+        result.ec = std::errc::invalid_argument;
+        return result;
+    }
+
+    out = first;
+    if (IS_NEGATIVE(value._flags)) {
+        if (out == last) {
+            return result;
+        }
+        *out++ = '-';
+    }
+    space = (unsigned long)(last - out);
+
+    this_size = value._size();
+    BBI_STAT_OP(BBI_STAT_TO_TEXT, this_size);
+    BBI_TRACE(BBI_STAT_TO_TEXT, this_size);
+    num_digits = bbi_sizeinbase(value._limbs, this_size, base);
+    if ((base & (base - 1)) == 0) {
+        // Exact, and linear
+        if (num_digits > space) {
+            return result;
+        }
+        count = bbi_get_str(out, base, value._limbs, this_size);
+    }
+    else {
+        if (this_size >= BBI_GET_STR_DC_THRESHOLD) {
+            bbi_str_cache_for(base);
+        }
+        count = value._write_digits(out, num_digits, space, base, false);
+        if (count == 0) {
+            return result;
+        }
+    }
+
+    result.ptr = out + count;
+    result.ec = std::errc();
+    return result;
+}
+
+//  A view borrows its limbs into a bigbigint for the conversion
+bbi_to_chars_result to_chars(char *first, char *last, const bigbigint_view &value, int base)
+{
+    return to_chars(first, last, bigbigint(value, bigbigint::_BORROW), base);
+}
+
+//
+//  Writes the value as text (the same characters as to_string) to a 
+//  sink, a piece at a time as the conversion produces them, so the 
+//  whole string never exists at once.  The extra memory is about the
+//  size of the number itself (the halves waiting to be converted and
+//  the cached powers).  Returns false if the sink does, or the base 
+//  isn't 2 - 36.
+bool bigbigint::write_text(bbi_digit_sink &sink, int base) const
+{
+    char buffer[BBI_GET_STR_BUFFER];
+    unsigned long this_size, num_digits, count, i, index;
+    unsigned int log2_base, shift;
+    BBI_BASE_TYPE digit;
+
+    if (base < 2 || base > 36) {
+        return false;
+    }
+    if (IS_NEGATIVE(this->_flags) && !sink.put("-", 1)) {
+        return false;
+    }
+
+    this_size = this->_size();
+    BBI_STAT_OP(BBI_STAT_TO_TEXT, this_size);
+    BBI_TRACE(BBI_STAT_TO_TEXT, this_size);
+    num_digits = bbi_sizeinbase(this->_limbs, this_size, base);
+    if ((base & (base - 1)) != 0) {
+        if (this_size >= BBI_GET_STR_DC_THRESHOLD) {
+            bbi_str_cache_for(base);
+        }
+        return this->_emit_digits(sink, num_digits, base, false);
+    }
+
+    // A power of two base:  pick the digits out a buffer at a time, 
+    // from the top (num_digits is exact here)
+    log2_base = BBI_CTZ((BBI_BASE_TYPE)base);
+    count = 0;
+    for (i = num_digits; i > 0; i--) {
+        index = ((i - 1) * log2_base) / BBI_BASE_BITS;
+        shift = ((i - 1) * log2_base) % BBI_BASE_BITS;
+        digit = (this_size != 0 ? this->_limbs[index] >> shift : 0);
+        if (shift + log2_base > BBI_BASE_BITS && index + 1 < this_size) {
+            digit |= this->_limbs[index + 1] << (BBI_BASE_BITS - shift);
+        }
+        buffer[count++] = "0123456789abcdefghijklmnopqrstuvwxyz"[digit & (base - 1)];
+        if (count == sizeof(buffer)) {
+            if (!sink.put(buffer, count)) {
+                return false;
+            }
+            count = 0;
+        }
+    }
+    return (count == 0 || sink.put(buffer, count));
+}
+
+//
+//  write_text() to a file descriptor (see bbi_fd_sink)
+bool bigbigint::write_text(int fd, int base) const
+{
+    bbi_fd_sink sink(fd);
+
+    if (!this->write_text(sink, base)) {
+        return false;
+    }
+    return sink.flush();
+}
+
+//
+//  File descriptor sink
+//
+//  Pieces are gathered in a fixed buffer, so a conversion that hands 
+//  over many small pieces still makes few system calls and the memory
+//  used stays fixed.  A piece too big for the buffer isn't copied:  it
+//  goes out with whatever is buffered in a single writev().
+//
+bbi_fd_sink::bbi_fd_sink(int fd)
+{
+    this->_fd = fd;
+    this->_used = 0;
+    this->_failed = false;
+}
+
+bbi_fd_sink::~bbi_fd_sink()
+{
+    this->flush();
+}
+
+bool bbi_fd_sink::put(const char *digits, unsigned long length)
+{
+    if (this->_failed) {
+        return false;
+    }
+    if (this->_used + length <= sizeof(this->_buffer)) {
+        memcpy(this->_buffer + this->_used, digits, length);
+        this->_used += length;
+        return true;
+    }
+    if (length < sizeof(this->_buffer)) {
+        if (!this->flush()) {
+            return false;
+        }
+        memcpy(this->_buffer, digits, length);
+        this->_used = length;
+        return true;
+    }
+    return this->_put(digits, length);
+}
+
+bool bbi_fd_sink::flush()
+{
+    return this->_put(NULL, 0);
+}
+
+//
+//  Writes the buffer and then length bytes of data, retrying short 
+//  writes and EINTR
+bool bbi_fd_sink::_put(const char *data, unsigned long length)
+{
+    const char *piece[2];
+    unsigned long piece_length[2];
+    long written;
+    int first;
+
+    if (this->_failed) {
+        return false;
+    }
+
+    piece[0] = this->_buffer;
+    piece_length[0] = this->_used;
+    piece[1] = data;
+    piece_length[1] = length;
+    first = 0;
+    while (first < 2) {
+        if (piece_length[first] == 0) {
+            first++;
+            continue;
+        }
+#if defined(WIN32)
+        written = _write(this->_fd, piece[first], (unsigned int)MIN(piece_length[first], 0x40000000UL));
+#else
+        struct iovec iov[2];
+        int num_iov;
+
+        num_iov = 0;
+        iov[num_iov].iov_base = (void *)piece[first];
+        iov[num_iov].iov_len = piece_length[first];
+        num_iov++;
+        if (first == 0 && piece_length[1] != 0) {
+            iov[num_iov].iov_base = (void *)piece[1];
+            iov[num_iov].iov_len = piece_length[1];
+            num_iov++;
+        }
+        written = (long)writev(this->_fd, iov, num_iov);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            this->_failed = true;
+            return false;
+        }
+
+        // Step over what went out
+        while (written > 0 && first < 2) {
+            if ((unsigned long)written < piece_length[first]) {
+                piece[first] += written;
+                piece_length[first] -= (unsigned long)written;
+                written = 0;
+            }
+            else {
+                written -= (long)piece_length[first];
+                piece_length[first] = 0;
+                first++;
+            }
+        }
+    }
+    this->_used = 0;
+    return true;
+}
+
+//
+// Raw words
+//
+//  Thin wrappers on bbi_import / bbi_export, which do the byte and word
+//  reordering a limb (or four) at a time for the common layouts.
+//
+
+//  *this = the magnitude in the count words at data
+void bigbigint::import_words(unsigned long count, int order, unsigned long size, 
+                             int endian, const void *data)
+{
+    unsigned long num_limbs;
+
+    num_limbs = bbi_import_size(count, size);
+    this->_presize(num_limbs);
+    bbi_import(this->_limbs, count, order, size, endian, data);
+    memset(this->_limbs + num_limbs, 0, 
+        (this->_length - num_limbs) * sizeof(BBI_BASE_TYPE));
+    this->_flags = 0;
+}
+
+//  Words of size bytes export_words() will write (0 for zero)
+unsigned long bigbigint::export_count(unsigned long size) const
+{
+    return bbi_export_count(this->_limbs, this->_size(), size);
+}
+
+//  Writes the magnitude to data, and returns the word count
+unsigned long bigbigint::export_words(void *data, int order, unsigned long size, int endian) const
+{
+    unsigned long this_size, count;
+
+    this_size = this->_size();
+    count = bbi_export_count(this->_limbs, this_size, size);
+    bbi_export(data, count, order, size, endian, this->_limbs, this_size);
+    return count;
+}
+
+//
+// Binary format
+//
+//  A 64 byte header and then the limbs, least significant first, each
+//  one little endian.  Everything in the header is little endian too:
+//
+//      offset  size
+//          0      8    "BBIGINT" and a 0
+//          8      4    version (BBI_FILE_VERSION)
+//         12      4    flags (BBI_FILE_NEGATIVE)
+//         16      8    number of limbs
+//         24      8    offset of the limbs from the start, a multiple
+//                      of 64 (64 in version 1)
+//         32     32    reserved, 0
+//
+//  Readers take any version up to their own and skip to the limb 
+//  offset, so later versions can add to the header.  The limbs being 
+//  64 byte aligned in the file means a mapped file gives cache line 
+//  (and AVX-512) aligned limbs.
+//
+#define BBI_FILE_VERSION        1
+#define BBI_FILE_NEGATIVE       0x01
+#define BBI_FILE_HEADER_SIZE    64
+#define BBI_FILE_ALIGN          64
+#define BBI_FILE_PIECE          4096    // limbs, see load()
+
+static const char bbi_file_magic[8] = { 'B', 'B', 'I', 'G', 'I', 'N', 'T', 0 };
+
+//  Native <-> little endian
+static BBI_BASE_TYPE bbi_limb_le(BBI_BASE_TYPE limb)
+{
+#if defined(MEM_ARCH_USES_BIG_ENDIAN)
+    return BBI_BSWAP(limb);
+#else
+    return limb;
+#endif
+}
+
+static void bbi_put_le(unsigned char *out, uint64_t value, int num_bytes)
+{
+    int i;
+
+    for (i = 0; i < num_bytes; i++) {
+        out[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static uint64_t bbi_get_le(const unsigned char *in, int num_bytes)
+{
+    uint64_t value;
+    int i;
+
+    value = 0;
+    for (i = num_bytes - 1; i >= 0; i--) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+//  read()/write() the whole buffer, retrying short counts and EINTR
+static bool bbi_write_all(int fd, const void *data, unsigned long length)
+{
+    const char *p;
+    long done;
+
+    p = (const char *)data;
+    while (length > 0) {
+#if defined(WIN32)
+        done = _write(fd, p, (unsigned int)MIN(length, 0x40000000UL));
+#else
+        done = (long)write(fd, p, length);
+#endif
+        if (done < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            return false;
+        }
+        p += done;
+        length -= (unsigned long)done;
+    }
+    return true;
+}
+
+static bool bbi_read_all(int fd, void *data, unsigned long length)
+{
+    char *p;
+    long done;
+
+    p = (char *)data;
+    while (length > 0) {
+#if defined(WIN32)
+        done = _read(fd, p, (unsigned int)MIN(length, 0x40000000UL));
+#else
+        done = (long)read(fd, p, length);
+#endif
+        if (done < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            return false;
+        }
+        p += done;
+        length -= (unsigned long)done;
+    }
+    return true;
+}
+
+//  How many bytes are left to read from fd.  Only known (returns true)
+//  for a regular file.
+static bool bbi_bytes_left(int fd, uint64_t *left)
+{
+#if defined(WIN32)
+    struct _stat64 info;
+    __int64 position;
+
+    if (_fstat64(fd, &info) != 0 || (info.st_mode & _S_IFMT) != _S_IFREG) {
+        return false;
+    }
+    position = _lseeki64(fd, 0, SEEK_CUR);
+#else
+    struct stat info;
+    off_t position;
+
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        return false;
+    }
+    position = lseek(fd, 0, SEEK_CUR);
+#endif
+    if (position < 0) {
+        return false;
+    }
+    *left = (position < info.st_size ? (uint64_t)(info.st_size - position) : 0);
+    return true;
+}
+
+//  Checks a header, and pulls out what's in it
+static bool bbi_parse_header(const unsigned char *header, bool *negative, 
+                             uint64_t *num_limbs, uint64_t *limb_offset)
+{
+    if (memcmp(header, bbi_file_magic, sizeof(bbi_file_magic)) != 0 ||
+        bbi_get_le(header + 8, 4) > BBI_FILE_VERSION) {
+        return false;
+    }
+    *negative = ((bbi_get_le(header + 12, 4) & BBI_FILE_NEGATIVE) != 0);
+    *num_limbs = bbi_get_le(header + 16, 8);
+    *limb_offset = bbi_get_le(header + 24, 8);
+    return (*limb_offset >= BBI_FILE_HEADER_SIZE && 
+            *limb_offset % BBI_FILE_ALIGN == 0 &&
+            *num_limbs <= (ULONG_MAX - *limb_offset) / sizeof(BBI_BASE_TYPE));
+}
+
+//
+//  Writes the value to fd in the binary format.  Returns false if a 
+//  write fails.
+bool bigbigint::save(int fd) const
+{
+    unsigned char header[BBI_FILE_HEADER_SIZE];
+    unsigned long this_size;
+
+    this_size = this->_size();
+    memset(header, 0, sizeof(header));
+    memcpy(header, bbi_file_magic, sizeof(bbi_file_magic));
+    bbi_put_le(header + 8, BBI_FILE_VERSION, 4);
+    bbi_put_le(header + 12, (IS_NEGATIVE(this->_flags) ? BBI_FILE_NEGATIVE : 0), 4);
+    bbi_put_le(header + 16, this_size, 8);
+    bbi_put_le(header + 24, BBI_FILE_HEADER_SIZE, 8);
+    if (!bbi_write_all(fd, header, sizeof(header))) {
+        return false;
+    }
+
+#if defined(MEM_ARCH_USES_BIG_ENDIAN)
+    BBI_BASE_TYPE buffer[512];
+    unsigned long done, piece, i;
+
+    for (done = 0; done < this_size; done += piece) {
+        piece = MIN(this_size - done, (unsigned long)(sizeof(buffer) / sizeof(buffer[0])));
+        for (i = 0; i < piece; i++) {
+            buffer[i] = bbi_limb_le(this->_limbs[done + i]);
+        }
+        if (!bbi_write_all(fd, buffer, piece * sizeof(BBI_BASE_TYPE))) {
+            return false;
+        }
+    }
+    return true;
+#else
+    return bbi_write_all(fd, this->_limbs, this_size * sizeof(BBI_BASE_TYPE));
+#endif
+}
+
+//
+//  Reads a value that save() wrote from fd (which is left just past 
+//  it, so files can hold several).  Returns false, with the value 
+//  untouched, if the data isn't in the format or is cut short.
+//
+//  The header's limb count isn't trusted with memory:  a file has to
+//  have that many limbs left in it, and from anything else (a pipe, a
+//  socket) the limbs are read BBI_FILE_PIECE at a time and then in 
+//  doubling pieces, so the buffer never gets more than about twice 
+//  the size of what actually arrived.
+bool bigbigint::load(int fd)
+{
+    unsigned char header[BBI_FILE_HEADER_SIZE];
+    uint64_t num_limbs, limb_offset, skip, left, done, piece;
+    unsigned long i;
+    bigbigint tVal;
+    bool negative;
+
+    if (!bbi_read_all(fd, header, sizeof(header)) ||
+        !bbi_parse_header(header, &negative, &num_limbs, &limb_offset)) {
+        return false;
+    }
+    for (skip = limb_offset - sizeof(header); skip > 0; skip -= MIN(skip, (uint64_t)sizeof(header))) {
+        if (!bbi_read_all(fd, header, (unsigned long)MIN(skip, (uint64_t)sizeof(header)))) {
+            return false;
+        }
+    }
+
+    if (bbi_bytes_left(fd, &left)) {
+        if (left / sizeof(BBI_BASE_TYPE) < num_limbs) {
+            return false;
+        }
+        piece = num_limbs;
+    }
+    else {
+        piece = MIN(num_limbs, (uint64_t)BBI_FILE_PIECE);
+    }
+
+    tVal._presize((unsigned long)piece);
+    tVal.zero_fill();
+    for (done = 0; done < num_limbs; done += piece) {
+        piece = MIN(num_limbs - done, MAX(done, piece));
+        tVal._reserve((unsigned long)(done + piece));
+        if (!bbi_read_all(fd, tVal._limbs + done, (unsigned long)piece * sizeof(BBI_BASE_TYPE))) {
+            return false;
+        }
+    }
+    for (i = 0; i < num_limbs; i++) {
+        tVal._limbs[i] = bbi_limb_le(tVal._limbs[i]);
+    }
+    if (negative && tVal._size() != 0) {
+        tVal._flags = BBI_NEGATIVE;
+    }
+
+    this->_swap(tVal);
+    return true;
+}
+
+//
+//  Makes the value the one saved in the file at path, using the file's
+//  limbs where they are instead of reading them in.  Loading costs the
+//  same for any size, and pages come in as they're touched.
+//
+//  With writable (the default) the mapping is copy-on-write:  the 
+//  value can be used like any other, changing it copies just the 
+//  pages it touches, and nothing ever goes back to the file.  Without
+//  it the pages are mapped read-only, which the system doesn't have
+//  to set aside memory for;  the value still works like any other, 
+//  but the first change to it copies the whole value to the heap (see
+//  _writable).  Either way a value that has to grow moves to the heap.
+//
+//  Big endian machines, and values under two limbs, are read in 
+//  normally.  Returns false, with the value untouched, if the file 
+//  can't be opened or isn't in the format.
+bool bigbigint::load_mapped(const char *path, bool writable)
+{
+#if defined(WIN32) || defined(MEM_ARCH_USES_BIG_ENDIAN)
+    int fd;
+    bool loaded;
+
+    (void)writable;
+#if defined(WIN32)
+    fd = _open(path, _O_RDONLY | _O_BINARY);
+#else
+    fd = open(path, O_RDONLY);
+#endif
+    if (fd < 0) {
+        return false;
+    }
+    loaded = this->load(fd);
+#if defined(WIN32)
+    _close(fd);
+#else
+    close(fd);
+#endif
+    return loaded;
+#else
+    unsigned char header[BBI_FILE_HEADER_SIZE];
+    uint64_t num_limbs, limb_offset;
+    uintptr_t page_size, map_offset;
+    struct stat info;
+    void *map;
+    bool negative, loaded;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    if (!bbi_read_all(fd, header, sizeof(header)) ||
+        !bbi_parse_header(header, &negative, &num_limbs, &limb_offset) ||
+        fstat(fd, &info) != 0 ||
+        (uint64_t)info.st_size < limb_offset + num_limbs * sizeof(BBI_BASE_TYPE)) {
+        close(fd);
+        return false;
+    }
+
+    // Too small to be worth a mapping (and the class wants at least 
+    // BBI_MIN_SIZE limbs)
+    if (num_limbs < BBI_MIN_SIZE) {
+        lseek(fd, 0, SEEK_SET);
+        loaded = this->load(fd);
+        close(fd);
+        return loaded;
+    }
+
+    // Map from the page the limbs start in
+    page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+    map_offset = (uintptr_t)limb_offset & ~(page_size - 1);
+    map = mmap(NULL, (size_t)(limb_offset - map_offset + num_limbs * sizeof(BBI_BASE_TYPE)),
+               (writable ? PROT_READ | PROT_WRITE : PROT_READ), MAP_PRIVATE, 
+               fd, (off_t)map_offset);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    this->_free();
+    this->_limbs = (BBI_BASE_TYPE *)((char *)map + (limb_offset - map_offset));
+    this->_length = (unsigned long)num_limbs;
+    this->_num_bytes = this->_length * sizeof(BBI_BASE_TYPE);
+    this->_storage = (writable ? BBI_STORAGE_MAPPED : BBI_STORAGE_MAPPED_READ);
+    this->_flags = ((negative && this->_size() != 0) ? BBI_NEGATIVE : 0);
+    return true;
+#endif
+}
+
+//
+//  Sets the value from num_digits (valid, unsigned) digits
+void bigbigint::_read_digits(const char *digits, unsigned long num_digits, int base)
+{
+    unsigned long this_size, chunks, low_digits;
+    bigbigint high, low;
+
+    bbi_str_cache &cache = bbi_str_powers;
+    if ((base & (base - 1)) == 0 || 
+        num_digits < BBI_SET_STR_DC_THRESHOLD * cache.digits) {
+        this->_presize(bbi_set_str_size(num_digits, base));
+        this_size = bbi_set_str(this->_limbs, digits, num_digits, base);
+        memset(this->_limbs + this_size, 0, 
+               (this->_length - this_size) * sizeof(BBI_BASE_TYPE));
+        this->_flags = 0;
+        return;
+    }
+
+    // Split off the bottom big_base^(chunks / 2) worth of digits
+    chunks = (num_digits + cache.digits - 1) / cache.digits;
+    low_digits = (chunks / 2) * cache.digits;
+    high._read_digits(digits, num_digits - low_digits, base);
+    low._read_digits(digits + num_digits - low_digits, low_digits, base);
+
+    bbi_str_power &power = bbi_str_power_for(cache, chunks / 2);
+    *this = high * power.power + low;
+}
+
+//
+//  Sets the value (and sign) from num_digits checked digits
+void bigbigint::_set_digits(const char *digits, unsigned long num_digits, int base, bool negative)
+{
+    // Leading zeros cost nothing to leave out
+    while (num_digits > 1 && *digits == '0') {
+        digits++;
+        num_digits--;
+    }
+
+    BBI_TRACE(BBI_STAT_FROM_TEXT, bbi_set_str_size(num_digits, base));
+    bbi_str_cache_for(base);
+    this->_read_digits(digits, num_digits, base);
+    BBI_STAT_OP(BBI_STAT_FROM_TEXT, this->_size());
+    if (negative && this->_size() != 0) {
+        this->_flags = BBI_NEGATIVE;
+    }
+}
+
+//  The end of the run of digits (valid for the base) starting at first
+static const char *bbi_scan_digits(const char *first, const char *last, int base)
+{
+    while (first != last && bbi_digit_value(*first) < base) {
+        first++;
+    }
+    return first;
+}
+
+//
+//  Sets the value from a string in the given base (2 - 36):  an 
+//  optional sign and then the digits, upper or lower case, with 
+//  nothing before or after.  Base 16 also takes a "0x" prefix.  Base 0
+//  picks the base from the prefix the way strtol does ("0x" hex, "0b"
+//  binary, a leading 0 octal, otherwise decimal).
+//
+//  Returns false, and leaves the value alone, if the string isn't a 
+//  number in that base.
+bool bigbigint::from_string(const char *str, int base)
+{
+    const char *end;
+    bool negative;
+
+    if (str == NULL || base == 1 || base < 0 || base > 36) {
+        return false;
+    }
+
+    negative = (*str == '-');
+    if (*str == '-' || *str == '+') {
+        str++;
+    }
+
+    if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X') && 
+        (base == 0 || base == 16)) {
+        base = 16;
+        str += 2;
+    }
+    else if (str[0] == '0' && (str[1] == 'b' || str[1] == 'B') && base == 0) {
+        base = 2;
+        str += 2;
+    }
+    else if (base == 0) {
+        base = (str[0] == '0' ? 8 : 10);
+    }
+
+    end = bbi_scan_digits(str, str + strlen(str), base);
+    if (end == str || *end != '\0') {
+        return false;
+    }
+    this->_set_digits(str, (unsigned long)(end - str), base, negative);
+    return true;
+}
+
+bool bigbigint::from_string(const std::string &str, int base)
+{
+    return this->from_string(str.c_str(), base);
+}
+
+//
+//  Reads a value from the start of [first, last) in the given base 
+//  (2 - 36), the same as std::from_chars:  an optional '-' and as many
+//  digits (either case) as there are, no prefixes or whitespace.  
+//  Returns the end of the number, or first and invalid_argument (with
+//  the value untouched) if there isn't one.
+bbi_from_chars_result from_chars(const char *first, const char *last, bigbigint &value, int base)
+{
+    bbi_from_chars_result result;
+    const char *digits, *end;
+    bool negative;
+
+    result.ptr = first;
+    result.ec = std::errc::invalid_argument;
+    if (base < 2 || base > 36) {
+        return result;
+    }
+
+    negative = (first != last && *first == '-');
+    digits = first + (negative ? 1 : 0);
+    end = bbi_scan_digits(digits, last, base);
+    if (end == digits) {
+        return result;
+    }
+
+    value._set_digits(digits, (unsigned long)(end - digits), base, negative);
+    result.ptr = end;
+    result.ec = std::errc();
+    return result;
+}
+
+//
+//  Stream output.  Follows the stream's basefield (dec, hex or oct), 
+//  showbase, showpos, uppercase, width, fill and adjustfield, the same
+//  as for a built-in integer.  The digits are formatted on the scratch
+//  stack, so no string is built.
+std::ostream &operator <<(std::ostream &os, const bigbigint &value)
+{
+    std::ios_base::fmtflags flags;
+    bbi_to_chars_result result;
+    unsigned long size, length, prefix, padding, i;
+    char *buffer, *digits, *text;
+    int base;
+
+    std::ostream::sentry ok(os);
+    if (!ok) {
+        return os;
+    }
+
+    flags = os.flags();
+    base = 10;
+    if ((flags & std::ios_base::basefield) == std::ios_base::hex) {
+        base = 16;
+    }
+    else if ((flags & std::ios_base::basefield) == std::ios_base::oct) {
+        base = 8;
+    }
+
+    // Room for a sign and a "0x" in front of to_chars()'s output
+    bbi_tmp_scope tmp;
+    size = value.digits_upper_bound(base) + 3;
+    buffer = (char *)tmp.alloc((size / sizeof(BBI_BASE_TYPE)) + 1);
+    digits = buffer + 3;
+    result = to_chars(digits, buffer + size, value, base);
+    if (*digits == '-') {
+        digits++;
+    }
+    if ((flags & std::ios_base::uppercase) && base == 16) {
+        for (text = digits; text != result.ptr; text++) {
+            if (*text >= 'a') {
+                *text = (char)(*text - 'a' + 'A');
+            }
+        }
+    }
+
+    // Prefix:  sign, then the base.  As with the built-in types a zero
+    // gets no base and only decimal shows a '+'.  Negative numbers 
+    // are written as a sign and magnitude in every base.
+    text = digits;
+    if ((flags & std::ios_base::showbase) && base == 16 && *digits != '0') {
+        *--text = ((flags & std::ios_base::uppercase) ? 'X' : 'x');
+        *--text = '0';
+    }
+    else if ((flags & std::ios_base::showbase) && base == 8 && *digits != '0') {
+        *--text = '0';
+    }
+    if (value < 0) {
+        *--text = '-';
+    }
+    else if ((flags & std::ios_base::showpos) && base == 10) {
+        *--text = '+';
+    }
+    prefix = (unsigned long)(digits - text);
+    length = (unsigned long)(result.ptr - text);
+
+    padding = 0;
+    if (os.width() > 0 && (unsigned long)os.width() > length) {
+        padding = (unsigned long)os.width() - length;
+    }
+    os.width(0);
+
+    std::streambuf *out = os.rdbuf();
+    if ((flags & std::ios_base::adjustfield) == std::ios_base::left) {
+        out->sputn(text, length);
+        for (i = 0; i < padding; i++) out->sputc(os.fill());
+    }
+    else if ((flags & std::ios_base::adjustfield) == std::ios_base::internal) {
+        out->sputn(text, prefix);
+        for (i = 0; i < padding; i++) out->sputc(os.fill());
+        out->sputn(digits, length - prefix);
+    }
+    else {
+        for (i = 0; i < padding; i++) out->sputc(os.fill());
+        out->sputn(text, length);
+    }
+    return os;
+}
+
+std::ostream &operator <<(std::ostream &os, const bigbigint_view &value)
+{
+    return (os << bigbigint(value, bigbigint::_BORROW));
+}
+
+//
+//  Stream input.  Skips leading whitespace (unless skipws is off), then
+//  reads an optional sign and the digits for the stream's basefield 
+//  (hex takes an optional "0x", and no basefield at all goes by the 
+//  prefix as from_string(str, 0) does).  Sets failbit and leaves the
+//  value alone if there are no digits.
+std::istream &operator >>(std::istream &is, bigbigint &value)
+{
+    std::ios_base::fmtflags flags;
+    unsigned long length, size;
+    char local[512], *buffer, *grown;
+    int base, c;
+    bool negative;
+
+    std::istream::sentry ok(is);
+    if (!ok) {
+        return is;
+    }
+
+    std::streambuf *in = is.rdbuf();
+    flags = is.flags();
+    base = 0;
+    if ((flags & std::ios_base::basefield) == std::ios_base::dec) base = 10;
+    if ((flags & std::ios_base::basefield) == std::ios_base::hex) base = 16;
+    if ((flags & std::ios_base::basefield) == std::ios_base::oct) base = 8;
+
+    c = in->sgetc();
+    negative = (c == '-');
+    if (c == '-' || c == '+') {
+        c = in->snextc();
+    }
+
+    // A leading 0 may be a prefix, or it may be the number
+    length = 0;
+    if (c == '0' && (base == 0 || base == 16)) {
+        c = in->snextc();
+        if ((c == 'x' || c == 'X') || (base == 0 && (c == 'b' || c == 'B'))) {
+            base = ((c == 'x' || c == 'X') ? 16 : 2);
+            c = in->snextc();
+        }
+        else {
+            length = 1;
+            if (base == 0) base = 8;
+        }
+    }
+    if (base == 0) {
+        base = 10;
+    }
+
+    // Gather the digits.  Short numbers fit in local; past that the 
+    // buffer moves to the heap and doubles as needed.
+    buffer = local;
+    size = sizeof(local);
+    buffer[0] = '0';
+    while (c != std::char_traits<char>::eof() && bbi_digit_value((char)c) < base) {
+        if (length == size) {
+            size *= 2;
+            grown = (char *)realloc((buffer == local ? NULL : buffer), size);
+            if (grown == NULL) {
+                exit(2);
+            }
+            if (buffer == local) {
+                memcpy(grown, local, length);
+            }
+            buffer = grown;
+        }
+        buffer[length++] = (char)c;
+        c = in->snextc();
+    }
+
+    if (length == 0) {
+        is.setstate(std::ios_base::failbit);
+    }
+    else {
+        value._set_digits(buffer, length, base, negative);
+    }
+    if (c == std::char_traits<char>::eof()) {
+        is.setstate(std::ios_base::eofbit);
+    }
+    if (buffer != local) {
+        free(buffer);
+    }
+    return is;
+}
+
+//
+// Statistics
+//
+//  See the STATISTICS section at the top for how they're counted.
+//
+
+static const char *const bbi_stat_names[BBI_STAT_NUM_OPS] = {
+    "add", "mul", "mul_scalar", "div", "div_scalar", 
+    "shift", "bitwise", "to_text", "from_text", "powmod"
+};
+
+const char *bbi_stat_name(int op)
+{
+    if (op < 0 || op >= BBI_STAT_NUM_OPS) {
+        return "";
+    }
+    return bbi_stat_names[op];
+}
+
+bbi_stats bigbigint::stats(bool all_threads)
+{
+    bbi_stats result;
+
+    memset(&result, 0, sizeof(result));
+#if defined(BBI_ENABLE_STATS)
+    uint64_t totals[BBI_STATS_NUM_COUNTERS];
+    const bbi_stats_block *block;
+    int i;
+
+    if (all_threads) {
+        std::lock_guard<std::mutex> guard(bbi_stats_lock);
+        for (i = 0; i < BBI_STATS_NUM_COUNTERS; i++) {
+            totals[i] = bbi_stats_retired[i];
+        }
+        for (block = bbi_stats_threads; block != NULL; block = block->next) {
+            for (i = 0; i < BBI_STATS_NUM_COUNTERS; i++) {
+                totals[i] += block->counters[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    else {
+        for (i = 0; i < BBI_STATS_NUM_COUNTERS; i++) {
+            totals[i] = bbi_thread_stats.counters[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    for (i = 0; i < BBI_STAT_NUM_OPS; i++) {
+        result.calls[i] = totals[BBI_STATS_CALLS + i];
+        result.limbs[i] = totals[BBI_STATS_LIMBS + i];
+    }
+    result.mallocs = totals[BBI_STATS_MALLOCS];
+    result.upsizes = totals[BBI_STATS_UPSIZES];
+    result.copies = totals[BBI_STATS_COPIES];
+    result.bytes_allocated = totals[BBI_STATS_BYTES_ALLOCATED];
+    result.bytes_copied = totals[BBI_STATS_BYTES_COPIED];
+#else
+    (void)all_threads;
+#endif
+    return result;
+}
+
+void bigbigint::reset_stats(bool all_threads)
+{
+#if defined(BBI_ENABLE_STATS)
+    bbi_stats_block *block;
+    int i;
+
+    if (all_threads) {
+        std::lock_guard<std::mutex> guard(bbi_stats_lock);
+        for (i = 0; i < BBI_STATS_NUM_COUNTERS; i++) {
+            bbi_stats_retired[i] = 0;
+        }
+        for (block = bbi_stats_threads; block != NULL; block = block->next) {
+            for (i = 0; i < BBI_STATS_NUM_COUNTERS; i++) {
+                block->counters[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+    else {
+        for (i = 0; i < BBI_STATS_NUM_COUNTERS; i++) {
+            bbi_thread_stats.counters[i].store(0, std::memory_order_relaxed);
+        }
+    }
+#else
+    (void)all_threads;
+#endif
+}
+
+//
+//  The counts as a table, in one write() so it stays in one piece
+//  when other threads are writing to the same place
+bool bigbigint::write_stats(int fd, bool all_threads)
+{
+    char text[2048];
+    bbi_stats counts;
+    int length, i;
+
+#if defined(BBI_ENABLE_STATS)
+    counts = stats(all_threads);
+    length = snprintf(text, sizeof(text), "bigbigint stats (%s)\n%-12s %20s %20s\n", 
+                      (all_threads ? "all threads" : "one thread"), "operation", "calls", "limbs");
+    for (i = 0; i < BBI_STAT_NUM_OPS; i++) {
+        length += snprintf(text + length, sizeof(text) - length, "%-12s %20llu %20llu\n", 
+                           bbi_stat_names[i], (unsigned long long)counts.calls[i], 
+                           (unsigned long long)counts.limbs[i]);
+    }
+    length += snprintf(text + length, sizeof(text) - length, 
+                       "%-12s %20s %20s\n"
+                       "%-12s %20llu\n"
+                       "%-12s %20llu\n"
+                       "%-12s %20llu %20llu\n"
+                       "%-12s %20llu %20llu\n",
+                       "memory", "calls", "bytes", 
+                       "malloc", (unsigned long long)counts.mallocs, 
+                       "upsize", (unsigned long long)counts.upsizes, 
+                       "allocated", (unsigned long long)(counts.mallocs + counts.upsizes), 
+                       (unsigned long long)counts.bytes_allocated, 
+                       "copied", (unsigned long long)counts.copies, 
+                       (unsigned long long)counts.bytes_copied);
+#else
+    (void)counts;
+    (void)i;
+    (void)all_threads;
+    length = snprintf(text, sizeof(text), "bigbigint stats:  not counted (build with BBI_ENABLE_STATS)\n");
+#endif
+    return bbi_write_all(fd, text, (unsigned long)length);
+}
+
+void bigbigint::write_stats_at_exit(int fd)
+{
+#if defined(BBI_ENABLE_STATS)
+    bbi_stats_exit_fd = fd;
+#else
+    (void)fd;
+#endif
+}
+
+//
+// Tracing
+//
+//  See the TRACING section at the top for how operations are timed.
+//
+
+void bigbigint::trace_start(unsigned long min_limbs, unsigned long max_events)
+{
+#if defined(BBI_ENABLE_TRACE)
+    bbi_histogram *hist;
+    int op, size_class, i;
+
+    bbi_trace_min.store(ULONG_MAX, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> guard(bbi_trace_lock);
+    bbi_trace_events.clear();
+    bbi_trace_max_events = max_events;
+    bbi_trace_dropped = 0;
+    bbi_trace_epoch = bbi_trace_now();
+    for (op = 0; op < BBI_STAT_NUM_OPS; op++) {
+        for (size_class = 0; size_class < BBI_TRACE_CLASSES; size_class++) {
+            hist = bbi_trace_hists[op][size_class].load(std::memory_order_acquire);
+            if (hist == NULL) continue;
+            hist->count.store(0, std::memory_order_relaxed);
+            hist->total_ns.store(0, std::memory_order_relaxed);
+            hist->min_ns.store(UINT64_MAX, std::memory_order_relaxed);
+            hist->max_ns.store(0, std::memory_order_relaxed);
+            for (i = 0; i < BBI_HIST_BUCKETS; i++) {
+                hist->buckets[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bbi_trace_min.store(min_limbs, std::memory_order_relaxed);
+#else
+    (void)min_limbs;
+    (void)max_events;
+#endif
+}
+
+//
+//  What was recorded stays until the next trace_start()
+void bigbigint::trace_stop()
+{
+#if defined(BBI_ENABLE_TRACE)
+    bbi_trace_min.store(ULONG_MAX, std::memory_order_relaxed);
+#endif
+}
+
+//
+//  Either hook can be NULL.  They're called on the thread doing the
+//  operation, begin before the clock starts and end after it stops,
+//  so their own time isn't counted.
+void bigbigint::set_trace_hooks(bbi_trace_begin_hook begin, bbi_trace_end_hook end, void *user)
+{
+#if defined(BBI_ENABLE_TRACE)
+    bbi_trace_user.store(user, std::memory_order_relaxed);
+    bbi_trace_begin_fn.store(begin, std::memory_order_release);
+    bbi_trace_end_fn.store(end, std::memory_order_release);
+#else
+    (void)begin;
+    (void)end;
+    (void)user;
+#endif
+}
+
+#if defined(BBI_ENABLE_TRACE)
+//
+//  The smallest value with at least fraction of the count at or below
+//  it (to the top of its bucket, but never past the largest seen)
+static uint64_t bbi_hist_percentile(const bbi_histogram *hist, uint64_t count, uint64_t max_ns, double fraction)
+{
+    uint64_t wanted, seen;
+    int i;
+
+    wanted = (uint64_t)(fraction * (double)count + 0.999999);
+    wanted = MAX(wanted, (uint64_t)1);
+    seen = 0;
+    for (i = 0; i < BBI_HIST_BUCKETS; i++) {
+        seen += hist->buckets[i].load(std::memory_order_relaxed);
+        if (seen >= wanted) {
+            return MIN(bbi_hist_bucket_top(i), max_ns);
+        }
+    }
+    return max_ns;
+}
+#endif
+
+//
+//  One line per operation and size class, in nanoseconds
+bool bigbigint::write_trace_histograms(int fd)
+{
+    std::string text;
+    char line[256];
+
+#if defined(BBI_ENABLE_TRACE)
+    const bbi_histogram *hist;
+    uint64_t count, max_ns;
+    unsigned long low, high;
+    int op, size_class;
+
+    snprintf(line, sizeof(line), "bigbigint latency (ns)\n%-10s %21s %10s %10s %10s %10s %10s %10s %10s %10s\n", 
+             "operation", "limbs", "count", "min", "p50", "p90", "p99", "p99.9", "max", "mean");
+    text += line;
+    for (op = 0; op < BBI_STAT_NUM_OPS; op++) {
+        for (size_class = 0; size_class < BBI_TRACE_CLASSES; size_class++) {
+            hist = bbi_trace_hists[op][size_class].load(std::memory_order_acquire);
+            if (hist == NULL) continue;
+            count = hist->count.load(std::memory_order_relaxed);
+            if (count == 0) continue;
+            max_ns = hist->max_ns.load(std::memory_order_relaxed);
+            low = (size_class == 0) ? 0 : (1UL << (size_class - 1));
+            high = (size_class == 0) ? 0 : (low - 1) + low;
+            snprintf(line, sizeof(line), "%-10s %10lu-%-10lu %10llu %10llu %10llu %10llu %10llu %10llu %10llu %10llu\n", 
+                     bbi_stat_names[op], low, high, (unsigned long long)count, 
+                     (unsigned long long)hist->min_ns.load(std::memory_order_relaxed), 
+                     (unsigned long long)bbi_hist_percentile(hist, count, max_ns, 0.5), 
+                     (unsigned long long)bbi_hist_percentile(hist, count, max_ns, 0.9), 
+                     (unsigned long long)bbi_hist_percentile(hist, count, max_ns, 0.99), 
+                     (unsigned long long)bbi_hist_percentile(hist, count, max_ns, 0.999), 
+                     (unsigned long long)max_ns, 
+                     (unsigned long long)(hist->total_ns.load(std::memory_order_relaxed) / count));
+            text += line;
+        }
+    }
+#else
+    snprintf(line, sizeof(line), "bigbigint latency:  not timed (build with BBI_ENABLE_TRACE)\n");
+    text = line;
+#endif
+    return bbi_write_all(fd, text.data(), (unsigned long)text.size());
+}
+
+//
+//  The events as Chrome trace event JSON:  "X" (complete) events with
+//  the times in microseconds from trace_start(), one tid per thread,
+//  and the operation's size in args.  It's written a piece at a time
+//  from a copy, so the threads being traced aren't held up.
+bool bigbigint::write_chrome_trace(int fd)
+{
+    std::string text;
+    char line[256];
+
+#if defined(BBI_ENABLE_TRACE)
+    std::vector<bbi_trace_event> events;
+    unsigned long dropped, i;
+
+    {
+        std::lock_guard<std::mutex> guard(bbi_trace_lock);
+        events = bbi_trace_events;
+        dropped = bbi_trace_dropped;
+    }
+
+    text = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (i = 0; i < events.size(); i++) {
+        snprintf(line, sizeof(line), 
+                 "%s\n{\"name\":\"%s\",\"cat\":\"bigbigint\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                 "\"ts\":%llu.%03u,\"dur\":%llu.%03u,\"args\":{\"limbs\":%lu}}", 
+                 (i == 0) ? "" : ",", bbi_stat_names[events[i].op], events[i].thread, 
+                 (unsigned long long)(events[i].start_ns / 1000), (unsigned int)(events[i].start_ns % 1000), 
+                 (unsigned long long)(events[i].ns / 1000), (unsigned int)(events[i].ns % 1000), 
+                 events[i].limbs);
+        text += line;
+        if (text.size() >= 65536) {
+            if (!bbi_write_all(fd, text.data(), (unsigned long)text.size())) {
+                return false;
+            }
+            text.clear();
+        }
+    }
+    snprintf(line, sizeof(line), "\n],\"otherData\":{\"dropped\":%lu}}\n", dropped);
+    text += line;
+#else
+    snprintf(line, sizeof(line), "{\"traceEvents\":[]}\n");
+    text = line;
+#endif
+    return bbi_write_all(fd, text.data(), (unsigned long)text.size());
+}
+
+//
+// Threads
+//
+
+void bigbigint::set_mul_threads(unsigned int num_threads, unsigned long min_limbs)
+{
+    bbi_set_mul_threads(num_threads, min_limbs);
+}
+
+unsigned int bigbigint::mul_threads()
+{
+    return bbi_mul_threads();
+}
+
+
+
+
+/*******************************************
+ *             BIGBIGINT VIEW              *
+ *******************************************/
+//
+//  The read-only operations live here and bigbigint's versions pass
+//  a view of themselves in.  Anything that needs a bigbigint (the 
+//  text conversion, expression operands) borrows the view's limbs
+//  into one, so nothing is copied either way.
+//
+
+bigbigint_view::bigbigint_view()
+{
+    this->_limbs = NULL;
+    this->_size = 0;
+    this->_negative = false;
+}
+
+//
+//  The top limbs can be zero (they're left out of the size), so any 
+//  slice of an array of limbs will do
+bigbigint_view::bigbigint_view(const BBI_BASE_TYPE *limbs, unsigned long num_limbs, bool negative)
+{
+    this->_limbs = limbs;
+    this->_size = bbi_normalize(limbs, num_limbs);
+    this->_negative = (negative && this->_size != 0);
+}
+
+bigbigint_view::bigbigint_view(const bigbigint &val)
+{
+    this->_limbs = val._limbs;
+    this->_size = val._size();
+    this->_negative = (IS_NEGATIVE(val._flags) != 0);
+}
+
+//
+//  Returns -1, 0 or 1 as *this is less than, equal to or greater
+//  than CompVal.
+int bigbigint_view::compare(const bigbigint_view &CompVal) const
+{
+    int comp_result;
+
+    // Zero is never flagged negative, so this also covers -0 vs 0
+    if (this->_negative != CompVal._negative) {
+        return (this->_negative ? -1 : 1);
+    }
+
+    comp_result = bbi_cmp(this->_limbs, this->_size, CompVal._limbs, CompVal._size);
+    return (this->_negative ? -comp_result : comp_result);
+}
+
+//
+// Bit queries
+//
+//  bit_length, popcount and count_trailing_zeros look at the 
+//  magnitude (count_trailing_zeros is the same either way).  The
+//  single bit functions treat a negative value as two's complement,
+//  the same as &, | and ^ do.
+//
+
+//  Number of bits needed for the magnitude (0 for zero)
+unsigned long bigbigint_view::bit_length() const
+{
+    if (this->_size == 0) return 0;
+    return (this->_size * BBI_BASE_BITS) - BBI_CLZ(this->_limbs[this->_size - 1]);
+}
+
+//  Number of 1 bits in the magnitude
+unsigned long bigbigint_view::popcount() const
+{
+    unsigned long count, i;
+
+    count = 0;
+    for (i = 0; i < this->_size; i++) {
+        count += BBI_POPCOUNT(this->_limbs[i]);
+    }
+    return count;
+}
+
+//  Index of the lowest 1 bit (0 for zero)
+unsigned long bigbigint_view::count_trailing_zeros() const
+{
+    unsigned long i;
+
+    for (i = 0; i < this->_size; i++) {
+        if (this->_limbs[i] != 0) {
+            return (i * BBI_BASE_BITS) + BBI_CTZ(this->_limbs[i]);
+        }
+    }
+    return 0;
+}
+
+bool bigbigint_view::test_bit(unsigned long bit) const
+{
+    unsigned long offset, lowest_bit;
+    bool value;
+
+    offset = bit / BBI_BASE_BITS;
 
-/*******************************************
- *           EXTERNAL FUNCTIONS            *
- *******************************************/
+    // Past the top limb it's all sign
+    if (offset >= this->_size) {
+        return this->_negative;
+    }
 
-//
-// Length function
-//
-long bigbigint::length()
-{
-    return this->_length;
+    value = ((this->_limbs[offset] >> (bit % BBI_BASE_BITS)) & 1);
+    if (!this->_negative) {
+        return value;
+    }
+
+    // -m == ~(m - 1):  the bits below m's lowest 1 bit stay 0, that 
+    // bit stays 1, and everything above it is inverted.
+    lowest_bit = this->count_trailing_zeros();
+    if (bit <= lowest_bit) {
+        return (bit == lowest_bit);
+    }
+    return !value;
 }
 
 //
-// Copy function
+// Text
 //
-
-bigbigint * bigbigint::copy(bigbigint *copy)
+std::string bigbigint_view::to_string(int base) const
 {
-    // Setup internal vars
-    this->_length = copy->_length;
-    this->_num_bytes = copy->_num_bytes;
-    this->_flags = copy->_flags;
-
-    // Malloc size.
-    this->_malloc(this->_num_bytes);
+    return bigbigint(*this, bigbigint::_BORROW).to_string(base);
+}
 
-    memcpy((char *)this->_first_byte, 
-        (char *)copy->_first_byte, 
-        copy->_num_bytes);
-    return this;
+unsigned long bigbigint_view::digits_upper_bound(int base) const
+{
+    return bbi_sizeinbase(this->_limbs, this->_size, base) + (this->_negative ? 1 : 0);
 }
 
-/*
+bool bigbigint_view::write_text(bbi_digit_sink &sink, int base) const
+{
+    return bigbigint(*this, bigbigint::_BORROW).write_text(sink, base);
+}
 
-// 
-//  Print Function
 //
-void bigbigint::PrintToBuffer(char **outline)
+//  Hash of the value.  Only the limbs in use and the sign go in, so a 
+//  bigbigint and a view of the same number (with any number of zero 
+//  limbs on top) hash the same.  Each limb is mixed in with a multiply
+//  and a fold of the high half, which is one multiply per limb and 
+//  spreads every input bit over the whole result.
+size_t bigbigint_view::hash() const
 {
+    uint64_t value;
+    unsigned long i;
 
-    sprintf(*outline, "%d", this->_first_byte);
-
+    value = 0x9E3779B97F4A7C15ULL ^ (uint64_t)this->_size ^ (this->_negative ? 0x5555555555555555ULL : 0);
+    for (i = 0; i < this->_size; i++) {
+        value = (value ^ (uint64_t)this->_limbs[i]) * 0xFF51AFD7ED558CCDULL;
+        value ^= (value >> 32);
+    }
+    value = (value ^ (value >> 29)) * 0xC4CEB9FE1A85EC53ULL;
+    return (size_t)(value ^ (value >> 32));
 }
-*/
-
-
 
 
 /*******************************************
@@ -226,29 +3282,25 @@ void bigbigint::PrintToBuffer(char **outline)
 
 //
 //  Copying a bigbigint.
-bigbigint bigbigint::operator =(const bigbigint &NewVal)
+bigbigint &bigbigint::operator =(const bigbigint &NewVal)
 {
-    unsigned long offset;
+    unsigned long used;
 
     if (this == &NewVal)  return *this;
 
-    //  If it's just a straight copy, then do it quickly and forget about it.
-    //  Otherwise, we need to Truncate / Zero Fill the value
-    if (this->_num_bytes == NewVal._num_bytes) {
-        memcpy(this->_first_byte, NewVal._first_byte, this->_num_bytes);
-    }
-    else if (this->_num_bytes < NewVal._num_bytes) {
+    //  If we have the room, just copy over the limbs in use and
+    //  zero fill the rest.  Otherwise, take on the new value's size.
+    used = NewVal._size();
+    if (this->_length < used) {
         this->_free();
         this->copy((bigbigint *)&NewVal);
     }
     else {
-        // Set the new value as the last bytes in the array.
-        // zero fill the rest.
-        offset = this->_num_bytes - NewVal._num_bytes;
-        memcpy(((char *)this->_first_byte) + offset, 
-            NewVal._first_byte, 
-            NewVal._num_bytes);
-        this->zero_fill(offset);
+        this->_writable(false);
+        memcpy(this->_limbs, NewVal._limbs, used * sizeof(BBI_BASE_TYPE));
+        memset(this->_limbs + used, 0, 
+            (this->_length - used) * sizeof(BBI_BASE_TYPE));
+        BBI_STAT_COPY(used * sizeof(BBI_BASE_TYPE));
     }
     this->_flags = NewVal._flags;
 
@@ -262,76 +3314,70 @@ bigbigint bigbigint::operator =(const bigbigint &NewVal)
 //  floating point base types after they have been rounded to an
 //  integral-type value.
 //
+//  Note: every native type fits in the lowest limb.
+//
 #define ASSIGN_OP_BODY_INT_TYPES(__var_name)   \
-    unsigned long offset;           \
-                                    \
     this->_flags = 0;               \
-    if (__var_name < 0) {           \
-        this->_flags |= BBI_NEGATIVE;   \
-        __var_name = 0 - __var_name;    \
-    }                               \
                                     \
     /* Clear the current value */   \
     this->zero_fill();              \
                                     \
-    /* Flip the byte order for copying*/\
-    REVERSE_BYTE_ORDER(__var_name); \
-                                    \
-    /* Copy over the new value in the correct offset.*/ \
-    offset = this->_num_bytes - sizeof(__var_name); \
-    memcpy( ((char *)this->_first_byte + offset),   \
-        &__var_name, sizeof(__var_name));
-
-
-bigbigint bigbigint::operator = (int NewVal)
+    if (__var_name < 0) {           \
+        this->_flags |= BBI_NEGATIVE;   \
+        this->_limbs[0] = 0 - (BBI_BASE_TYPE)__var_name;   \
+    }                               \
+    else {                          \
+        this->_limbs[0] = (BBI_BASE_TYPE)__var_name;   \
+    }
+bigbigint &bigbigint::operator = (int NewVal)
 {
     ASSIGN_OP_BODY_INT_TYPES(NewVal);
     return *this;
 }
 
-bigbigint bigbigint::operator = (unsigned int NewVal)
+bigbigint &bigbigint::operator = (unsigned int NewVal)
 {
     ASSIGN_OP_BODY_INT_TYPES(NewVal);
     return *this;
 }
 
-bigbigint bigbigint::operator = (long NewVal)
+bigbigint &bigbigint::operator = (long NewVal)
 {
     ASSIGN_OP_BODY_INT_TYPES(NewVal);
     return *this;
 }
 
-bigbigint bigbigint::operator = (unsigned long NewVal)
+bigbigint &bigbigint::operator = (unsigned long NewVal)
 {
     ASSIGN_OP_BODY_INT_TYPES(NewVal);
     return *this;
 }
 
-bigbigint bigbigint::operator = (short NewVal)
+bigbigint &bigbigint::operator = (short NewVal)
 {
     ASSIGN_OP_BODY_INT_TYPES(NewVal);
     return *this;
 }
 
-bigbigint bigbigint::operator = (unsigned short NewVal)
+bigbigint &bigbigint::operator = (unsigned short NewVal)
 {
     ASSIGN_OP_BODY_INT_TYPES(NewVal);
     return *this;
 }
 
-bigbigint bigbigint::operator = (char NewVal)
+bigbigint &bigbigint::operator = (char NewVal)
 {
     ASSIGN_OP_BODY_INT_TYPES(NewVal);
     return *this;
 }
 
-bigbigint bigbigint::operator = (unsigned char NewVal)
+bigbigint &bigbigint::operator = (unsigned char NewVal)
 {
     ASSIGN_OP_BODY_INT_TYPES(NewVal);
     return *this;
 }
 
-bigbigint bigbigint::operator = (float NewFloat)
+bigbigint &bigbigint::operator = (float NewFloat)
 {
     D_LONG NewVal;
 
@@ -341,7 +3387,7 @@ bigbigint bigbigint::operator = (float NewFloat)
     return *this;
 }
 
-bigbigint bigbigint::operator = (double NewDouble)
+bigbigint &bigbigint::operator = (double NewDouble)
 {
     D_LONG NewVal;
 
@@ -354,17 +3400,20 @@ bigbigint bigbigint::operator = (double NewDouble)
 // ------------------------------------------
 // Function Set:  Operator <type> Overloading
 // ------------------------------------------
+//
+//  Integral casts take the lowest limb (truncating, like any
+//  other narrowing integer conversion).
 #define CAST_OPERATOR_FUNCTION(__type)  \
     bigbigint::operator __type() const  \
     {                           \
-        __type tmp_var;         \
+        BBI_BASE_TYPE tmp_var;  \
                                 \
-        tmp_var = (__type) (this->_first_byte + (this->_num_bytes - sizeof(__type))); \
+        tmp_var = this->_limbs[0];          \
                                 \
         if(IS_NEGATIVE(this->_flags)) {     \
             tmp_var = 0 - tmp_var;          \
         }                       \
-        return tmp_var;       \
+        return (__type)tmp_var; \
     }       
 
 CAST_OPERATOR_FUNCTION(int);
@@ -378,205 +3427,45 @@ CAST_OPERATOR_FUNCTION(unsigned char);
 
 bigbigint::operator float() const  
 {                                  
-    long tmp_var;
-    tmp_var = ((long)(this->_first_byte + (this->_num_bytes - sizeof(long))));
-    return (float) tmp_var;  
+    return (float)(double)*this;  
 }       
 bigbigint::operator double() const  
 {                                   
-    long tmp_var;
-    tmp_var = ((long)(this->_first_byte + (this->_num_bytes - sizeof(long))));
-    return (double) tmp_var;
-}       
-
-
-// ------------------------------------------
-// Function Set:  Operator + Overloading
-// ------------------------------------------
-bigbigint bigbigint::operator +(bigbigint PlusVal)
-{
-    unsigned char *this_val, *plus_val, *tval_val;
-    bigbigint tVal(MAX(this->_length, PlusVal._length));
-    long result;
-
-
-    // Is there a single negative value?  If so, just subtract the
-    // negative from the positive.
-    // @RLA -- this needs to be (*this < 0)
-    if(IS_NEGATIVE(this->_flags) && !IS_NEGATIVE(PlusVal._flags))
-    {
-        *this = PlusVal - (-*this);
-        return *this;
-    }
-    else if(!IS_NEGATIVE(this->_flags) && IS_NEGATIVE(PlusVal._flags))
-    {
-        *this = *this - (-PlusVal);
-        return *this;
-    }
-
-    tVal = 0;
-    tVal._flags = this->_flags;
-
-    // start by pointing to the last byte in the number (big endian, remember)
-    this_val = (((unsigned char*) this->_first_byte) + this->_num_bytes - 1);
-    plus_val = (((unsigned char*) PlusVal._first_byte) + PlusVal._num_bytes - 1);
-    tval_val = (((unsigned char*) tVal._first_byte) + tVal._num_bytes - 1);
-
-    result = 0;
-    //
-    // For each byte in each of the string of numbers, add the Plus and This
-    while ((void*)this_val >= (void*)this->_first_byte 
-        && (void*)plus_val >= (void*)PlusVal._first_byte) 
-    {
-        result += (long)*this_val + (long)*plus_val;
+    double tmp_var;
+    unsigned long i;
 
-        *tval_val = (unsigned char)(result & UCHAR_MAX);
-        if (result > UCHAR_MAX) {
-            result >>= sizeof(char) * 8;
-        }
-        else {
-            result = 0;
-        }
-        plus_val--;
-        this_val--;
-        tval_val--;
+    // Fold the limbs in from the top (2^64 per limb)
+    tmp_var = 0;
+    for (i = this->_size(); i > 0; i--) {
+        tmp_var = tmp_var * 18446744073709551616.0 + (double)this->_limbs[i - 1];
     }
-
-//  Do we have something we need to carry over still?
-    if (result > 0) {
-        tVal._upsize(tVal._length + 1);
-        *((unsigned char*)tVal._first_byte + (sizeof(BBI_BASE_TYPE) - 1)) =
-                (char)(result & UCHAR_MAX);
-
+    if(IS_NEGATIVE(this->_flags)) {
+        tmp_var = -tmp_var;
     }
-
-	return tVal;
+    return tmp_var;
 }
 
 
-
+// ------------------------------------------
+// Function Set:  Operator + Overloading
+// ------------------------------------------
+//
+//  Note: bigbigint + bigbigint is an expression template (see
+//  BigBigIntExpr.h and _add_signed above).  The functions here
+//  handle adding the native types.
+//
 bigbigint bigbigint::_perform_integral_adding(
         bigbigint * menuend,
         void* plus_var, 
         unsigned long plus_size,
         bool is_signed)
 {
-    bigbigint tVal(menuend->_length);
-    unsigned char *p_menuend_val, *p_plus_val, *p_outp_val;  
-    D_LONG add_value, result;
-
-    tVal = *menuend;
-
-    //
-    // First off, we need to take the data and shove it into
-    // a format we can read.  For this purpose, we just stick
-    // everything in an __int64/double long so that the
-    // machine can read it as it was meant to be.
-#if defined(MEM_ARCH_USES_BIG_ENDIAN) 
-    if((char*)plus_var >= 0  || is_signed == false)  
-#else
-    if((*((char*)plus_var + (plus_size-1)) >= 0) || is_signed == false)  
-#endif
-    {
-        add_value = 0;
-        #if defined(MEM_ARCH_USES_BIG_ENDIAN) 
-            memcpy((char*)add_value + (sizeof(add_value) - plus_size)),
-                plus_var, plus_size);
-        #else
-            memcpy(&add_value, plus_var, plus_size);
-        #endif
-    }
-    else
-    {
-        add_value = -1;
-        #if defined(MEM_ARCH_USES_BIG_ENDIAN) 
-            memcpy((char*)add_value + (sizeof(add_value) - plus_size)),
-                plus_var, plus_size);
-        #else
-            memcpy(&add_value, plus_var, plus_size);
-        #endif
-
-        // note: if p_plus_val is negative, so is *menuend 
-        // since we're copying the flags from *menuend to the output_value
-        // the output will automatically be negative (so we just need to add the
-        // positive parts of the numbers (-5) + (-3) = (-8)
-        add_value = 0 - add_value;
-    }
-
-    /* Flip the byte order for copying*/                        
-    REVERSE_BYTE_ORDER(add_value);
-
-    /* start by pointing to the last byte in the number (big endian) */ 
-    p_menuend_val = (((unsigned char*) menuend->_first_byte) +      
-                   menuend->_num_bytes - 1);                       
-    p_outp_val = (((unsigned char*) tVal._first_byte) +   
-                   tVal._num_bytes - 1);                    
-    p_plus_val = (((unsigned char*) &add_value) +            
-                   sizeof(add_value) - 1);                     
-
-    result = 0; 
- 
-    /* For each byte in each of the string of numbers, */
-    /* add the Plus and Menuend */
-    while ((void*)p_menuend_val >= (void*)menuend->_first_byte)
-    {
-        if ((void*)p_plus_val >= (void*)&add_value)
-        {
-            result += (long)*p_menuend_val + 
-                      (long)*p_plus_val;
-            p_plus_val--;
-        } else {
-            if(result == 0)
-            { break; }
-
-            result += (long)*p_plus_val;
-        }
-
-        *p_outp_val = (char)(result & UCHAR_MAX);
-        if (result > UCHAR_MAX) {
-            result >>= sizeof(char); 
-        }  
-        else { 
-            result = 0;
-        } 
-        p_menuend_val--; 
-        p_outp_val--;
-    }
-
-    /* Do we have something we need to carry over still? */     
-    if (result > 0) {
-        tVal._upsize(tVal._length + 1);
-        *((char*)tVal._first_byte + (sizeof(BBI_BASE_TYPE) - 1)) =
-                (char)(result & UCHAR_MAX);
+    bigbigint tVal(*menuend);
 
-    }
+    tVal._add_scalar(plus_var, plus_size, is_signed, false);
     return tVal;
 }
 
-//
-//      ------------------
-//          @RLA -- THis needs to be integrated into the functions below
-//          (via a macro, no doubt)
-//      ------------------
-//
-
-/*          @RLA  -- uncomment!  (once the operator- is done)
-    // Is there a single negative value?  If so, just subtract the
-    // negative from the positive.
-    // @RLA -- this needs to be (*this < 0)
-
-    if(IS_NEGATIVE(this->_flags) && PlusVal > 0)
-    {
-        *this = PlusVal - *this;
-        return *this;
-    }
-    else if(!IS_NEGATIVE(this->_flags) && PlusVal < 0)
-    {
-        *this = *this - PlusVal;
-        return *this;
-    }
-*/
-
 #define ADD_OPERATOR_MEMBER_FUNCTION(__type, __is_signed)    \
     bigbigint bigbigint::operator +(__type PlusVal) \
     {                                               \
@@ -654,24 +3543,47 @@ bigbigint operator +(const double &PlusDouble, bigbigint &ValB)
 // ------------------------------------------
 // Function Set:  Operator += Overloading
 // ------------------------------------------
-#define PLUS_EQ_OPERATOR_MEMBER_FUNCTION(__type)    \
-    bigbigint bigbigint::operator +=(__type PlusVal) \
+//
+//  These all work in place (see _add_signed and _add_scalar).
+bigbigint &bigbigint::operator +=(const bigbigint &PlusVal)
+{
+    this->_add_signed(PlusVal, false);
+    return *this;
+}
+
+#define PLUS_EQ_OPERATOR_MEMBER_FUNCTION(__type, __is_signed)    \
+    bigbigint &bigbigint::operator +=(__type PlusVal) \
     {                   \
-        *this = *this + PlusVal; \
+        this->_add_scalar((void*)&PlusVal, sizeof(PlusVal), __is_signed, false); \
         return *this;       \
     }
 
-PLUS_EQ_OPERATOR_MEMBER_FUNCTION(bigbigint);
-PLUS_EQ_OPERATOR_MEMBER_FUNCTION(int);
-PLUS_EQ_OPERATOR_MEMBER_FUNCTION(unsigned int);
-PLUS_EQ_OPERATOR_MEMBER_FUNCTION(long);
-PLUS_EQ_OPERATOR_MEMBER_FUNCTION(unsigned long);
-PLUS_EQ_OPERATOR_MEMBER_FUNCTION(short);
-PLUS_EQ_OPERATOR_MEMBER_FUNCTION(unsigned short);
-PLUS_EQ_OPERATOR_MEMBER_FUNCTION(char);
-PLUS_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char);
-PLUS_EQ_OPERATOR_MEMBER_FUNCTION(float);
-PLUS_EQ_OPERATOR_MEMBER_FUNCTION(double);
+PLUS_EQ_OPERATOR_MEMBER_FUNCTION(int, true);
+PLUS_EQ_OPERATOR_MEMBER_FUNCTION(unsigned int, false);
+PLUS_EQ_OPERATOR_MEMBER_FUNCTION(long, true);
+PLUS_EQ_OPERATOR_MEMBER_FUNCTION(unsigned long, false);
+PLUS_EQ_OPERATOR_MEMBER_FUNCTION(short, true);
+PLUS_EQ_OPERATOR_MEMBER_FUNCTION(unsigned short, false);
+PLUS_EQ_OPERATOR_MEMBER_FUNCTION(char, true);
+PLUS_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char, false);
+
+bigbigint &bigbigint::operator +=(float PlusFloat)
+{
+    D_LONG PlusVal;
+    PlusVal = (D_LONG)PlusFloat;
+
+    this->_add_scalar((void*)&PlusVal, sizeof(PlusVal), true, false);
+    return *this;
+}
+
+bigbigint &bigbigint::operator +=(double PlusDouble)
+{
+    D_LONG PlusVal;
+    PlusVal = (D_LONG)PlusDouble;
+
+    this->_add_scalar((void*)&PlusVal, sizeof(PlusVal), true, false);
+    return *this;
+}
 
 
 //
@@ -705,244 +3617,45 @@ PLUS_EQ_OPERATOR_NON_MEMBER_FUNCTION(double);
 //
 bigbigint bigbigint::operator -()
 {
-    bigbigint tVal(this->_length);
-    tVal = *this;
-    tVal._flags ^= BBI_NEGATIVE;
+    bigbigint tVal(*this);
+    if (tVal._size() != 0) {
+        tVal._flags ^= BBI_NEGATIVE;
+    }
     return tVal;
 }
 
 //
 //  Binary operator- Overload
 //
-/*
-    Subtraction algorithm:
-        a) Take the 1's compliment of the subtrahend
-        b) Add it to the menuend
-        c) If there's a carry past the end of the number,
-            add it to the result (it will be 1)
-        d) If there's not a carry, take the 1's compliment of the result
-            and flip the sign
-*/
-bigbigint bigbigint::operator -(bigbigint Subtrahend)
-{
-    unsigned char *p_tVal, *p_this;
-    bigbigint tVal(MAX(this->_length, Subtrahend._length));
-    long result;
-
-    /*
-     * Is there a single negative value?  If so, just add the
-     * negative to the positive.
-     */
-    if(!IS_NEGATIVE(this->_flags) && IS_NEGATIVE(Subtrahend._flags) )
-    {   // 5 - (-3) = 5+3
-        tVal = *this + (-Subtrahend);
-        return tVal;
-    }
-    else if(IS_NEGATIVE(this->_flags) && IS_NEGATIVE(Subtrahend._flags) )
-    {   // -5 - (-3) = 3-5
-        tVal = (-Subtrahend) - (-*this);
-        return tVal;
-    }
-    else if(IS_NEGATIVE(this->_flags) && !IS_NEGATIVE(Subtrahend._flags) )
-    {   // -5 - (3) = -5 + -3
-        tVal = *this + (-Subtrahend);
-        return tVal;
-    }
-    //  Positive && positive:  Process normal
-    //  e.g.  5 - 3  
-
-    tVal = Subtrahend;
-    tVal._flags = this->_flags;
-
-    // Set up the Pointers
-    p_tVal = (((unsigned char*) tVal._first_byte) + tVal._num_bytes - 1);
-    p_this = (((unsigned char*) this->_first_byte) + this->_num_bytes - 1);
-
-    // Step 1:  Perform a 1's compliment of the subtrahend
-    ONES_COMPLEMENT(tVal);
-
-    result = 0;
-    //
-    // Step 2:  Add the Subtrahend to the Menuend
-    while ((void*)p_this >= (void*)this->_first_byte 
-        && (void*)p_tVal >= (void*)tVal._first_byte) 
-    {
-        result += (long)*p_this + (long)*p_tVal;
-
-        *p_tVal = (unsigned char)(result & UCHAR_MAX);
-        if (result > UCHAR_MAX) {
-            result >>= sizeof(unsigned char) * 8;
-        }
-        else {
-            result = 0;
-        }
-        p_tVal--;
-        p_this--;
-    }
-
-    //
-    // Step 3:  Handle the Carry
-    //
-    //     3a: If we have no carry: do a 1's compliment && flip the NEG flag
-    //     3b: If we have do have one: add it to the result.
-    if (result <= 0) {
-        ONES_COMPLEMENT(tVal);
-
-        if(IS_NEGATIVE(tVal._flags)) {
-            tVal._flags &= ~BBI_NEGATIVE;
-        }
-        else {
-            tVal._flags |= BBI_NEGATIVE;
-        }
-    }
-    else {
-
-        // Re-Set up the tVal Pointer
-        p_tVal = (((unsigned char*) tVal._first_byte) + tVal._num_bytes - 1);
-
-        // And add the remainder to the final number
-        while ((void*)p_tVal >= (void*)tVal._first_byte) 
-        {
-            result += (long)*p_tVal;
-
-            *p_tVal = (unsigned char)(result & UCHAR_MAX);
-            if (result <= UCHAR_MAX) {
-                break;
-            }
-            result >>= sizeof(unsigned char) * 8;
-            p_tVal--;
-        }
-    }
-
-	return tVal;
-}
-
-
-
+//  Note: bigbigint - bigbigint is an expression template (see
+//  BigBigIntExpr.h and _add_signed above).  The functions here
+//  handle subtracting the native types.
+//
 bigbigint bigbigint::_perform_integral_subtraction(
         bigbigint *this_val,
         void *Subtrahend,
         unsigned long sub_size,
         bool is_signed)
 {
-    unsigned char *p_tVal, *p_this;
-    D_LONG result;
-    long sub_value;
-    bigbigint tVal(MAX(this_val->_num_bytes, sub_size));
-
-    //
-    // First off, we need to take the data and shove it into
-    // a format we can read.  For this purpose, we just stick
-    // everything in an __int64/double long so that the
-    // machine can read it as it was meant to be.
-#if defined(MEM_ARCH_USES_BIG_ENDIAN) 
-    if((char*)Subtrahend >= 0  || is_signed == false)  
-#else
-    if((*((char*)Subtrahend + (sub_size-1)) >= 0) || is_signed == false)
-#endif
-    {
-        sub_value = 0;
-        #if defined(MEM_ARCH_USES_BIG_ENDIAN) 
-            memcpy((char*)sub_value + (sizeof(sub_value) - sub_size)),
-                Subtrahend, sub_size);
-        #else
-            memcpy(&sub_value, Subtrahend, sub_size);
-        #endif
-    }
-    else
-    {
-        sub_value = -1;
-        #if defined(MEM_ARCH_USES_BIG_ENDIAN) 
-            memcpy((char*)sub_value + (sizeof(sub_value) - sub_size)),
-                Subtrahend, sub_size);
-        #else
-            memcpy(&sub_value, Subtrahend, sub_size);
-        #endif
-    }
-
-    /*
-     * Is there a single negative value?  If so, just add the
-     * negative to the positive.
-     */
-    if(!IS_NEGATIVE(this_val->_flags) && sub_value<0 )
-    {   // 5 - (-3) = 5+3
-        tVal = *this_val + (-sub_value);
-        return tVal;
-    }
-    else if(IS_NEGATIVE(this_val->_flags) && sub_value<0 )
-    {   // -5 - (-3) = 3-5
-        tVal = (-sub_value) - ( -*this_val);
-        return tVal;
-    }
-    else if(IS_NEGATIVE(this_val->_flags) && sub_value>0 )
-    {   // -5 - (3) = -5 + -3
-        tVal = *this_val + (-sub_value);
-        return tVal;
-    }
-    // else:  Positive && Positive (process normally)
-    //        e.g. 5-3  
-
-    tVal = sub_value;
-    tVal._flags = this_val->_flags;
-
-    // Set up the Pointers
-    p_tVal = (((unsigned char*) tVal._first_byte) + tVal._num_bytes - 1);
-    p_this = (((unsigned char*) this_val->_first_byte) + this_val->_num_bytes - 1);
-
-    // Step 1:  Perform a 1's compliment of the subtrahend
-    ONES_COMPLEMENT(tVal);
-
-    result = 0;
-    //
-    // Step 2:  Add the Subtrahend to the Menuend
-    while ((void*)p_this >= (void*)this_val->_first_byte 
-        && (void*)p_tVal >= (void*)tVal._first_byte) 
-    {
-        result += (long)*p_this + (long)*p_tVal;
-
-        *p_tVal = (unsigned char)(result & UCHAR_MAX);
-        if (result > UCHAR_MAX) {
-            result >>= sizeof(unsigned char) * 8;
-        }
-        else {
-            result = 0;
-        }
-        p_tVal--;
-        p_this--;
-    }
+    bigbigint tVal(*this_val);
 
-    //
-    // Step 3:  Handle the Carry
-    //
-    //     3a: If we have no carry: do a 1's compliment && flip the NEG flag
-    //     3b: If we have do have one: add it to the result.
-    if (result <= 0) {
-        ONES_COMPLEMENT(tVal);
-
-        if(IS_NEGATIVE(tVal._flags)) {
-            tVal._flags &= ~BBI_NEGATIVE;
-        }
-        else {
-            tVal._flags |= BBI_NEGATIVE;
-        }
-    }
-    else {
-
-        // Re-Set up the tVal Pointer
-        p_tVal = (((unsigned char*) tVal._first_byte) + tVal._num_bytes - 1);
+    tVal._add_scalar(Subtrahend, sub_size, is_signed, true);
+    return tVal;
+}
 
-        // And add the remainder to the final number
-        while ((void*)p_tVal >= (void*)tVal._first_byte) 
-        {
-            result += (long)*p_tVal;
+//
+//  <type> - bigbigint  ==  -(bigbigint - <type>)
+bigbigint bigbigint::_perform_integral_subtraction_from(
+        void *Minuend,
+        unsigned long min_size,
+        bool is_signed,
+        bigbigint *Subtrahend)
+{
+    bigbigint tVal(*Subtrahend);
 
-            *p_tVal = (unsigned char)(result & UCHAR_MAX);
-            if (result <= UCHAR_MAX) {
-                break;
-            }
-            result >>= sizeof(unsigned char) * 8;
-            p_tVal--;
-        }
+    tVal._add_scalar(Minuend, min_size, is_signed, true);
+    if (tVal._size() != 0) {
+        tVal._flags ^= BBI_NEGATIVE;
     }
     return tVal;
 }
@@ -989,9 +3702,9 @@ bigbigint bigbigint::operator -(double Subtrahend)
 #define SUBTRACT_OPERATOR_NON_MEMBER_FUNCTION(__type,__is_signed)    \
     bigbigint operator -(const __type &SubVal, bigbigint &Subtrahend)    \
     {                                               \
-        return bigbigint::_perform_integral_subtraction(        \
-                &Subtrahend, (void*)&SubVal, sizeof(SubVal),    \
-                __is_signed);                                   \
+        return bigbigint::_perform_integral_subtraction_from(   \
+                (void*)&SubVal, sizeof(SubVal), __is_signed,    \
+                &Subtrahend);                                   \
     }
 
 
@@ -1008,15 +3721,15 @@ bigbigint operator -(const float &SubVal, bigbigint &Subtrahend)
 {
     D_LONG tmp_val;
     tmp_val = (D_LONG)SubVal;
-    return bigbigint::_perform_integral_subtraction(
-            &Subtrahend, (void*)&tmp_val, sizeof(tmp_val), true);
+    return bigbigint::_perform_integral_subtraction_from(
+            (void*)&tmp_val, sizeof(tmp_val), true, &Subtrahend);
 }
 bigbigint operator -(const double &SubVal, bigbigint &Subtrahend)
 {
     D_LONG tmp_val;
     tmp_val = (D_LONG)SubVal;
-    return bigbigint::_perform_integral_subtraction(
-            &Subtrahend, (void*)&tmp_val, sizeof(tmp_val), true);
+    return bigbigint::_perform_integral_subtraction_from(
+            (void*)&tmp_val, sizeof(tmp_val), true, &Subtrahend);
 }
 
 
@@ -1025,22 +3738,45 @@ bigbigint operator -(const double &SubVal, bigbigint &Subtrahend)
 // Function Set:  Operator -= Overloading
 // ------------------------------------------
 
-#define MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(__type)    \
-bigbigint bigbigint::operator -=(__type SubVal)              \
+bigbigint &bigbigint::operator -=(const bigbigint &SubVal)
+{
+    this->_add_signed(SubVal, true);
+    return *this;
+}
+
+#define MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(__type, __is_signed)    \
+bigbigint &bigbigint::operator -=(__type SubVal)              \
 {                                                       \
-    *this = *this - SubVal;                             \
+    this->_add_scalar((void*)&SubVal, sizeof(SubVal), __is_signed, true); \
     return *this;       \
 }
 
-MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(bigbigint);
-MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(int);
-MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(unsigned int);
-MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(long);
-MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(unsigned long);
-MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(short);
-MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(unsigned short);
-MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(char);
-MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(unsigned char);
+MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(int, true);
+MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(unsigned int, false);
+MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(long, true);
+MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(unsigned long, false);
+MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(short, true);
+MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(unsigned short, false);
+MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(char, true);
+MINUS_EQUAL_OPERATOR_MEMBER_FUNCTION(unsigned char, false);
+
+bigbigint &bigbigint::operator -=(float Subtrahend)
+{
+    D_LONG tmp_val;
+    tmp_val = (D_LONG)Subtrahend;
+
+    this->_add_scalar((void*)&tmp_val, sizeof(tmp_val), true, true);
+    return *this;
+}
+
+bigbigint &bigbigint::operator -=(double Subtrahend)
+{
+    D_LONG tmp_val;
+    tmp_val = (D_LONG)Subtrahend;
+
+    this->_add_scalar((void*)&tmp_val, sizeof(tmp_val), true, true);
+    return *this;
+}
 
 
 //
@@ -1068,211 +3804,57 @@ MINUS_EQ_OPERATOR_NON_MEMBER_FUNCTION(double);
 // ------------------------------------------
 // Function Set:  Operator --/++ Overloading
 // ------------------------------------------
-bigbigint bigbigint::operator --(void)   //Prefix
+//
+//  Both work in place (see _step).  The postfix versions hand back
+//  the value from before the step, so they have to make one copy;
+//  use the prefix versions in loops.
+bigbigint &bigbigint::operator --(void)   //Prefix
 {
-    *this = *this - 1;
+    this->_step(true);
     return *this;
 }
 
-bigbigint bigbigint::operator ++(void)   
+bigbigint &bigbigint::operator ++(void)   
 {
-    *this = *this + 1;
+    this->_step(false);
     return *this;
 }
 
 bigbigint bigbigint::operator --(int)   //Postfix
 {
-    *this = *this - 1;
-    return *this;
+    bigbigint tVal(*this);
+    this->_step(true);
+    return tVal;
 }
 
 bigbigint bigbigint::operator ++(int)   
 {
-    *this = *this + 1;
-    return *this;
+    bigbigint tVal(*this);
+    this->_step(false);
+    return tVal;
 }
 
 
 // ------------------------------------------
 // Function Set:  Operator * Overloading
 // ------------------------------------------
-
 //
 //  Multiplication algorithm
-//  
-//  Note (to self): I am considering upgrading this to the
-//  Toom-Cook divide-and-conquer algorithm.  This will 
-//  increase the speed of multiplication for larger numbers 
-//  (e.g. 50+ bytes each).  However, it will decrease the
-//  speed for smaller numbers (int/double/etc.).  Still, 
-//  it would be benefitial to pursue this in future releases.
-//                  e.g.
-//      if( this->length >= MIN_TOOM_LEN &&
-//          that->length >= MIN_TOOM_LEN) 
-//              return this->toom_multiple(that);
-//
-bigbigint bigbigint::operator *(const bigbigint &multiplier)
-{
-    bigbigint tVal(this->_length + multiplier._length);
-    //bigbigint tmp_val(this->_length + multiplier._length);
-    unsigned D_LONG result;
-    BBI_BASE_TYPE *p_this, *p_mult, *p_tval;
-    BBI_BASE_TYPE *p_this_lim, *p_mult_lim;
-    BBI_BASE_TYPE byte_1, byte_2;
-    int i;
-    unsigned long this_length;
-
-    tVal = 0;
-    //
-    //  Set up the pointers.
-    //  Make p_this point to the larger of the two numbers
-    if( this->_length >= multiplier._length) {
-        p_this = ((BBI_BASE_TYPE*)this->_first_byte) + (this->_length-1);
-        p_this_lim = ((BBI_BASE_TYPE*)this->_first_byte);
-        p_mult = ((BBI_BASE_TYPE*)multiplier._first_byte) + (multiplier._length - 1);
-        p_mult_lim = ((BBI_BASE_TYPE*)multiplier._first_byte);
-        this_length = this->_length;
-    }
-    else {
-        p_mult = ((BBI_BASE_TYPE*)this->_first_byte) + (this->_length-1);
-        p_mult_lim = ((BBI_BASE_TYPE*)this->_first_byte);
-        p_this = ((BBI_BASE_TYPE*)multiplier._first_byte) + (multiplier._length - 1);
-        p_this_lim = ((BBI_BASE_TYPE*)multiplier._first_byte);
-        this_length = multiplier._length;
-    }
-
-    i = 1;
-    while(p_mult >= p_mult_lim) {
-
-        p_tval = ((BBI_BASE_TYPE*)tVal._first_byte) + (tVal._length - i);
-        p_this = p_this_lim + (this_length - 1);
-        result = 0;
-        while (p_this >= p_this_lim) {
-            byte_1 = *p_mult;
-            REVERSE_BYTE_ORDER(byte_1);
-            byte_2 = *p_this;
-            REVERSE_BYTE_ORDER(byte_2);
-
-            result += (D_LONG)(byte_1) * (D_LONG)(byte_2);
-            result += *p_tval;
-            *p_tval = (BBI_BASE_TYPE)(result & BBI_BASE_MAX);
-            result >>= (8 * sizeof(BBI_BASE_TYPE));
-
-            p_tval--;
-            p_this--;
-        }
-        p_mult--;
-        i++;
-    }
-    
-    if((IS_NEGATIVE(this->_flags) && !IS_NEGATIVE(multiplier._flags)) ||
-        (!IS_NEGATIVE(this->_flags) && IS_NEGATIVE(multiplier._flags))) 
-    {
-        tVal._flags |= BBI_NEGATIVE;
-    }
-
-    return tVal;
-}
-
-
-bigbigint bigbigint::_perform_integral_multiplication(
-        bigbigint * multiplicand,
-        void *multiplier, 
-        unsigned long mult_size,
-        bool is_signed)
-{
-    bigbigint tVal(multiplicand->_length + 1);
-
-    unsigned D_LONG result;
-    D_LONG mul_value;
-    BBI_BASE_TYPE *p_this, *p_mult, *p_tval;
-    BBI_BASE_TYPE *p_this_lim, *p_mult_lim;
-    BBI_BASE_TYPE byte_1, byte_2;
-    int i;
-    unsigned long this_length;
-    unsigned char save_flags;
-
-    tVal = 0;
-    //
-    // First off, we need to take the data and shove it into
-    // a format we can read.  For this purpose, we just stick
-    // everything in an __int64/double long so that the
-    // machine can read it as it was meant to be.
-#if defined(MEM_ARCH_USES_BIG_ENDIAN) 
-    if((char*)multiplier >= 0 || is_signed == false)  
-#else
-    if((*((char*)multiplier + (mult_size-1)) >= 0) || is_signed == false)
-#endif
-    {
-        mul_value = 0;
-        #if defined(MEM_ARCH_USES_BIG_ENDIAN) 
-            memcpy((char*)mul_value + (sizeof(mul_value) - mult_size)),
-                multiplier, mult_size);
-        #else
-            memcpy(&mul_value, multiplier, mult_size);
-        #endif
-        if(IS_NEGATIVE(multiplicand->_flags)) {
-            tVal._flags |= BBI_NEGATIVE;
-        }
-    }
-    else
-    {
-        mul_value = -1;
-        #if defined(MEM_ARCH_USES_BIG_ENDIAN) 
-            memcpy((char*)mul_value + (sizeof(mul_value) - mult_size)),
-                multiplier, mult_size);
-        #else
-            memcpy(&mul_value, multiplier, mult_size);
-        #endif
-        if(!IS_NEGATIVE(multiplicand->_flags)) {
-            tVal._flags |= BBI_NEGATIVE;
-        }
-        mul_value = 0-mul_value;
-    }
-
-    // Just a bit of a performance enhancement.
-    if(mul_value == 1) { 
-        save_flags = tVal._flags;
-        tVal = *multiplicand;
-        tVal._flags = save_flags;
-        return tVal;
-    }
-    if(mul_value == 0) {
-        return tVal;
-    }
-
-    //
-    //  Set up the pointers.
-    p_this = ((BBI_BASE_TYPE*)multiplicand->_first_byte) + (multiplicand->_length-1);
-    p_this_lim = ((BBI_BASE_TYPE*)multiplicand->_first_byte);
-    this_length = multiplicand->_length;
-    p_mult = ((BBI_BASE_TYPE*)&mul_value) + (sizeof(mul_value) - 1);
-    p_mult_lim = ((BBI_BASE_TYPE*)&mul_value);
-
-    i = 1;
-    while(p_mult >= p_mult_lim) {
-
-        p_tval = ((BBI_BASE_TYPE*)tVal._first_byte) + (tVal._length - i);
-        p_this = p_this_lim + (this_length - 1);
-        result = 0;
-        while (p_this >= p_this_lim) {
-            byte_1 = *p_mult;
-            REVERSE_BYTE_ORDER(byte_1);
-            byte_2 = *p_this;
-            REVERSE_BYTE_ORDER(byte_2);
-
-            result += (D_LONG)(byte_1) * (D_LONG)(byte_2);
-            result += *p_tval;
-            *p_tval = (BBI_BASE_TYPE)(result & BBI_BASE_MAX);
-            result >>= (8 * sizeof(BBI_BASE_TYPE));
-
-            p_tval--;
-            p_this--;
-        }
-        p_mult--;
-        i++;
-    }
+//
+//  bigbigint * bigbigint is an expression template (see
+//  BigBigIntExpr.h, _assign_product above and bbi_mul in 
+//  BigBigIntMpn.cpp).  Multiplying by a native type is a single 
+//  bbi_mul_1 pass, since every native type fits in one limb.
+//
+bigbigint bigbigint::_perform_integral_multiplication(
+        bigbigint * multiplicand,
+        void *multiplier, 
+        unsigned long mult_size,
+        bool is_signed)
+{
+    bigbigint tVal(*multiplicand);
 
+    tVal._mul_scalar(multiplier, mult_size, is_signed);
     return tVal;
 }
 
@@ -1360,24 +3942,51 @@ bigbigint operator *(double Multiplier, bigbigint &ValB)
 // ------------------------------------------
 // Function Set:  Operator *= Overloading
 // ------------------------------------------
-#define MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(__type)    \
-    bigbigint bigbigint::operator *=(__type PlusVal) \
+//
+//  Multiplying by a native type is one in-place bbi_mul_1 pass.
+//  Multiplying by a bigbigint goes through the reused scratch
+//  buffer in _mul_signed.
+bigbigint &bigbigint::operator *=(const bigbigint &Multiplier)
+{
+    this->_mul_signed(Multiplier);
+    return *this;
+}
+
+#define MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(__type, __is_signed)    \
+    bigbigint &bigbigint::operator *=(__type Multiplier) \
     {                   \
-        *this = *this + PlusVal; \
+        this->_mul_scalar((void*)&Multiplier, sizeof(Multiplier), __is_signed); \
         return *this;           \
     }
 
-MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(bigbigint);
-MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(int);
-MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(unsigned int);
-MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(long);
-MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(unsigned long);
-MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(short);
-MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(unsigned short);
-MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(char);
-MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char);
-MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(float);
-MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(double);
+MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(int, true);
+MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(unsigned int, false);
+MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(long, true);
+MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(unsigned long, false);
+MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(short, true);
+MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(unsigned short, false);
+MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(char, true);
+MULTIPLY_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char, false);
+
+bigbigint &bigbigint::operator *=(float Multiplier)
+{
+    //@RLA - Same problem as operator *(float)
+    D_LONG tmp_val;
+    tmp_val = (D_LONG)Multiplier;
+
+    this->_mul_scalar((void*)&tmp_val, sizeof(tmp_val), true);
+    return *this;
+}
+
+bigbigint &bigbigint::operator *=(double Multiplier)
+{
+    //@RLA - Same problem as operator *(double)
+    D_LONG tmp_val;
+    tmp_val = (D_LONG)Multiplier;
+
+    this->_mul_scalar((void*)&tmp_val, sizeof(tmp_val), true);
+    return *this;
+}
 
 //
 //  The *= for non-member functions
@@ -1406,117 +4015,79 @@ MULTIPLY_EQ_OPERATOR_NON_MEMBER_FUNCTION(double);
 // Function Set:  Operator / Overloading
 // ------------------------------------------
 
-//
-//  Note: If we can use shift operators to perform the division
 //
 //  Note: we pass back the quotient and remainder
 //  so that we can use this function for both the divide and mod 
 //  functionality (since it performs both functions).
+//
+//  Note: the long division works on the magnitudes.  The quotient
+//  is negative when the signs differ and the remainder takes the
+//  sign of the dividend (the same as C's / and %).
+//
+//  Note: quotient and remainder must not be dividend or divisor.
 void bigbigint::_perform_integral_division(
-        bigbigint dividend,
-        bigbigint divisor,
+        const bigbigint &dividend,
+        const bigbigint &divisor,
         bigbigint *quotient,
         bigbigint *remainder )
 {
-    unsigned int next_bit;
-    bigbigint sub_val;
-    unsigned D_LONG num_bytes, num_bits;
+    BBI_BASE_TYPE *scratch;
+    unsigned long dividend_size, divisor_size;
+    unsigned char quot_flags, rem_flags;
+    int cmp;
+
+    quot_flags = (dividend._flags ^ divisor._flags) & BBI_NEGATIVE;
+    rem_flags = dividend._flags & BBI_NEGATIVE;
+    dividend_size = dividend._size();
+    divisor_size = divisor._size();
+    BBI_STAT_OP(BBI_STAT_DIV, dividend_size + divisor_size);
+    BBI_TRACE(BBI_STAT_DIV, dividend_size + divisor_size);
 
     *remainder = 0;
     *quotient = 0;
 
     // These are some basic catches to make sure we don't
     // start bit-stomping unless we have to.
-    if (divisor == 0)
+    if (divisor_size == 0)
     {
         exit(199);  // @RLA - Do we want to exit or allow it to continue running?
         return;
     }
 
-    if (divisor > dividend) 
+    cmp = bbi_cmp(divisor._limbs, divisor_size, dividend._limbs, dividend_size);
+    if (cmp > 0) 
     {
         *remainder = dividend;
         return;
     }
 
-    if (divisor == dividend) 
+    if (cmp == 0) 
     {
         *quotient = 1;
+        quotient->_flags = quot_flags;
         return;
     }
 
-    if (dividend == 1) 
+    if (divisor_size == 1 && divisor._limbs[0] == 1) 
     {
         *quotient = dividend;
+        quotient->_flags = quot_flags;
         return;
     }
 
-    // need this to keep us from walking off the end of the heap
-    if (dividend == 0)
-    {
-        return;
-    }
-
-    //
-    // Quick little loop up top to shift off all the zeroes
-    // from our dividend so that we can start making meaningful
-    // evaluations.
-    num_bytes = 0;
-    num_bits = 0;
+    // The long division itself is bbi_divrem (Knuth's Algorithm D,
+    // a whole limb of quotient per step).
+    quotient->_reserve(dividend_size - divisor_size + 1);
+    remainder->_reserve(divisor_size);
 
-    next_bit = *(dividend._first_byte) & 0x80;
-    while (next_bit == 0) {
-        // find the next bit.
-        dividend = dividend << 1;
-        next_bit = *(dividend._first_byte) & 0x80;
-
-        // Count the number of bits/bytes we've shifted off so far
-        num_bits++;
-        if(num_bits == 8){
-            num_bits = 0;
-            num_bytes++;
-        }
-    }
-
-    // Subtract out the divisors from the dividend
-    while(num_bytes < dividend._num_bytes) {
-        // Get the next bit to subtract, adding the bit to the remainder
-        next_bit = (*(dividend._first_byte) & 0x80) >> 8;
-        *remainder <<= 1;
-        *remainder |= next_bit;
-
-        // try subtracting the divisor from current value (*remainder)
-        sub_val = *remainder - divisor;
-
-        // bump these so we can process the next bit
-        dividend <<= 1;
-        *quotient <<= 1;
-
-        // was there enough of a remainder to count as a divisor?
-        if( sub_val < 0 ) 
-        {
-            // Yes. Subtraction resulted in a positive value.  
-            // Add a bit to our quotient and save the subtraction
-            // value as our current remainder
-            *quotient |= 1;
-            *remainder = sub_val;
-        }
-
-        // while we're here, go ahead and make sure the quotient has
-        // enough bytes in it
-        next_bit = (*(quotient->_first_byte) & 0x80);
-        if(next_bit != 0) {
-            quotient->_upsize(quotient->_length+1);
-        }
-
-        // maintain the bit/byte counters.
-        num_bits++;
-        if(num_bits == 8) {
-            num_bits = 0;
-            num_bytes++;
-        }
-    }
+    bbi_tmp_scope tmp;
+    scratch = tmp.alloc(BBI_DIVREM_SCRATCH(dividend_size, divisor_size));
+    bbi_divrem(quotient->_limbs, remainder->_limbs, 
+               dividend._limbs, dividend_size, 
+               divisor._limbs, divisor_size, scratch);
 
+    quotient->_flags = (quotient->_size() != 0 ? quot_flags : 0);
+    remainder->_flags = (remainder->_size() != 0 ? rem_flags : 0);
     return;
 }  
 
@@ -1528,199 +4099,313 @@ bigbigint bigbigint::operator /(bigbigint divisor)
     return tQuot;
 }
 
-#define BBI_DIVISION_SHIFT_SHORTCUT(__var)  \
-    switch (__var)  \
-    {   \
-        case 2: return (*this>>1);  \
-        case 4: return (*this>>2);  \
-        case 8: return (*this>>3);  \
-        case 16: return(*this>>4);  \
-        case 32: return(*this>>5);  \
-        case 64: return(*this>>6);  \
-        case 128: return(*this>>7); \
-        case 256: return(*this>>8); \
-        case 512: return(*this>>9); \
-        case 1024: return(*this>>10);\
-        case 2048: return(*this>>11);\
-        case 4096: return(*this>>12);\
-        default: break;             \
-    }
-
-#define DIVIDE_OPERATOR_MEMBER_FUNCTION(__type) \
+//
+//  A native divisor fits in one limb, so this is a single
+//  bbi_divrem_1 pass (see _div_scalar).
+#define DIVIDE_OPERATOR_MEMBER_FUNCTION(__type, __is_signed) \
 bigbigint bigbigint::operator /(__type divisor) \
 {                                               \
-    BBI_DIVISION_SHIFT_SHORTCUT(divisor);       \
-    bigbigint tVal(this->_length);              \
-    tVal = divisor;                             \
-    return (*this / tVal);                      \
+    bigbigint tVal(*this);                      \
+    tVal._div_scalar((void*)&divisor, sizeof(divisor), __is_signed); \
+    return tVal;                                \
 }
 
 
-DIVIDE_OPERATOR_MEMBER_FUNCTION(int)
-DIVIDE_OPERATOR_MEMBER_FUNCTION(unsigned int);
-DIVIDE_OPERATOR_MEMBER_FUNCTION(long)
-DIVIDE_OPERATOR_MEMBER_FUNCTION(unsigned long);
-DIVIDE_OPERATOR_MEMBER_FUNCTION(short)
-DIVIDE_OPERATOR_MEMBER_FUNCTION(unsigned short);
-DIVIDE_OPERATOR_MEMBER_FUNCTION(char)
-DIVIDE_OPERATOR_MEMBER_FUNCTION(unsigned char);
+DIVIDE_OPERATOR_MEMBER_FUNCTION(int, true)
+DIVIDE_OPERATOR_MEMBER_FUNCTION(unsigned int, false)
+DIVIDE_OPERATOR_MEMBER_FUNCTION(long, true)
+DIVIDE_OPERATOR_MEMBER_FUNCTION(unsigned long, false)
+DIVIDE_OPERATOR_MEMBER_FUNCTION(short, true)
+DIVIDE_OPERATOR_MEMBER_FUNCTION(unsigned short, false)
+DIVIDE_OPERATOR_MEMBER_FUNCTION(char, true)
+DIVIDE_OPERATOR_MEMBER_FUNCTION(unsigned char, false)
 
 bigbigint bigbigint::operator /(float divisor) 
 {
     //@RLA - This is very, very incorrect
     //  (0.25 * 100 = 25... not 0)
-    long dl_divisor;
-    dl_divisor = (long)divisor;
+    D_LONG dl_divisor;
+    bigbigint tVal(*this);
 
-    BBI_DIVISION_SHIFT_SHORTCUT(dl_divisor);
-    bigbigint tVal(this->_length);
-    tVal = divisor;
-    return (*this / tVal);
+    dl_divisor = (D_LONG)divisor;
+    tVal._div_scalar((void*)&dl_divisor, sizeof(dl_divisor), true);
+    return tVal;
 }
 
 bigbigint bigbigint::operator /(double divisor) 
 {
     //@RLA - This is very, very incorrect
     //  (0.25 * 100 = 25... not 0)
-    long dl_divisor;
-    dl_divisor = (long)divisor;
+    D_LONG dl_divisor;
+    bigbigint tVal(*this);
+
+    dl_divisor = (D_LONG)divisor;
+    tVal._div_scalar((void*)&dl_divisor, sizeof(dl_divisor), true);
+    return tVal;
+}
+
+//
+//  <type> / bigbigint
+//
+//  The quotient is only non-zero when the divisor fits in a single
+//  limb, in which case it's a plain native divide.
+bigbigint bigbigint::_perform_native_division(
+        void *dividend,
+        unsigned long div_size,
+        bool is_signed,
+        const bigbigint *divisor)
+{
+    bigbigint tVal;
+    BBI_BASE_TYPE magnitude;
+    bool negative;
+    unsigned long divisor_size;
+
+    negative = bbi_load_scalar(dividend, div_size, is_signed, &magnitude);
+    divisor_size = divisor->_size();
+    BBI_STAT_OP(BBI_STAT_DIV_SCALAR, divisor_size);
+    if (divisor_size == 0) {
+        exit(199);  // @RLA - Same as _perform_integral_division
+    }
 
-    BBI_DIVISION_SHIFT_SHORTCUT(dl_divisor);
-    bigbigint tVal(this->_length);
-    tVal = divisor;
-    return (*this / tVal);
+    if (divisor_size == 1 && divisor->_limbs[0] <= magnitude) {
+        tVal._limbs[0] = magnitude / divisor->_limbs[0];
+        if (negative != (IS_NEGATIVE(divisor->_flags) != 0)) {
+            tVal._flags |= BBI_NEGATIVE;
+        }
+    }
+    return tVal;
 }
 
-#define DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(__type) \
+#define DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(__type, __load_type, __is_signed) \
 bigbigint operator /(__type &dividend, bigbigint &divisor) \
 {                                               \
-    bigbigint tVal(divisor.length());           \
-    tVal = dividend;                            \
-    tVal = tVal / divisor;      \
-    return tVal;                \
+    __load_type tmp_val;                        \
+    tmp_val = (__load_type)dividend;            \
+    return bigbigint::_perform_native_division( \
+                (void*)&tmp_val, sizeof(tmp_val), __is_signed, &divisor); \
 }
 
 
-DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(int)
-DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(unsigned int);
-DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(long)
-DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(unsigned long);
-DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(short)
-DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(unsigned short);
-DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(char)
-DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(unsigned char);
-DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(float)
-DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(double)
+DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(int, int, true)
+DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(unsigned int, unsigned int, false)
+DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(long, long, true)
+DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(unsigned long, unsigned long, false)
+DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(short, short, true)
+DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(unsigned short, unsigned short, false)
+DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(char, char, true)
+DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(unsigned char, unsigned char, false)
+DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(float, D_LONG, true)
+DIVIDE_OPERATOR_NON_MEMBER_FUNCTION(double, D_LONG, true)
 
 // ------------------------------------------
 // Function Set:  Operator /= Overloading
 // ------------------------------------------
-#define DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(__type) \
-bigbigint bigbigint::operator /=(__type divisor) \
+bigbigint &bigbigint::operator /=(const bigbigint &divisor)
+{
+    bigbigint tQuot, tRem;
+    _perform_integral_division(*this, divisor, &tQuot, &tRem);
+    this->_swap(tQuot);
+    return (*this);
+}
+
+#define DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(__type, __load_type, __is_signed) \
+bigbigint &bigbigint::operator /=(__type divisor) \
 {                                               \
-    *this = *this / divisor;        \
+    __load_type tmp_val;                        \
+    tmp_val = (__load_type)divisor;             \
+    this->_div_scalar((void*)&tmp_val, sizeof(tmp_val), __is_signed); \
     return (*this);                 \
 }
 
 
-DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(bigbigint)
-DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(int)
-DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(unsigned int);
-DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(long)
-DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(unsigned long);
-DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(short)
-DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(unsigned short);
-DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(char)
-DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char);
-DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(float)
-DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(double)
+DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(int, int, true)
+DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(unsigned int, unsigned int, false)
+DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(long, long, true)
+DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(unsigned long, unsigned long, false)
+DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(short, short, true)
+DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(unsigned short, unsigned short, false)
+DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(char, char, true)
+DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char, unsigned char, false)
+DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(float, D_LONG, true)
+DIVIDE_EQ_OPERATOR_MEMBER_FUNCTION(double, D_LONG, true)
 
 
 #define DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(__type) \
 __type operator /=(__type &dividend, bigbigint &divisor) \
 {                                               \
-    bigbigint tVal(divisor.length());           \
-    tVal = dividend;                            \
-    tVal = tVal / divisor;      \
-    dividend = (__type)tVal;    \
+    dividend = (__type)(dividend / divisor);    \
     return dividend;             \
 }
 
 
 DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(int)
-DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(unsigned int);
+DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(unsigned int)
 DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(long)
-DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(unsigned long);
+DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(unsigned long)
 DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(short)
-DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(unsigned short);
+DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(unsigned short)
 DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(char)
-DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(unsigned char);
+DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(unsigned char)
 DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(float)
 DIVIDE_EQ_OPERATOR_NON_MEMBER_FUNCTION(double)
 
 
 // ------------------------------------------
-// Function Set:  Operator > Overloading
+// Function Set:  Operator % Overloading
 // ------------------------------------------
-bool bigbigint::operator >(bigbigint CompVal)
+//
+//  The remainder takes the sign of the dividend (the same as C).
+//
+bigbigint bigbigint::operator %(const bigbigint &divisor)
+{
+    bigbigint tQuot, tRem;
+    _perform_integral_division(*this, divisor, &tQuot, &tRem);
+    return tRem;
+}
+
+#define MODULO_OPERATOR_MEMBER_FUNCTION(__type, __load_type, __is_signed) \
+bigbigint bigbigint::operator %(__type divisor)  \
+{                                               \
+    bigbigint tVal;                             \
+    __load_type tmp_val;                        \
+    tmp_val = (__load_type)divisor;             \
+    tVal._limbs[0] = this->_mod_scalar((void*)&tmp_val, sizeof(tmp_val), __is_signed); \
+    if (tVal._limbs[0] != 0) {                  \
+        tVal._flags = this->_flags;             \
+    }                                           \
+    return tVal;                                \
+}
+
+
+MODULO_OPERATOR_MEMBER_FUNCTION(int, int, true)
+MODULO_OPERATOR_MEMBER_FUNCTION(unsigned int, unsigned int, false)
+MODULO_OPERATOR_MEMBER_FUNCTION(long, long, true)
+MODULO_OPERATOR_MEMBER_FUNCTION(unsigned long, unsigned long, false)
+MODULO_OPERATOR_MEMBER_FUNCTION(short, short, true)
+MODULO_OPERATOR_MEMBER_FUNCTION(unsigned short, unsigned short, false)
+MODULO_OPERATOR_MEMBER_FUNCTION(char, char, true)
+MODULO_OPERATOR_MEMBER_FUNCTION(unsigned char, unsigned char, false)
+MODULO_OPERATOR_MEMBER_FUNCTION(float, D_LONG, true)
+MODULO_OPERATOR_MEMBER_FUNCTION(double, D_LONG, true)
+
+
+// ------------------------------------------
+// Function Set:  Operator %= Overloading
+// ------------------------------------------
+bigbigint &bigbigint::operator %=(const bigbigint &divisor)
+{
+    bigbigint tQuot, tRem;
+    _perform_integral_division(*this, divisor, &tQuot, &tRem);
+    this->_swap(tRem);
+    return (*this);
+}
+
+#define MODULO_EQ_OPERATOR_MEMBER_FUNCTION(__type, __load_type, __is_signed) \
+bigbigint &bigbigint::operator %=(__type divisor) \
+{                                               \
+    BBI_BASE_TYPE rem;                          \
+    __load_type tmp_val;                        \
+    tmp_val = (__load_type)divisor;             \
+    rem = this->_mod_scalar((void*)&tmp_val, sizeof(tmp_val), __is_signed); \
+    this->zero_fill();                          \
+    this->_limbs[0] = rem;                      \
+    if (rem == 0) {                             \
+        this->_flags = 0;                       \
+    }                                           \
+    return (*this);                             \
+}
+
+
+MODULO_EQ_OPERATOR_MEMBER_FUNCTION(int, int, true)
+MODULO_EQ_OPERATOR_MEMBER_FUNCTION(unsigned int, unsigned int, false)
+MODULO_EQ_OPERATOR_MEMBER_FUNCTION(long, long, true)
+MODULO_EQ_OPERATOR_MEMBER_FUNCTION(unsigned long, unsigned long, false)
+MODULO_EQ_OPERATOR_MEMBER_FUNCTION(short, short, true)
+MODULO_EQ_OPERATOR_MEMBER_FUNCTION(unsigned short, unsigned short, false)
+MODULO_EQ_OPERATOR_MEMBER_FUNCTION(char, char, true)
+MODULO_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char, unsigned char, false)
+MODULO_EQ_OPERATOR_MEMBER_FUNCTION(float, D_LONG, true)
+MODULO_EQ_OPERATOR_MEMBER_FUNCTION(double, D_LONG, true)
+
+
+// ------------------------------------------
+// Function Set:  Comparison
+// ------------------------------------------
+//
+//  Every comparison operator comes down to compare() (or
+//  _compare_scalar for the native types).  Neither one allocates:
+//  the signs are checked first, then the used limb counts, and only
+//  then are the limbs scanned from the top down.
+//
+//  Note: float and double are truncated to an integer first, the
+//  same as assigning them.
+//
+
+//
+//  Returns -1, 0 or 1 as *this is less than, equal to or greater
+//  than CompVal.
+int bigbigint::compare(const bigbigint &CompVal) const
+{
+    return bigbigint_view(*this).compare(CompVal);
+}
+
+//
+//  Same as compare(), against a native integer
+int bigbigint::_compare_scalar(const void *value, unsigned long size, bool is_signed) const
 {
+    BBI_BASE_TYPE magnitude;
+    bool this_negative, comp_negative;
     int comp_result;
-    if(CompVal._length > this->_length) 
-    {
-        bigbigint tVal(CompVal._length);
-        tVal = *this;
-        comp_result = memcmp(tVal._first_byte, CompVal._first_byte, CompVal._num_bytes);
-    }
-    else if(this->_length > CompVal._length) 
-    {
-        bigbigint tVal(this->_length);
-        tVal = CompVal;
-        comp_result = memcmp(this->_first_byte, tVal._first_byte, tVal._num_bytes);
-    }
-    else
-    {
-        comp_result = memcmp(this->_first_byte, CompVal._first_byte, CompVal._num_bytes);
+
+    this_negative = (IS_NEGATIVE(this->_flags) != 0);
+    comp_negative = bbi_load_scalar(value, size, is_signed, &magnitude);
+    if (this_negative != comp_negative) {
+        return (this_negative ? -1 : 1);
     }
 
-	return (comp_result > 0 ? true : false);
+    comp_result = bbi_cmp_1(this->_limbs, this->_length, magnitude);
+    return (this_negative ? -comp_result : comp_result);
+}
+
+
+// ------------------------------------------
+// Function Set:  Operator > Overloading
+// ------------------------------------------
+bool bigbigint::operator >(const bigbigint &CompVal) const
+{
+	return (this->compare(CompVal) > 0);
 }
 
 
-#define GREATER_THAN_OPERATOR_MEMBER_FUNCTION(__type)   \
-bool bigbigint::operator >(__type CompVal)              \
+#define GREATER_THAN_OPERATOR_MEMBER_FUNCTION(__type, __load_type, __is_signed)   \
+bool bigbigint::operator >(__type CompVal) const        \
 {                                                       \
-    int comp_result;                                    \
-    if( CompVal < 0 && !IS_NEGATIVE(this->_flags)) {    \
-        return true;        \
-    }                                                   \
-    {                                                   \
-        bigbigint tVal(this->_length);                      \
-        tVal = CompVal;                                     \
-        comp_result = memcmp(this->_first_byte,             \
-                      tVal._first_byte, tVal._num_bytes);   \
-    }                                                   \
-	return (comp_result > 0 ? true : false);            \
-}
-
-GREATER_THAN_OPERATOR_MEMBER_FUNCTION(int)
-GREATER_THAN_OPERATOR_MEMBER_FUNCTION(unsigned int);
-GREATER_THAN_OPERATOR_MEMBER_FUNCTION(long)
-GREATER_THAN_OPERATOR_MEMBER_FUNCTION(unsigned long);
-GREATER_THAN_OPERATOR_MEMBER_FUNCTION(short)
-GREATER_THAN_OPERATOR_MEMBER_FUNCTION(unsigned short);
-GREATER_THAN_OPERATOR_MEMBER_FUNCTION(char)
-GREATER_THAN_OPERATOR_MEMBER_FUNCTION(unsigned char);
-GREATER_THAN_OPERATOR_MEMBER_FUNCTION(float)
-GREATER_THAN_OPERATOR_MEMBER_FUNCTION(double)
+    __load_type tmp_val;                                \
+    tmp_val = (__load_type)CompVal;                     \
+	return (this->_compare_scalar((void*)&tmp_val,       \
+                sizeof(tmp_val), __is_signed) > 0);     \
+}
 
+GREATER_THAN_OPERATOR_MEMBER_FUNCTION(int, int, true)
+GREATER_THAN_OPERATOR_MEMBER_FUNCTION(unsigned int, unsigned int, false)
+GREATER_THAN_OPERATOR_MEMBER_FUNCTION(long, long, true)
+GREATER_THAN_OPERATOR_MEMBER_FUNCTION(unsigned long, unsigned long, false)
+GREATER_THAN_OPERATOR_MEMBER_FUNCTION(short, short, true)
+GREATER_THAN_OPERATOR_MEMBER_FUNCTION(unsigned short, unsigned short, false)
+GREATER_THAN_OPERATOR_MEMBER_FUNCTION(char, char, true)
+GREATER_THAN_OPERATOR_MEMBER_FUNCTION(unsigned char, unsigned char, false)
+GREATER_THAN_OPERATOR_MEMBER_FUNCTION(float, D_LONG, true)
+GREATER_THAN_OPERATOR_MEMBER_FUNCTION(double, D_LONG, true)
 
+
+//
+//  <type> > bigbigint  ==  bigbigint < <type>
 #define GREATER_THAN_OPERATOR_NON_MEMBER_FUNCTION(__type)   \
-bool operator >(const __type &CompVal, bigbigint &this_value) \
+bool operator >(const __type &CompVal, const bigbigint &this_value) \
 {                                                       \
-	return (this_value <= CompVal);                     \
+	return (this_value < CompVal);                     \
 }
 
-
 GREATER_THAN_OPERATOR_NON_MEMBER_FUNCTION(int);
 GREATER_THAN_OPERATOR_NON_MEMBER_FUNCTION(unsigned int);
 GREATER_THAN_OPERATOR_NON_MEMBER_FUNCTION(long);
@@ -1733,69 +4418,44 @@ GREATER_THAN_OPERATOR_NON_MEMBER_FUNCTION(float);
 GREATER_THAN_OPERATOR_NON_MEMBER_FUNCTION(double);
 
 
-
 // ------------------------------------------
 // Function Set:  Operator >= Overloading
 // ------------------------------------------
-bool bigbigint::operator >=(bigbigint CompVal)
+bool bigbigint::operator >=(const bigbigint &CompVal) const
 {
-    int comp_result;
-    if(CompVal._length > this->_length) 
-    {
-        bigbigint tVal(CompVal._length);
-        tVal = *this;
-        comp_result = memcmp(tVal._first_byte, CompVal._first_byte, CompVal._num_bytes);
-    }
-    else if(this->_length > CompVal._length) 
-    {
-        bigbigint tVal(this->_length);
-        tVal = CompVal;
-        comp_result = memcmp(this->_first_byte, tVal._first_byte, tVal._num_bytes);
-    }
-    else
-    {
-        comp_result = memcmp(this->_first_byte, CompVal._first_byte, CompVal._num_bytes);
-    }
-
-	return (comp_result >= 0 ? true : false);
+	return (this->compare(CompVal) >= 0);
 }
 
 
-#define GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(__type)   \
-bool bigbigint::operator >=(__type CompVal)             \
+#define GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(__type, __load_type, __is_signed)   \
+bool bigbigint::operator >=(__type CompVal) const        \
 {                                                       \
-    int comp_result;                                    \
-    if( CompVal == 0 && !IS_NEGATIVE(this->_flags)) {   \
-        return true;                                    \
-    }                                                   \
-    {                                                   \
-        bigbigint tVal(this->_length);                      \
-        tVal = CompVal;                                     \
-        comp_result = memcmp(this->_first_byte,             \
-                      tVal._first_byte, tVal._num_bytes);   \
-    }                                                   \
-	return (comp_result >= 0 ? true : false);           \
-}
-
-GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(int)
-GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned int);
-GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(long)
-GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned long);
-GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(short)
-GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned short);
-GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(char)
-GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char);
-GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(float)
-GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(double)
+    __load_type tmp_val;                                \
+    tmp_val = (__load_type)CompVal;                     \
+	return (this->_compare_scalar((void*)&tmp_val,       \
+                sizeof(tmp_val), __is_signed) >= 0);     \
+}
 
+GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(int, int, true)
+GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned int, unsigned int, false)
+GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(long, long, true)
+GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned long, unsigned long, false)
+GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(short, short, true)
+GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned short, unsigned short, false)
+GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(char, char, true)
+GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char, unsigned char, false)
+GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(float, D_LONG, true)
+GREATER_THAN_EQ_OPERATOR_MEMBER_FUNCTION(double, D_LONG, true)
 
+
+//
+//  <type> >= bigbigint  ==  bigbigint <= <type>
 #define GREATER_THAN_EQ_OPERATOR_NON_MEMBER_FUNCTION(__type)   \
-bool operator >=(const __type &CompVal, bigbigint &this_value) \
+bool operator >=(const __type &CompVal, const bigbigint &this_value) \
 {                                                       \
-	return (this_value < CompVal);                     \
+	return (this_value <= CompVal);                     \
 }
 
-
 GREATER_THAN_EQ_OPERATOR_NON_MEMBER_FUNCTION(int);
 GREATER_THAN_EQ_OPERATOR_NON_MEMBER_FUNCTION(unsigned int);
 GREATER_THAN_EQ_OPERATOR_NON_MEMBER_FUNCTION(long);
@@ -1808,69 +4468,44 @@ GREATER_THAN_EQ_OPERATOR_NON_MEMBER_FUNCTION(float);
 GREATER_THAN_EQ_OPERATOR_NON_MEMBER_FUNCTION(double);
 
 
-
 // ------------------------------------------
 // Function Set:  Operator < Overloading
 // ------------------------------------------
-bool bigbigint::operator <(bigbigint CompVal)
+bool bigbigint::operator <(const bigbigint &CompVal) const
 {
-    int comp_result;
-    if(CompVal._length > this->_length) 
-    {
-        bigbigint tVal(CompVal._length);
-        tVal = *this;
-        comp_result = memcmp(tVal._first_byte, CompVal._first_byte, CompVal._num_bytes);
-    }
-    else if(this->_length > CompVal._length) 
-    {
-        bigbigint tVal(this->_length);
-        tVal = CompVal;
-        comp_result = memcmp(this->_first_byte, tVal._first_byte, tVal._num_bytes);
-    }
-    else
-    {
-        comp_result = memcmp(this->_first_byte, CompVal._first_byte, CompVal._num_bytes);
-    }
-
-	return (comp_result < 0 ? true : false);
+	return (this->compare(CompVal) < 0);
 }
 
 
-#define LESS_THAN_OPERATOR_MEMBER_FUNCTION(__type)   \
-bool bigbigint::operator <(__type CompVal)              \
+#define LESS_THAN_OPERATOR_MEMBER_FUNCTION(__type, __load_type, __is_signed)   \
+bool bigbigint::operator <(__type CompVal) const        \
 {                                                       \
-    int comp_result;                                    \
-    if( CompVal == 0 ) {                                \
-        return (IS_NEGATIVE(this->_flags) != 0);        \
-    }                                                   \
-    {                                                   \
-        bigbigint tVal(this->_length);                  \
-        tVal = CompVal;                                 \
-        comp_result = memcmp(this->_first_byte,         \
-                      tVal._first_byte, tVal._num_bytes);   \
-    }                                                   \
-	return (comp_result < 0 ? true : false);            \
-}
-
-LESS_THAN_OPERATOR_MEMBER_FUNCTION(int)
-LESS_THAN_OPERATOR_MEMBER_FUNCTION(unsigned int);
-LESS_THAN_OPERATOR_MEMBER_FUNCTION(long)
-LESS_THAN_OPERATOR_MEMBER_FUNCTION(unsigned long);
-LESS_THAN_OPERATOR_MEMBER_FUNCTION(short)
-LESS_THAN_OPERATOR_MEMBER_FUNCTION(unsigned short);
-LESS_THAN_OPERATOR_MEMBER_FUNCTION(char)
-LESS_THAN_OPERATOR_MEMBER_FUNCTION(unsigned char);
-LESS_THAN_OPERATOR_MEMBER_FUNCTION(float)
-LESS_THAN_OPERATOR_MEMBER_FUNCTION(double)
+    __load_type tmp_val;                                \
+    tmp_val = (__load_type)CompVal;                     \
+	return (this->_compare_scalar((void*)&tmp_val,       \
+                sizeof(tmp_val), __is_signed) < 0);     \
+}
 
+LESS_THAN_OPERATOR_MEMBER_FUNCTION(int, int, true)
+LESS_THAN_OPERATOR_MEMBER_FUNCTION(unsigned int, unsigned int, false)
+LESS_THAN_OPERATOR_MEMBER_FUNCTION(long, long, true)
+LESS_THAN_OPERATOR_MEMBER_FUNCTION(unsigned long, unsigned long, false)
+LESS_THAN_OPERATOR_MEMBER_FUNCTION(short, short, true)
+LESS_THAN_OPERATOR_MEMBER_FUNCTION(unsigned short, unsigned short, false)
+LESS_THAN_OPERATOR_MEMBER_FUNCTION(char, char, true)
+LESS_THAN_OPERATOR_MEMBER_FUNCTION(unsigned char, unsigned char, false)
+LESS_THAN_OPERATOR_MEMBER_FUNCTION(float, D_LONG, true)
+LESS_THAN_OPERATOR_MEMBER_FUNCTION(double, D_LONG, true)
 
+
+//
+//  <type> < bigbigint  ==  bigbigint > <type>
 #define LESS_THAN_OPERATOR_NON_MEMBER_FUNCTION(__type)   \
-bool operator <(const __type &CompVal, bigbigint &this_value) \
+bool operator <(const __type &CompVal, const bigbigint &this_value) \
 {                                                       \
-	return (this_value >= CompVal);                     \
+	return (this_value > CompVal);                     \
 }
 
-
 LESS_THAN_OPERATOR_NON_MEMBER_FUNCTION(int);
 LESS_THAN_OPERATOR_NON_MEMBER_FUNCTION(unsigned int);
 LESS_THAN_OPERATOR_NON_MEMBER_FUNCTION(long);
@@ -1883,70 +4518,44 @@ LESS_THAN_OPERATOR_NON_MEMBER_FUNCTION(float);
 LESS_THAN_OPERATOR_NON_MEMBER_FUNCTION(double);
 
 
-
-
 // ------------------------------------------
 // Function Set:  Operator <= Overloading
 // ------------------------------------------
-bool bigbigint::operator <=(bigbigint CompVal)
+bool bigbigint::operator <=(const bigbigint &CompVal) const
 {
-    int comp_result;
-    if(CompVal._length > this->_length) 
-    {
-        bigbigint tVal(CompVal._length);
-        tVal = *this;
-        comp_result = memcmp(tVal._first_byte, CompVal._first_byte, CompVal._num_bytes);
-    }
-    else if(this->_length > CompVal._length) 
-    {
-        bigbigint tVal(this->_length);
-        tVal = CompVal;
-        comp_result = memcmp(this->_first_byte, tVal._first_byte, tVal._num_bytes);
-    }
-    else
-    {
-        comp_result = memcmp(this->_first_byte, CompVal._first_byte, CompVal._num_bytes);
-    }
-
-	return (comp_result <= 0 ? true : false);
+	return (this->compare(CompVal) <= 0);
 }
 
 
-#define LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(__type)   \
-bool bigbigint::operator <=(__type CompVal)              \
+#define LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(__type, __load_type, __is_signed)   \
+bool bigbigint::operator <=(__type CompVal) const        \
 {                                                       \
-    int comp_result;                                    \
-    if( CompVal == 0 && IS_NEGATIVE(this->_flags)) {    \
-        return true;                                    \
-    }                                                   \
-    {                                                   \
-        bigbigint tVal(this->_length);                      \
-        tVal = CompVal;                                     \
-        comp_result = memcmp(this->_first_byte,             \
-                      tVal._first_byte, tVal._num_bytes);   \
-    }                                                    \
-	return (comp_result <= 0 ? true : false);            \
-}
-
-LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(int)
-LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned int);
-LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(long)
-LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned long);
-LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(short)
-LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned short);
-LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(char)
-LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char);
-LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(float)
-LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(double)
+    __load_type tmp_val;                                \
+    tmp_val = (__load_type)CompVal;                     \
+	return (this->_compare_scalar((void*)&tmp_val,       \
+                sizeof(tmp_val), __is_signed) <= 0);     \
+}
+
+LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(int, int, true)
+LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned int, unsigned int, false)
+LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(long, long, true)
+LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned long, unsigned long, false)
+LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(short, short, true)
+LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned short, unsigned short, false)
+LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(char, char, true)
+LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char, unsigned char, false)
+LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(float, D_LONG, true)
+LESS_THAN_EQ_OPERATOR_MEMBER_FUNCTION(double, D_LONG, true)
 
 
+//
+//  <type> <= bigbigint  ==  bigbigint >= <type>
 #define LESS_THAN_EQ_OPERATOR_NON_MEMBER_FUNCTION(__type)   \
-bool operator <=(const __type &CompVal, bigbigint &this_value) \
+bool operator <=(const __type &CompVal, const bigbigint &this_value) \
 {                                                       \
-	return (this_value > CompVal);                     \
+	return (this_value >= CompVal);                     \
 }
 
-
 LESS_THAN_EQ_OPERATOR_NON_MEMBER_FUNCTION(int);
 LESS_THAN_EQ_OPERATOR_NON_MEMBER_FUNCTION(unsigned int);
 LESS_THAN_EQ_OPERATOR_NON_MEMBER_FUNCTION(long);
@@ -1959,59 +4568,40 @@ LESS_THAN_EQ_OPERATOR_NON_MEMBER_FUNCTION(float);
 LESS_THAN_EQ_OPERATOR_NON_MEMBER_FUNCTION(double);
 
 
-
 // ------------------------------------------
 // Function Set:  Operator == Overloading
 // ------------------------------------------
-bool bigbigint::operator ==(bigbigint CompVal)
+bool bigbigint::operator ==(const bigbigint &CompVal) const
 {
-    int comp_result;
-    if(CompVal._length > this->_length) 
-    {
-        bigbigint tVal(CompVal._length);
-        tVal = *this;
-        comp_result = memcmp(tVal._first_byte, CompVal._first_byte, CompVal._num_bytes);
-    }
-    else if(this->_length > CompVal._length) 
-    {
-        bigbigint tVal(this->_length);
-        tVal = CompVal;
-        comp_result = memcmp(this->_first_byte, tVal._first_byte, tVal._num_bytes);
-    }
-    else
-    {
-        comp_result = memcmp(this->_first_byte, CompVal._first_byte, CompVal._num_bytes);
-    }
-
-	return (comp_result == 0 ? true : false);
+	return (this->compare(CompVal) == 0);
 }
 
 
-#define EQUALITY_OPERATOR_MEMBER_FUNCTION(__type)   \
-bool bigbigint::operator ==(__type CompVal)              \
+#define EQUALITY_OPERATOR_MEMBER_FUNCTION(__type, __load_type, __is_signed)   \
+bool bigbigint::operator ==(__type CompVal) const        \
 {                                                       \
-    int comp_result;                                    \
-    bigbigint tVal(this->_length);                      \
-    tVal = CompVal;                                     \
-    comp_result = memcmp(this->_first_byte,             \
-                  tVal._first_byte, tVal._num_bytes);   \
-	return (comp_result == 0 ? true : false);            \
-}
-
-EQUALITY_OPERATOR_MEMBER_FUNCTION(int)
-EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned int);
-EQUALITY_OPERATOR_MEMBER_FUNCTION(long)
-EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned long);
-EQUALITY_OPERATOR_MEMBER_FUNCTION(short)
-EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned short);
-EQUALITY_OPERATOR_MEMBER_FUNCTION(char)
-EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned char);
-EQUALITY_OPERATOR_MEMBER_FUNCTION(float)
-EQUALITY_OPERATOR_MEMBER_FUNCTION(double)
+    __load_type tmp_val;                                \
+    tmp_val = (__load_type)CompVal;                     \
+	return (this->_compare_scalar((void*)&tmp_val,       \
+                sizeof(tmp_val), __is_signed) == 0);     \
+}
 
+EQUALITY_OPERATOR_MEMBER_FUNCTION(int, int, true)
+EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned int, unsigned int, false)
+EQUALITY_OPERATOR_MEMBER_FUNCTION(long, long, true)
+EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned long, unsigned long, false)
+EQUALITY_OPERATOR_MEMBER_FUNCTION(short, short, true)
+EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned short, unsigned short, false)
+EQUALITY_OPERATOR_MEMBER_FUNCTION(char, char, true)
+EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned char, unsigned char, false)
+EQUALITY_OPERATOR_MEMBER_FUNCTION(float, D_LONG, true)
+EQUALITY_OPERATOR_MEMBER_FUNCTION(double, D_LONG, true)
 
+
+//
+//  <type> == bigbigint  ==  bigbigint == <type>
 #define EQUALITY_OPERATOR_NON_MEMBER_FUNCTION(__type)   \
-bool operator ==(const __type &CompVal, bigbigint &this_value) \
+bool operator ==(const __type &CompVal, const bigbigint &this_value) \
 {                                                       \
 	return (this_value == CompVal);                     \
 }
@@ -2031,55 +4621,37 @@ EQUALITY_OPERATOR_NON_MEMBER_FUNCTION(double);
 // ------------------------------------------
 // Function Set:  Operator != Overloading
 // ------------------------------------------
-bool bigbigint::operator !=(bigbigint CompVal)
+bool bigbigint::operator !=(const bigbigint &CompVal) const
 {
-    int comp_result;
-    if(CompVal._length > this->_length) 
-    {
-        bigbigint tVal(CompVal._length);
-        tVal = *this;
-        comp_result = memcmp(tVal._first_byte, CompVal._first_byte, CompVal._num_bytes);
-    }
-    else if(this->_length > CompVal._length) 
-    {
-        bigbigint tVal(this->_length);
-        tVal = CompVal;
-        comp_result = memcmp(this->_first_byte, tVal._first_byte, tVal._num_bytes);
-    }
-    else
-    {
-        comp_result = memcmp(this->_first_byte, CompVal._first_byte, CompVal._num_bytes);
-    }
-
-	return (comp_result != 0 ? true : false);
+	return (this->compare(CompVal) != 0);
 }
 
 
-#define NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(__type)   \
-bool bigbigint::operator !=(__type CompVal)              \
+#define NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(__type, __load_type, __is_signed)   \
+bool bigbigint::operator !=(__type CompVal) const        \
 {                                                       \
-    int comp_result;                                    \
-    bigbigint tVal(this->_length);                      \
-    tVal = CompVal;                                     \
-    comp_result = memcmp(this->_first_byte,             \
-                  tVal._first_byte, tVal._num_bytes);   \
-	return (comp_result != 0 ? true : false);            \
-}
-
-NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(int)
-NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned int);
-NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(long)
-NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned long);
-NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(short)
-NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned short);
-NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(char)
-NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned char);
-NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(float)
-NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(double)
+    __load_type tmp_val;                                \
+    tmp_val = (__load_type)CompVal;                     \
+	return (this->_compare_scalar((void*)&tmp_val,       \
+                sizeof(tmp_val), __is_signed) != 0);     \
+}
+
+NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(int, int, true)
+NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned int, unsigned int, false)
+NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(long, long, true)
+NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned long, unsigned long, false)
+NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(short, short, true)
+NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned short, unsigned short, false)
+NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(char, char, true)
+NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(unsigned char, unsigned char, false)
+NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(float, D_LONG, true)
+NON_EQUALITY_OPERATOR_MEMBER_FUNCTION(double, D_LONG, true)
 
 
+//
+//  <type> != bigbigint  ==  bigbigint != <type>
 #define NON_EQUALITY_OPERATOR_NON_MEMBER_FUNCTION(__type)   \
-bool operator !=(const __type &CompVal, bigbigint &this_value) \
+bool operator !=(const __type &CompVal, const bigbigint &this_value) \
 {                                                       \
 	return (this_value != CompVal);                     \
 }
@@ -2096,14 +4668,12 @@ NON_EQUALITY_OPERATOR_NON_MEMBER_FUNCTION(float);
 NON_EQUALITY_OPERATOR_NON_MEMBER_FUNCTION(double);
 
 
-
-
 // ------------------------------------------
 // Function Set:  Operator ! Overloading
 // ------------------------------------------
-bool bigbigint::operator !()
+bool bigbigint::operator !() const
 {
-	return (this == 0 ? true : false);
+	return (this->_size() == 0);
 }
 
 
@@ -2114,53 +4684,8 @@ bool bigbigint::operator !()
 
 bigbigint bigbigint::operator << (unsigned long Shift)
 {
-    bigbigint tVal(this->_length);
-    unsigned long curr_byte, offset;
-    unsigned char *p_store, *p_load, *p_last_byte;
-    int shift_value;
-
-    tVal = 0;
-
-    //Always start storing with the first byte
-    p_store = tVal._first_byte;
-
-    //Load based on the offset (shift_value)
-    offset = 0;
-    offset = Shift / 8;
-    shift_value = Shift-1 % 8;
-
-    p_load = ((unsigned char*)this->_first_byte) + offset;
-
-    // If no actual shifting will take place, just do a nice little memcpy    
-    if(shift_value == 0) {
-        memcpy(p_store, p_load, (this->_num_bytes - offset));
-        return tVal;
-    }
-
-    p_last_byte = (this->_first_byte + this->_num_bytes) - 1;
-    while(p_load <= p_last_byte) {
-        
-        // The idea here is that we grab two bytes
-        // so that any bits in the next byte are correctly
-        // shifted up to the current byte.
-        // (Then shift it down 8 bits so that we can store the byte)
-        // 
-        // Note: we have to load up each byte separately since
-        // the endianness of the architecture may (or may not) flip
-        // the two bytes.  thank you intel.
-        curr_byte = *p_load;
-        curr_byte <<= 8;
-        if(p_load < p_last_byte) {
-            curr_byte |= *(p_load+1);
-        }
-        curr_byte <<= shift_value;
-        curr_byte >>= 8;
-        *p_store = (unsigned char)(curr_byte & 0xFF);
-
-        p_store++;
-        p_load++;
-    }
-
+    bigbigint tVal(*this);
+    tVal._shift_left(Shift);
     return tVal;
 }
 
@@ -2190,9 +4715,13 @@ LEFT_SHIFT_OPERATOR_MEMBER_FUNCTION(unsigned char);
 // Function Set:  Operator <<= Overloading
 // ------------------------------------------
 #define LEFT_SHIFT_EQUAL_OPERATOR_MEMBER_FUNCTION(__type)   \
-bigbigint bigbigint::operator <<= (__type Shift)    \
+bigbigint &bigbigint::operator <<= (__type Shift)   \
 {                                                   \
-    *this = *this << Shift;                         \
+    if(Shift < 0) {                                 \
+        this->_shift_right((unsigned long)(0-Shift)); \
+        return *this;                               \
+    }                                               \
+    this->_shift_left((unsigned long)Shift);        \
     return *this;                                   \
 }
 
@@ -2219,52 +4748,8 @@ LEFT_SHIFT_EQUAL_OPERATOR_MEMBER_FUNCTION(unsigned char);
 
 bigbigint bigbigint::operator >> (unsigned long Shift)
 {
-    bigbigint tVal(this->_length);
-    unsigned long curr_byte, offset;
-    unsigned char *p_store, *p_load, *p_last_byte;
-    int shift_value;
-
-    tVal = 0;
-
-
-    //Load based on the offset (shift_value)
-    offset = 0;
-    offset = Shift / 8;
-    shift_value = Shift-1 % 8;
-
-    // If no actual shifting will take place, just do a nice little memcpy    
-    if(shift_value == 0) {
-        memcpy(tVal._first_byte + offset,this->_first_byte, 
-                (this->_num_bytes - offset));
-        return tVal;
-    }
-
-    //Set up the pointers
-    p_store = tVal._first_byte + offset;
-    p_load = this->_first_byte;
-    p_last_byte = this->_first_byte + ((this->_num_bytes - offset)-1);
-
-    while(p_load <= p_last_byte) {
-        // The idea here is that we grab two bytes
-        // so that any bits in the previous byte are correctly
-        // shifted down to the current byte.
-        // 
-        if(p_load == this->_first_byte) {
-            curr_byte = 0;
-        }
-        else
-        {
-            curr_byte |= *(p_load-1);
-            curr_byte <<= 8;
-        }
-        curr_byte |= *p_load;
-        curr_byte >>= shift_value;
-        *p_store = (unsigned char)(curr_byte & 0xFF);
-
-        p_store++;
-        p_load++;
-    }
-
+    bigbigint tVal(*this);
+    tVal._shift_right(Shift);
     return tVal;
 }
 
@@ -2290,9 +4775,13 @@ RIGHT_SHIFT_OPERATOR_MEMBER_FUNCTION(unsigned char);
 // Function Set:  Operator >>= Overloading
 // ------------------------------------------
 #define RIGHT_SHIFT_EQ_OPERATOR_MEMBER_FUNCTION(__type)   \
-bigbigint bigbigint::operator >>= (__type Shift)    \
+bigbigint &bigbigint::operator >>= (__type Shift)   \
 {                                                   \
-    *this = *this >> Shift;                         \
+    if(Shift < 0) {                                 \
+        this->_shift_left((unsigned long)(0-Shift)); \
+        return *this;                               \
+    }                                               \
+    this->_shift_right((unsigned long)Shift);       \
     return *this;                                   \
 }
 
@@ -2308,86 +4797,159 @@ RIGHT_SHIFT_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char);
 
 
 // ------------------------------------------
-// Function Set:  Operator | Overloading
+// Function Set:  Operator & | ^ Overloading
 // ------------------------------------------
-bigbigint bigbigint::operator | (bigbigint OrVal)
+//
+//  All three work like the native signed types:  a negative value
+//  takes part as its two's complement (see _bitwise).
+bigbigint bigbigint::operator &(const bigbigint &AndVal)
 {
-    bigbigint tVal(this->_length);
-    unsigned long i;
+    bigbigint tVal(*this);
+    tVal._bitwise(AndVal, '&');
+    return tVal;
+}
 
-    tVal = 0;
-    for(i = 0; tVal._num_bytes; i++) {
-        tVal._first_byte[i] = this->_first_byte[i] | OrVal._first_byte[i];
-    }
+bigbigint bigbigint::operator |(const bigbigint &OrVal)
+{
+    bigbigint tVal(*this);
+    tVal._bitwise(OrVal, '|');
+    return tVal;
+}
 
+bigbigint bigbigint::operator ^(const bigbigint &XorVal)
+{
+    bigbigint tVal(*this);
+    tVal._bitwise(XorVal, '^');
     return tVal;
 }
 
 
-#define BIT_OR_OPERATOR_MEMBER_FUNCTION(__type)         \
-bigbigint bigbigint::operator |(__type OrVal)                \
+#define BITWISE_OPERATOR_MEMBER_FUNCTION(__sym, __type)  \
+bigbigint bigbigint::operator __sym(__type BitVal)      \
 {                                                       \
-    bigbigint tVal(this->_length);                      \
-    tVal = OrVal;                                       \
-	return (*this | tVal);                              \
+    bigbigint tVal(*this);                              \
+    tVal __sym##= BitVal;                               \
+	return tVal;                                        \
 }
 
-BIT_OR_OPERATOR_MEMBER_FUNCTION(int)
-BIT_OR_OPERATOR_MEMBER_FUNCTION(unsigned int);
-BIT_OR_OPERATOR_MEMBER_FUNCTION(long)
-BIT_OR_OPERATOR_MEMBER_FUNCTION(unsigned long);
-BIT_OR_OPERATOR_MEMBER_FUNCTION(short)
-BIT_OR_OPERATOR_MEMBER_FUNCTION(unsigned short);
-BIT_OR_OPERATOR_MEMBER_FUNCTION(char)
-BIT_OR_OPERATOR_MEMBER_FUNCTION(unsigned char);
-BIT_OR_OPERATOR_MEMBER_FUNCTION(float)
-BIT_OR_OPERATOR_MEMBER_FUNCTION(double)
+#define BITWISE_OPERATOR_MEMBER_FUNCTIONS(__sym)        \
+    BITWISE_OPERATOR_MEMBER_FUNCTION(__sym, int)        \
+    BITWISE_OPERATOR_MEMBER_FUNCTION(__sym, unsigned int)   \
+    BITWISE_OPERATOR_MEMBER_FUNCTION(__sym, long)       \
+    BITWISE_OPERATOR_MEMBER_FUNCTION(__sym, unsigned long)  \
+    BITWISE_OPERATOR_MEMBER_FUNCTION(__sym, short)      \
+    BITWISE_OPERATOR_MEMBER_FUNCTION(__sym, unsigned short) \
+    BITWISE_OPERATOR_MEMBER_FUNCTION(__sym, char)       \
+    BITWISE_OPERATOR_MEMBER_FUNCTION(__sym, unsigned char)  \
+    BITWISE_OPERATOR_MEMBER_FUNCTION(__sym, float)      \
+    BITWISE_OPERATOR_MEMBER_FUNCTION(__sym, double)
+
+BITWISE_OPERATOR_MEMBER_FUNCTIONS(&)
+BITWISE_OPERATOR_MEMBER_FUNCTIONS(|)
+BITWISE_OPERATOR_MEMBER_FUNCTIONS(^)
 
 
 
-#define BIT_OR_OPERATOR_NON_MEMBER_FUNCTION(__type)     \
-bigbigint operator |(__type &OrVal, bigbigint &big_val)   \
+//
+//  The operations commute, so <type> op [bigbigint] just swaps sides.
+#define BITWISE_OPERATOR_NON_MEMBER_FUNCTION(__sym, __type) \
+bigbigint operator __sym(const __type &BitVal, const bigbigint &big_val)   \
 {                                                       \
-    bigbigint tVal(big_val.length());                   \
-    tVal = OrVal;                                       \
-	return (tVal | big_val);                            \
+    bigbigint tVal(big_val);                            \
+    tVal __sym##= BitVal;                               \
+	return tVal;                                        \
 }
 
-BIT_OR_OPERATOR_NON_MEMBER_FUNCTION(int)
-BIT_OR_OPERATOR_NON_MEMBER_FUNCTION(unsigned int);
-BIT_OR_OPERATOR_NON_MEMBER_FUNCTION(long)
-BIT_OR_OPERATOR_NON_MEMBER_FUNCTION(unsigned long);
-BIT_OR_OPERATOR_NON_MEMBER_FUNCTION(short)
-BIT_OR_OPERATOR_NON_MEMBER_FUNCTION(unsigned short);
-BIT_OR_OPERATOR_NON_MEMBER_FUNCTION(char)
-BIT_OR_OPERATOR_NON_MEMBER_FUNCTION(unsigned char);
-BIT_OR_OPERATOR_NON_MEMBER_FUNCTION(float)
-BIT_OR_OPERATOR_NON_MEMBER_FUNCTION(double)
+#define BITWISE_OPERATOR_NON_MEMBER_FUNCTIONS(__sym)    \
+    BITWISE_OPERATOR_NON_MEMBER_FUNCTION(__sym, int)    \
+    BITWISE_OPERATOR_NON_MEMBER_FUNCTION(__sym, unsigned int)   \
+    BITWISE_OPERATOR_NON_MEMBER_FUNCTION(__sym, long)   \
+    BITWISE_OPERATOR_NON_MEMBER_FUNCTION(__sym, unsigned long)  \
+    BITWISE_OPERATOR_NON_MEMBER_FUNCTION(__sym, short)  \
+    BITWISE_OPERATOR_NON_MEMBER_FUNCTION(__sym, unsigned short) \
+    BITWISE_OPERATOR_NON_MEMBER_FUNCTION(__sym, char)   \
+    BITWISE_OPERATOR_NON_MEMBER_FUNCTION(__sym, unsigned char)  \
+    BITWISE_OPERATOR_NON_MEMBER_FUNCTION(__sym, float)  \
+    BITWISE_OPERATOR_NON_MEMBER_FUNCTION(__sym, double)
+
+BITWISE_OPERATOR_NON_MEMBER_FUNCTIONS(&)
+BITWISE_OPERATOR_NON_MEMBER_FUNCTIONS(|)
+BITWISE_OPERATOR_NON_MEMBER_FUNCTIONS(^)
 
 
 // ------------------------------------------
-// Function Set:  Operator |= Overloading
+// Function Set:  Operator &= |= ^= Overloading
 // ------------------------------------------
-#define BIT_OR_EQ_OPERATOR_MEMBER_FUNCTION(__type)      \
-bigbigint bigbigint::operator |=(__type OrVal)          \
+bigbigint &bigbigint::operator &=(const bigbigint &AndVal)
+{
+    this->_bitwise(AndVal, '&');
+    return (*this);
+}
+
+bigbigint &bigbigint::operator |=(const bigbigint &OrVal)
+{
+    this->_bitwise(OrVal, '|');
+    return (*this);
+}
+
+bigbigint &bigbigint::operator ^=(const bigbigint &XorVal)
+{
+    this->_bitwise(XorVal, '^');
+    return (*this);
+}
+
+//
+//  A native value only ever reaches past the bottom limb through
+//  its sign.
+#define BITWISE_EQ_OPERATOR_MEMBER_FUNCTION(__sym, __op, __type, __is_signed)  \
+bigbigint &bigbigint::operator __sym##=(__type BitVal)  \
+{                                                       \
+    this->_bitwise_scalar((void*)&BitVal, sizeof(BitVal), __is_signed, __op); \
+	return (*this);                                     \
+}
+
+//
+//  float and double are truncated to an integer first
+#define BITWISE_EQ_OPERATOR_FLOAT_FUNCTION(__sym, __op, __type)   \
+bigbigint &bigbigint::operator __sym##=(__type BitFloat)    \
 {                                                       \
-    *this = *this | OrVal;                              \
+    D_LONG BitVal;                                      \
+                                                        \
+    BitVal = (D_LONG)BitFloat;                          \
+    this->_bitwise_scalar((void*)&BitVal, sizeof(BitVal), true, __op); \
 	return (*this);                                     \
 }
 
-BIT_OR_EQ_OPERATOR_MEMBER_FUNCTION(bigbigint)
-BIT_OR_EQ_OPERATOR_MEMBER_FUNCTION(int)
-BIT_OR_EQ_OPERATOR_MEMBER_FUNCTION(unsigned int);
-BIT_OR_EQ_OPERATOR_MEMBER_FUNCTION(long)
-BIT_OR_EQ_OPERATOR_MEMBER_FUNCTION(unsigned long);
-BIT_OR_EQ_OPERATOR_MEMBER_FUNCTION(short)
-BIT_OR_EQ_OPERATOR_MEMBER_FUNCTION(unsigned short);
-BIT_OR_EQ_OPERATOR_MEMBER_FUNCTION(char)
-BIT_OR_EQ_OPERATOR_MEMBER_FUNCTION(unsigned char);
-BIT_OR_EQ_OPERATOR_MEMBER_FUNCTION(float)
-BIT_OR_EQ_OPERATOR_MEMBER_FUNCTION(double)
+#define BITWISE_EQ_OPERATOR_MEMBER_FUNCTIONS(__sym, __op)     \
+    BITWISE_EQ_OPERATOR_MEMBER_FUNCTION(__sym, __op, int, true)   \
+    BITWISE_EQ_OPERATOR_MEMBER_FUNCTION(__sym, __op, unsigned int, false) \
+    BITWISE_EQ_OPERATOR_MEMBER_FUNCTION(__sym, __op, long, true)  \
+    BITWISE_EQ_OPERATOR_MEMBER_FUNCTION(__sym, __op, unsigned long, false)    \
+    BITWISE_EQ_OPERATOR_MEMBER_FUNCTION(__sym, __op, short, true) \
+    BITWISE_EQ_OPERATOR_MEMBER_FUNCTION(__sym, __op, unsigned short, false)   \
+    BITWISE_EQ_OPERATOR_MEMBER_FUNCTION(__sym, __op, char, true)  \
+    BITWISE_EQ_OPERATOR_MEMBER_FUNCTION(__sym, __op, unsigned char, false)    \
+    BITWISE_EQ_OPERATOR_FLOAT_FUNCTION(__sym, __op, float)    \
+    BITWISE_EQ_OPERATOR_FLOAT_FUNCTION(__sym, __op, double)
+
+BITWISE_EQ_OPERATOR_MEMBER_FUNCTIONS(&, '&')
+BITWISE_EQ_OPERATOR_MEMBER_FUNCTIONS(|, '|')
+BITWISE_EQ_OPERATOR_MEMBER_FUNCTIONS(^, '^')
 
 
 // ------------------------------------------
-// Function Set:  Operator & Overloading
+// Function Set:  Operator ~ Overloading
 // ------------------------------------------
+//
+//  In two's complement ~x == -x - 1, so this is a negate and a
+//  decrement (which stops as soon as the borrow does).
+bigbigint bigbigint::operator ~() const
+{
+    bigbigint tVal(*this);
+
+    if (tVal._size() != 0) {
+        tVal._flags ^= BBI_NEGATIVE;
+    }
+    tVal._step(true);
+    return tVal;
+}
@@ -16,6 +16,15 @@
 
 #include <stdlib.h>
 #include <limits.h>
+#include <stdint.h>
+#include <string>
+#include <iosfwd>
+#include <system_error>
+#include <functional>
+#include "BigBigIntMpn.h"
+#if defined(__cpp_impl_three_way_comparison) && (__cpp_impl_three_way_comparison >= 201907L)
+    #include <compare>
+#endif
 
 //-----------------------------------------------------------------------------
 //                              Base Defines
@@ -24,27 +33,158 @@
 #if defined(WIN32)
     #define D_LONG __int64
 #else
-    #define D_LONG double long
-    //Note:  64-bit linux defines "long" as 64 bits.
-    //       I'm not sure how this would play out there.
-    //       However, this essentially needs to be a 64-bit integer.
+    #define D_LONG long long
+    //Note:  This needs to be a 64-bit (signed) integer.  It is only
+    //       used to hold native values (and truncated floats) on
+    //       their way into a bigbigint.
 #endif
 
-//  The base type 
-//  Requirements:
-//  1)  Must be unsigned (u_char, u_short, u_int, u_long, etc.)
-//  2)  Must not be a double long/__int64/etc.  Needs to be 32-bits at most!
-//  
-#define BBI_BASE_TYPE unsigned int
-#define BBI_BASE_MAX  0xFFFFFFFFUL
+//  The base type (one "limb" of the number) and the limb functions
+//  the class is built on live in BigBigIntMpn.h
 
-//  The minimum size is 32 bytes.
+//  The minimum size is 16 bytes.
 //  NOTE: Make sure that this is at least as large as
 //  an INT.
 //  (MIN_SIZE * sizeof(BASE_TYPE) = minimum # bytes)
 #define BBI_MIN_SIZE  2
 
 
+//-----------------------------------------------------------------------------
+//                    Expression Templates (forward)
+//-----------------------------------------------------------------------------
+//  See BigBigIntExpr.h
+template <class __lhs, class __rhs, char __op> class bbi_expr;
+template <class __type> struct bbi_expr_traits;
+
+
+//-----------------------------------------------------------------------------
+//                       to_chars / from_chars Results
+//-----------------------------------------------------------------------------
+//  Laid out like std::to_chars_result and std::from_chars_result 
+//  (which need C++17)
+struct bbi_to_chars_result
+{
+    char *ptr;
+    std::errc ec;
+};
+
+struct bbi_from_chars_result
+{
+    const char *ptr;
+    std::errc ec;
+};
+
+//-----------------------------------------------------------------------------
+//                              Digit Sinks
+//-----------------------------------------------------------------------------
+//  Where write_text() sends the digits, a piece at a time and in 
+//  order.  put() returns false to stop the conversion.
+class bbi_digit_sink
+{
+public:
+    virtual ~bbi_digit_sink() {}
+    virtual bool put(const char *digits, unsigned long length) = 0;
+};
+
+//  Buffers the digits and writes them to a file descriptor (see 
+//  BigBigInt.cpp).  Call flush() when done; the destructor does too,
+//  but can't report an error.
+#define BBI_FD_SINK_SIZE    65536   // bytes
+
+class bbi_fd_sink : public bbi_digit_sink
+{
+public:
+    explicit bbi_fd_sink(int fd);
+    ~bbi_fd_sink();
+
+    bool put(const char *digits, unsigned long length);
+    bool flush();
+
+private:
+    int _fd;
+    bool _failed;
+    unsigned long _used;
+    char _buffer[BBI_FD_SINK_SIZE];
+
+    bool _put(const char *data, unsigned long length);
+
+    bbi_fd_sink(const bbi_fd_sink &);
+    bbi_fd_sink &operator =(const bbi_fd_sink &);
+};
+
+
+//  Text conversion on caller supplied buffers, and the stream operators
+//  (see BigBigInt.cpp)
+class bigbigint;
+class bigbigint_view;
+bbi_to_chars_result to_chars(char *first, char *last, const bigbigint &value, int base = 10);
+bbi_to_chars_result to_chars(char *first, char *last, const bigbigint_view &value, int base = 10);
+bbi_from_chars_result from_chars(const char *first, const char *last, bigbigint &value, int base = 10);
+std::ostream &operator <<(std::ostream &os, const bigbigint &value);
+std::ostream &operator <<(std::ostream &os, const bigbigint_view &value);
+std::istream &operator >>(std::istream &is, bigbigint &value);
+
+
+//-----------------------------------------------------------------------------
+//                              Statistics
+//-----------------------------------------------------------------------------
+//  Built with BBI_ENABLE_STATS, every thread counts its calls to each 
+//  kind of operation (and the limbs in their operands), and the 
+//  allocations and copies underneath them.  bigbigint::stats() reads
+//  them back.  Without it nothing is counted and the counts are zero.
+//
+//  Work done inside an operation counts as well:  powmod's 
+//  multiplications and divisions show up under mul and div too.
+enum bbi_stat_op
+{
+    BBI_STAT_ADD,           // + - += -= ++ -- (any operand types)
+    BBI_STAT_MUL,           // * *= by a bigbigint, multiply-add
+    BBI_STAT_MUL_SCALAR,    // * *= by a native type
+    BBI_STAT_DIV,           // / % by a bigbigint
+    BBI_STAT_DIV_SCALAR,    // / % by a native type
+    BBI_STAT_SHIFT,         // << >> <<= >>=
+    BBI_STAT_BITWISE,       // & | ^ &= |= ^=
+    BBI_STAT_TO_TEXT,       // to_string, to_chars, write_text, <<
+    BBI_STAT_FROM_TEXT,     // from_string, from_chars, >>
+    BBI_STAT_POWMOD,
+    BBI_STAT_NUM_OPS
+};
+
+struct bbi_stats
+{
+    uint64_t calls[BBI_STAT_NUM_OPS];
+    uint64_t limbs[BBI_STAT_NUM_OPS];   // operand limbs, all calls
+    uint64_t mallocs;                   // new buffers
+    uint64_t upsizes;                   // buffers grown (realloc)
+    uint64_t copies;                    // whole values copied (copy 
+                                        // constructor, =, copy())
+    uint64_t bytes_allocated;           // by mallocs and upsizes
+    uint64_t bytes_copied;              // by copies
+};
+
+//  "add", "mul", ... for a bbi_stat_op
+const char *bbi_stat_name(int op);
+
+
+//-----------------------------------------------------------------------------
+//                                Tracing
+//-----------------------------------------------------------------------------
+//  Built with BBI_ENABLE_TRACE, the long running operations (mul, div,
+//  powmod and the text conversions, from the size given to 
+//  bigbigint::trace_start() up) are timed.  Each one goes into a 
+//  latency histogram for its operation and size class (the power of 
+//  two its limb count falls under), and optionally into a list of 
+//  events that write_chrome_trace() saves in Chrome's trace event 
+//  format (chrome://tracing, Perfetto).  Hooks can be set to see each
+//  one begin and end as well.  op is a bbi_stat_op and limbs the sum
+//  of the operand sizes.
+//
+//  Without BBI_ENABLE_TRACE none of it is compiled in.  With it, and
+//  tracing stopped, an operation costs one compare more.
+typedef void (*bbi_trace_begin_hook)(int op, unsigned long limbs, void *user);
+typedef void (*bbi_trace_end_hook)(int op, unsigned long limbs, uint64_t ns, void *user);
+
+
 //-----------------------------------------------------------------------------
 //                          BigBigInt Class
 //-----------------------------------------------------------------------------
@@ -68,6 +208,11 @@ public:
 
     // copy constructors
     bigbigint(bigbigint const& copy);
+    explicit bigbigint(const bigbigint_view &view);
+
+    // evaluates an expression (a*b + c*d - e, ...) straight into place
+    template <class __lhs, class __rhs, char __op>
+    bigbigint(const bbi_expr<__lhs, __rhs, __op> &expr);
 
     // destructor
     virtual ~bigbigint();
@@ -78,22 +223,98 @@ public:
     long length();
     bigbigint * copy(bigbigint *item_to_copy);  // "=" also works.  ;)
 
+    // Three-way comparison:  -1, 0 or 1 as *this is less than, equal
+    // to or greater than CompVal (all the comparison operators use it)
+    int compare(const bigbigint &CompVal) const;
+
+    // Bit queries (bit indexes start at 0 for the lowest bit)
+    unsigned long bit_length() const;
+    unsigned long popcount() const;
+    unsigned long count_trailing_zeros() const;
+    bool test_bit(unsigned long bit) const;
+    void set_bit(unsigned long bit);
+    void clear_bit(unsigned long bit);
+    void flip_bit(unsigned long bit);
+
+    // (*this ^ exponent) mod modulus, in 0 .. |modulus| - 1
+    bigbigint powmod(const bigbigint &exponent, const bigbigint &modulus) const;
+
+    // The value as text in the given base (2 - 36), e.g. "-123"
+    std::string to_string(int base = 10) const;
+
+    // Characters to_chars() may need, '-' included (exact or one over)
+    unsigned long digits_upper_bound(int base = 10) const;
+
+    // Streams the text (as to_string gives it) to a sink or file 
+    // descriptor without building it all in memory
+    bool write_text(bbi_digit_sink &sink, int base = 10) const;
+    bool write_text(int fd, int base = 10) const;
+
+    // Raw words of any size, word order and byte order, as GMP's 
+    // mpz_import / mpz_export (see bbi_import in BigBigIntMpn.h).  Only
+    // the magnitude goes either way; import_words leaves it positive.
+    // data must hold export_count(size) words for export_words, which
+    // returns the number written.
+    void import_words(unsigned long count, int order, unsigned long size, int endian, const void *data);
+    unsigned long export_count(unsigned long size) const;
+    unsigned long export_words(void *data, int order, unsigned long size, int endian) const;
+
+    // Versioned binary format (see BigBigInt.cpp).  load_mapped() uses
+    // the file's limbs in place instead of reading them in.
+    bool save(int fd) const;
+    bool load(int fd);
+    bool load_mapped(const char *path, bool writable = true);
+
+    // Sets the value from text in the given base (2 - 36, or 0 to go 
+    // by the prefix as strtol does).  false if it isn't a number.
+    bool from_string(const char *str, int base = 10);
+    bool from_string(const std::string &str, int base = 10);
+
+    // Operation and allocation counts (see BBI_ENABLE_STATS):  the 
+    // calling thread's, or every thread's added up.  write_stats() 
+    // prints them as a table, and write_stats_at_exit() has that done
+    // when the program ends (as setting BBI_STATS_DUMP in the 
+    // environment does, to stderr).
+    static bbi_stats stats(bool all_threads = false);
+    static void reset_stats(bool all_threads = false);
+    static bool write_stats(int fd, bool all_threads = true);
+    static void write_stats_at_exit(int fd = 2);
+
+    // Latency histograms and trace events (see BBI_ENABLE_TRACE).  
+    // trace_start() clears what was recorded before and times the 
+    // operations of at least min_limbs limbs from then on, keeping up
+    // to max_events of them as events (none by default).
+    static void trace_start(unsigned long min_limbs = 64, unsigned long max_events = 0);
+    static void trace_stop();
+    static void set_trace_hooks(bbi_trace_begin_hook begin, bbi_trace_end_hook end, void *user);
+    static bool write_trace_histograms(int fd);
+    static bool write_chrome_trace(int fd);
+
+    // Spreads products of at least min_limbs limbs (the shorter 
+    // operand) over num_threads threads, 0 for one per core (see 
+    // bbi_set_mul_threads).  mul_threads() is the number in use.
+    static void set_mul_threads(unsigned int num_threads, 
+                                unsigned long min_limbs = BBI_MUL_PARALLEL_THRESHOLD);
+    static unsigned int mul_threads();
+
 
 //
 //  OPERATOR OVERLOADS
 //
     // Assignment
-    bigbigint operator =(const bigbigint &NewVal);
-	bigbigint operator =(int);
-	bigbigint operator =(unsigned int);
-	bigbigint operator =(long);
-	bigbigint operator =(unsigned long);
-	bigbigint operator =(short);
-	bigbigint operator =(unsigned short);
-	bigbigint operator =(char);
-	bigbigint operator =(unsigned char);
-    bigbigint operator =(float);
-    bigbigint operator =(double);
+    bigbigint &operator =(const bigbigint &NewVal);
+	bigbigint &operator =(int);
+	bigbigint &operator =(unsigned int);
+	bigbigint &operator =(long);
+	bigbigint &operator =(unsigned long);
+	bigbigint &operator =(short);
+	bigbigint &operator =(unsigned short);
+	bigbigint &operator =(char);
+	bigbigint &operator =(unsigned char);
+    bigbigint &operator =(float);
+    bigbigint &operator =(double);
+    template <class __lhs, class __rhs, char __op>
+    bigbigint &operator =(const bbi_expr<__lhs, __rhs, __op> &expr);
 
     // Casting
     operator int() const;
@@ -108,7 +329,7 @@ public:
     operator double() const;
 
     // Addition
-	bigbigint operator +(bigbigint);
+    //  (bigbigint + bigbigint builds an expression, see BigBigIntExpr.h)
     bigbigint operator +(int);
     bigbigint operator +(unsigned int);
     bigbigint operator +(long);
@@ -126,20 +347,22 @@ public:
         bool is_signed);
 
     // Addition/Assignment
-    bigbigint operator +=(bigbigint);
-    bigbigint operator +=(int);
-    bigbigint operator +=(unsigned int);
-    bigbigint operator +=(long);
-    bigbigint operator +=(unsigned long);
-    bigbigint operator +=(short);
-    bigbigint operator +=(unsigned short);
-    bigbigint operator +=(char);
-    bigbigint operator +=(unsigned char);
-    bigbigint operator +=(float);
-    bigbigint operator +=(double);
+    bigbigint &operator +=(const bigbigint &);
+    bigbigint &operator +=(int);
+    bigbigint &operator +=(unsigned int);
+    bigbigint &operator +=(long);
+    bigbigint &operator +=(unsigned long);
+    bigbigint &operator +=(short);
+    bigbigint &operator +=(unsigned short);
+    bigbigint &operator +=(char);
+    bigbigint &operator +=(unsigned char);
+    bigbigint &operator +=(float);
+    bigbigint &operator +=(double);
+    template <class __lhs, class __rhs, char __op>
+    bigbigint &operator +=(const bbi_expr<__lhs, __rhs, __op> &expr);
 
     // Subtraction
-    bigbigint operator -(bigbigint);
+    //  (bigbigint - bigbigint builds an expression, see BigBigIntExpr.h)
     bigbigint operator -(int);
     bigbigint operator -(unsigned int);
     bigbigint operator -(long);
@@ -155,22 +378,29 @@ public:
         void *Subtrahend,
         unsigned long sub_size,
         bool is_signed);
+    static bigbigint _perform_integral_subtraction_from(
+        void *Minuend,
+        unsigned long min_size,
+        bool is_signed,
+        bigbigint *Subtrahend);
 
     // Subtraction/Assignment
-    bigbigint operator -=(bigbigint);
-    bigbigint operator -=(int);
-    bigbigint operator -=(unsigned int);
-    bigbigint operator -=(long);
-    bigbigint operator -=(unsigned long);
-    bigbigint operator -=(short);
-    bigbigint operator -=(unsigned short);
-    bigbigint operator -=(char);
-    bigbigint operator -=(unsigned char);
-    bigbigint operator -=(float);
-    bigbigint operator -=(double);
+    bigbigint &operator -=(const bigbigint &);
+    bigbigint &operator -=(int);
+    bigbigint &operator -=(unsigned int);
+    bigbigint &operator -=(long);
+    bigbigint &operator -=(unsigned long);
+    bigbigint &operator -=(short);
+    bigbigint &operator -=(unsigned short);
+    bigbigint &operator -=(char);
+    bigbigint &operator -=(unsigned char);
+    bigbigint &operator -=(float);
+    bigbigint &operator -=(double);
+    template <class __lhs, class __rhs, char __op>
+    bigbigint &operator -=(const bbi_expr<__lhs, __rhs, __op> &expr);
 
     // Multiplication
-    bigbigint operator *(const bigbigint &multiplier);
+    //  (bigbigint * bigbigint builds an expression, see BigBigIntExpr.h)
     bigbigint operator *(int);
     bigbigint operator *(unsigned int);
     bigbigint operator *(long);
@@ -181,24 +411,24 @@ public:
     bigbigint operator *(unsigned char);
     bigbigint operator *(float);
     bigbigint operator *(double);
-    static bigbigint bigbigint::_perform_integral_multiplication(
+    static bigbigint _perform_integral_multiplication(
         bigbigint * multiplicand,
         void *multiplier, 
         unsigned long mult_size,
         bool is_signed);
 
     // Multiplication/Assignment
-    bigbigint operator *=(bigbigint);
-    bigbigint operator *=(int);
-    bigbigint operator *=(unsigned int);
-    bigbigint operator *=(long);
-    bigbigint operator *=(unsigned long);
-    bigbigint operator *=(short);
-    bigbigint operator *=(unsigned short);
-    bigbigint operator *=(char);
-    bigbigint operator *=(unsigned char);
-    bigbigint operator *=(float);
-    bigbigint operator *=(double);
+    bigbigint &operator *=(const bigbigint &);
+    bigbigint &operator *=(int);
+    bigbigint &operator *=(unsigned int);
+    bigbigint &operator *=(long);
+    bigbigint &operator *=(unsigned long);
+    bigbigint &operator *=(short);
+    bigbigint &operator *=(unsigned short);
+    bigbigint &operator *=(char);
+    bigbigint &operator *=(unsigned char);
+    bigbigint &operator *=(float);
+    bigbigint &operator *=(double);
 
     // Division
     bigbigint operator /(bigbigint);
@@ -213,101 +443,140 @@ public:
     bigbigint operator /(float);
     bigbigint operator /(double);
     static void _perform_integral_division(
-        bigbigint dividend,
-        bigbigint divisor,
+        const bigbigint &dividend,
+        const bigbigint &divisor,
         bigbigint *quotient,
         bigbigint *remainder);
+    static bigbigint _perform_native_division(
+        void *dividend,
+        unsigned long div_size,
+        bool is_signed,
+        const bigbigint *divisor);
 
     // Division/Assignment
-    bigbigint operator /=(bigbigint);
-    bigbigint operator /=(int);
-    bigbigint operator /=(unsigned int);
-    bigbigint operator /=(long);
-    bigbigint operator /=(unsigned long);
-    bigbigint operator /=(short);
-    bigbigint operator /=(unsigned short);
-    bigbigint operator /=(char);
-    bigbigint operator /=(unsigned char);
-    bigbigint operator /=(float);
-    bigbigint operator /=(double);
+    bigbigint &operator /=(const bigbigint &);
+    bigbigint &operator /=(int);
+    bigbigint &operator /=(unsigned int);
+    bigbigint &operator /=(long);
+    bigbigint &operator /=(unsigned long);
+    bigbigint &operator /=(short);
+    bigbigint &operator /=(unsigned short);
+    bigbigint &operator /=(char);
+    bigbigint &operator /=(unsigned char);
+    bigbigint &operator /=(float);
+    bigbigint &operator /=(double);
+
+    // Modulo
+    bigbigint operator %(const bigbigint &);
+    bigbigint operator %(int);
+    bigbigint operator %(unsigned int);
+    bigbigint operator %(long);
+    bigbigint operator %(unsigned long);
+    bigbigint operator %(short);
+    bigbigint operator %(unsigned short);
+    bigbigint operator %(char);
+    bigbigint operator %(unsigned char);
+    bigbigint operator %(float);
+    bigbigint operator %(double);
+
+    // Modulo/Assignment
+    bigbigint &operator %=(const bigbigint &);
+    bigbigint &operator %=(int);
+    bigbigint &operator %=(unsigned int);
+    bigbigint &operator %=(long);
+    bigbigint &operator %=(unsigned long);
+    bigbigint &operator %=(short);
+    bigbigint &operator %=(unsigned short);
+    bigbigint &operator %=(char);
+    bigbigint &operator %=(unsigned char);
+    bigbigint &operator %=(float);
+    bigbigint &operator %=(double);
 
     // Comparison:  >
-    bool operator >(bigbigint CompVal);
-    bool operator >(int);
-    bool operator >(unsigned int);
-    bool operator >(long);
-    bool operator >(unsigned long);
-    bool operator >(short);
-    bool operator >(unsigned short);
-    bool operator >(char);
-    bool operator >(unsigned char);
-    bool operator >(float);
-    bool operator >(double);
+    bool operator >(const bigbigint &CompVal) const;
+    bool operator >(int) const;
+    bool operator >(unsigned int) const;
+    bool operator >(long) const;
+    bool operator >(unsigned long) const;
+    bool operator >(short) const;
+    bool operator >(unsigned short) const;
+    bool operator >(char) const;
+    bool operator >(unsigned char) const;
+    bool operator >(float) const;
+    bool operator >(double) const;
 
     // Comparison:  >=
-    bool operator >=(bigbigint CompVal);
-    bool operator >=(int);
-    bool operator >=(unsigned int);
-    bool operator >=(long);
-    bool operator >=(unsigned long);
-    bool operator >=(short);
-    bool operator >=(unsigned short);
-    bool operator >=(char);
-    bool operator >=(unsigned char);
-    bool operator >=(float);
-    bool operator >=(double);
+    bool operator >=(const bigbigint &CompVal) const;
+    bool operator >=(int) const;
+    bool operator >=(unsigned int) const;
+    bool operator >=(long) const;
+    bool operator >=(unsigned long) const;
+    bool operator >=(short) const;
+    bool operator >=(unsigned short) const;
+    bool operator >=(char) const;
+    bool operator >=(unsigned char) const;
+    bool operator >=(float) const;
+    bool operator >=(double) const;
 
     // Comparison:  <
-    bool operator <(bigbigint CompVal);
-    bool operator <(int);
-    bool operator <(unsigned int);
-    bool operator <(long);
-    bool operator <(unsigned long);
-    bool operator <(short);
-    bool operator <(unsigned short);
-    bool operator <(char);
-    bool operator <(unsigned char);
-    bool operator <(float);
-    bool operator <(double);
+    bool operator <(const bigbigint &CompVal) const;
+    bool operator <(int) const;
+    bool operator <(unsigned int) const;
+    bool operator <(long) const;
+    bool operator <(unsigned long) const;
+    bool operator <(short) const;
+    bool operator <(unsigned short) const;
+    bool operator <(char) const;
+    bool operator <(unsigned char) const;
+    bool operator <(float) const;
+    bool operator <(double) const;
 
     // Comparison:  <=
-    bool operator <=(bigbigint CompVal);
-    bool operator <=(int);
-    bool operator <=(unsigned int);
-    bool operator <=(long);
-    bool operator <=(unsigned long);
-    bool operator <=(short);
-    bool operator <=(unsigned short);
-    bool operator <=(char);
-    bool operator <=(unsigned char);
-    bool operator <=(float);
-    bool operator <=(double);
+    bool operator <=(const bigbigint &CompVal) const;
+    bool operator <=(int) const;
+    bool operator <=(unsigned int) const;
+    bool operator <=(long) const;
+    bool operator <=(unsigned long) const;
+    bool operator <=(short) const;
+    bool operator <=(unsigned short) const;
+    bool operator <=(char) const;
+    bool operator <=(unsigned char) const;
+    bool operator <=(float) const;
+    bool operator <=(double) const;
 
     // Comparison:  ==
-    bool operator ==(bigbigint CompVal);
-    bool operator ==(int);
-    bool operator ==(unsigned int);
-    bool operator ==(long);
-    bool operator ==(unsigned long);
-    bool operator ==(short);
-    bool operator ==(unsigned short);
-    bool operator ==(char);
-    bool operator ==(unsigned char);
-    bool operator ==(float);
-    bool operator ==(double);
+    bool operator ==(const bigbigint &CompVal) const;
+    bool operator ==(int) const;
+    bool operator ==(unsigned int) const;
+    bool operator ==(long) const;
+    bool operator ==(unsigned long) const;
+    bool operator ==(short) const;
+    bool operator ==(unsigned short) const;
+    bool operator ==(char) const;
+    bool operator ==(unsigned char) const;
+    bool operator ==(float) const;
+    bool operator ==(double) const;
 
     // Comparison:  !=
-    bool operator !=(bigbigint CompVal);
-    bool operator !=(int);
-    bool operator !=(unsigned int);
-    bool operator !=(long);
-    bool operator !=(unsigned long);
-    bool operator !=(short);
-    bool operator !=(unsigned short);
-    bool operator !=(char);
-    bool operator !=(unsigned char);
-    bool operator !=(float);
-    bool operator !=(double);
+    bool operator !=(const bigbigint &CompVal) const;
+    bool operator !=(int) const;
+    bool operator !=(unsigned int) const;
+    bool operator !=(long) const;
+    bool operator !=(unsigned long) const;
+    bool operator !=(short) const;
+    bool operator !=(unsigned short) const;
+    bool operator !=(char) const;
+    bool operator !=(unsigned char) const;
+    bool operator !=(float) const;
+    bool operator !=(double) const;
+
+#if defined(__cpp_impl_three_way_comparison) && (__cpp_impl_three_way_comparison >= 201907L)
+    // Comparison:  <=>
+    std::strong_ordering operator <=>(const bigbigint &CompVal) const
+    {
+        return (this->compare(CompVal) <=> 0);
+    }
+#endif
 
     // Bitwise Left Shift Operators
     bigbigint operator <<(int);
@@ -320,16 +589,16 @@ public:
     bigbigint operator <<(unsigned char);
 
     // Bitwise Left Shift / Assignment
-    bigbigint operator <<=(int);
-    bigbigint operator <<=(unsigned int);
-    bigbigint operator <<=(long);
-    bigbigint operator <<=(unsigned long);
-    bigbigint operator <<=(short);
-    bigbigint operator <<=(unsigned short);
-    bigbigint operator <<=(char);
-    bigbigint operator <<=(unsigned char);
-
-    // Bitwise Right Shift Operators
+    bigbigint &operator <<=(int);
+    bigbigint &operator <<=(unsigned int);
+    bigbigint &operator <<=(long);
+    bigbigint &operator <<=(unsigned long);
+    bigbigint &operator <<=(short);
+    bigbigint &operator <<=(unsigned short);
+    bigbigint &operator <<=(char);
+    bigbigint &operator <<=(unsigned char);
+
+    // Bitwise Right Shift Operators (negative values round down, -5 >> 1 == -3)
     bigbigint operator >>(int);
     bigbigint operator >>(unsigned int);
     bigbigint operator >>(long);
@@ -340,17 +609,42 @@ public:
     bigbigint operator >>(unsigned char);
 
     // Bitwise Right Shift / Assignment
-    bigbigint operator >>=(int);
-    bigbigint operator >>=(unsigned int);
-    bigbigint operator >>=(long);
-    bigbigint operator >>=(unsigned long);
-    bigbigint operator >>=(short);
-    bigbigint operator >>=(unsigned short);
-    bigbigint operator >>=(char);
-    bigbigint operator >>=(unsigned char);
+    bigbigint &operator >>=(int);
+    bigbigint &operator >>=(unsigned int);
+    bigbigint &operator >>=(long);
+    bigbigint &operator >>=(unsigned long);
+    bigbigint &operator >>=(short);
+    bigbigint &operator >>=(unsigned short);
+    bigbigint &operator >>=(char);
+    bigbigint &operator >>=(unsigned char);
+
+    // Bitwise And Operator
+    bigbigint operator &(const bigbigint &);
+    bigbigint operator &(int);
+    bigbigint operator &(unsigned int);
+    bigbigint operator &(long);
+    bigbigint operator &(unsigned long);
+    bigbigint operator &(short);
+    bigbigint operator &(unsigned short);
+    bigbigint operator &(char);
+    bigbigint operator &(unsigned char);
+    bigbigint operator &(float);
+    bigbigint operator &(double);
+
+    bigbigint &operator &=(const bigbigint &);
+    bigbigint &operator &=(int);
+    bigbigint &operator &=(unsigned int);
+    bigbigint &operator &=(long);
+    bigbigint &operator &=(unsigned long);
+    bigbigint &operator &=(short);
+    bigbigint &operator &=(unsigned short);
+    bigbigint &operator &=(char);
+    bigbigint &operator &=(unsigned char);
+    bigbigint &operator &=(float);
+    bigbigint &operator &=(double);
 
     // Bitwise Or Operator
-    bigbigint operator |(bigbigint);
+    bigbigint operator |(const bigbigint &);
     bigbigint operator |(int);
     bigbigint operator |(unsigned int);
     bigbigint operator |(long);
@@ -362,37 +656,53 @@ public:
     bigbigint operator |(float);
     bigbigint operator |(double);
 
-    bigbigint operator |=(bigbigint);
-    bigbigint operator |=(int);
-    bigbigint operator |=(unsigned int);
-    bigbigint operator |=(long);
-    bigbigint operator |=(unsigned long);
-    bigbigint operator |=(short);
-    bigbigint operator |=(unsigned short);
-    bigbigint operator |=(char);
-    bigbigint operator |=(unsigned char);
-    bigbigint operator |=(float);
-    bigbigint operator |=(double);
+    bigbigint &operator |=(const bigbigint &);
+    bigbigint &operator |=(int);
+    bigbigint &operator |=(unsigned int);
+    bigbigint &operator |=(long);
+    bigbigint &operator |=(unsigned long);
+    bigbigint &operator |=(short);
+    bigbigint &operator |=(unsigned short);
+    bigbigint &operator |=(char);
+    bigbigint &operator |=(unsigned char);
+    bigbigint &operator |=(float);
+    bigbigint &operator |=(double);
+
+    // Bitwise Xor Operator
+    bigbigint operator ^(const bigbigint &);
+    bigbigint operator ^(int);
+    bigbigint operator ^(unsigned int);
+    bigbigint operator ^(long);
+    bigbigint operator ^(unsigned long);
+    bigbigint operator ^(short);
+    bigbigint operator ^(unsigned short);
+    bigbigint operator ^(char);
+    bigbigint operator ^(unsigned char);
+    bigbigint operator ^(float);
+    bigbigint operator ^(double);
+
+    bigbigint &operator ^=(const bigbigint &);
+    bigbigint &operator ^=(int);
+    bigbigint &operator ^=(unsigned int);
+    bigbigint &operator ^=(long);
+    bigbigint &operator ^=(unsigned long);
+    bigbigint &operator ^=(short);
+    bigbigint &operator ^=(unsigned short);
+    bigbigint &operator ^=(char);
+    bigbigint &operator ^=(unsigned char);
+    bigbigint &operator ^=(float);
+    bigbigint &operator ^=(double);
+
+    // Bitwise Not (two's complement, ~x == -x - 1)
+    bigbigint operator ~() const;
 
     // Unary Operators
     bigbigint operator -();
-    bigbigint operator --(void);   //Prefix
-    bigbigint operator ++(void);   
+    bigbigint &operator --(void);   //Prefix
+    bigbigint &operator ++(void);   
     bigbigint operator --(int);    //Postfix
     bigbigint operator ++(int);   
-    bool operator !();
-
-/*
-    -----------
-    TODO
-    -----------
-
-    %
-    %=
-    &
-
-
-*/
+    bool operator !() const;
 
 
 // -----
@@ -403,26 +713,163 @@ private:
 //
 //  VARIABLES
 //
-    unsigned char * _first_byte;
+    BBI_BASE_TYPE * _limbs;     // least significant limb first
     unsigned long _num_bytes;
-    unsigned long _length;
+    unsigned long _length;      // number of limbs allocated
     unsigned char _flags;
+    unsigned char _storage;     // where _limbs came from
 
     // Flags for the _flags value...
     #define BBI_NEGATIVE 0x01
     #define IS_NEGATIVE(__value)  (__value & BBI_NEGATIVE)
 
+    // ...and the _storage values
+    #define BBI_STORAGE_MALLOC      0
+    #define BBI_STORAGE_MAPPED      1   // a file mapping (load_mapped)
+    #define BBI_STORAGE_BORROWED    2   // a view's limbs, never written
+    #define BBI_STORAGE_MAPPED_READ 3   // a read-only file mapping, moved 
+                                        // to the heap by the first write
+
 //
 //  FUNCTIONS
 //
     void _constructor(long size);
+
+    // A read-only bigbigint over a view's limbs, so the code that 
+    // takes a bigbigint can be run on a view without copying it.  
+    // Nothing must change it.
+    enum _borrow_tag { _BORROW };
+    bigbigint(const bigbigint_view &view, _borrow_tag);
+
     void _free();
     void _malloc(unsigned long num_bytes);
     void _upsize(unsigned long new_length);
-    void zero_fill(unsigned long num_byts_to_fill);
+    void _presize(unsigned long new_length);
+    void _reserve(unsigned long new_length);
+    void _writable(bool keep = true);
+    void _swap(bigbigint &other);
+    unsigned long _size() const;
     void zero_fill();
+
+    // Expression evaluation (in place, no temporaries)
+    void _add_signed(const bigbigint &val, bool negate);
+    void _assign_sum(const bigbigint &val1, const bigbigint &val2, bool negate);
+    void _add_product(const bigbigint &val1, const bigbigint &val2, bool negate);
+    void _assign_product(const bigbigint &val1, const bigbigint &val2);
+
+    // In-place operations (the compound operators)
+    void _add_scalar(const void *value, unsigned long size, bool is_signed, bool negate);
+    void _step(bool down);
+    void _mul_scalar(const void *value, unsigned long size, bool is_signed);
+    void _div_scalar(const void *value, unsigned long size, bool is_signed);
+    BBI_BASE_TYPE _mod_scalar(const void *value, unsigned long size, bool is_signed) const;
+    void _mul_signed(const bigbigint &val);
+    void _shift_left(unsigned long Shift);
+    void _shift_right(unsigned long Shift);
+    void _bitwise(const BBI_BASE_TYPE *val, unsigned long val_size, bool val_negative, char op);
+    void _bitwise(const bigbigint &val, char op);
+    void _bitwise_scalar(const void *value, unsigned long size, bool is_signed, char op);
+
+    // compare() against a native integer
+    int _compare_scalar(const void *value, unsigned long size, bool is_signed) const;
+
+    // Text conversion helpers (digits only, already checked going in)
+    void _split_digits(unsigned long num_digits, bigbigint &quotient, 
+                       bigbigint &remainder, unsigned long &low_digits) const;
+    unsigned long _write_digits(char *out, unsigned long num_digits, 
+                                unsigned long space, int base, bool pad) const;
+    bool _emit_digits(bbi_digit_sink &sink, unsigned long num_digits, int base, bool pad) const;
+    void _read_digits(const char *digits, unsigned long num_digits, int base);
+    void _set_digits(const char *digits, unsigned long num_digits, int base, bool negative);
+
+    // The fixed-width variant converts straight from/to our storage
+    template <unsigned int __bits> friend class fixed_bigbigint;
+    template <class __lhs, class __rhs, char __op> friend class bbi_expr;
+    friend struct bbi_expr_traits<bigbigint>;
+    friend struct bbi_expr_traits<bigbigint_view>;
+    friend class bigbigint_view;
+
+    friend bbi_to_chars_result to_chars(char *first, char *last, const bigbigint &value, int base);
+    friend bbi_to_chars_result to_chars(char *first, char *last, const bigbigint_view &value, int base);
+    friend std::ostream &operator <<(std::ostream &os, const bigbigint_view &value);
+    friend bbi_from_chars_result from_chars(const char *first, const char *last, bigbigint &value, int base);
+    friend std::istream &operator >>(std::istream &is, bigbigint &value);
+};
+
+
+//-----------------------------------------------------------------------------
+//                            BigBigInt View
+//-----------------------------------------------------------------------------
+//
+//  A value whose limbs belong to someone else:  a pointer to the limbs
+//  (least significant first), how many there are and the sign.  Nothing
+//  is copied or freed, so the limbs can be in a mapped file, shared 
+//  memory or the middle of a bigger array, and must outlive the view.
+//  A bigbigint converts to one for free.
+//
+//  Views are read only.  They compare, answer bit queries, convert to
+//  text, hash, and take part in +, - and * expressions as operands:
+//
+//      bigbigint_view a(limbs, 1024), b(limbs + 1024, 1024);
+//      bigbigint x = a * b + c;        // no copies of a or b
+//
+class bigbigint_view
+{
+public:
+    bigbigint_view();
+    bigbigint_view(const BBI_BASE_TYPE *limbs, unsigned long num_limbs, bool negative = false);
+    bigbigint_view(const bigbigint &val);
+
+    const BBI_BASE_TYPE *limbs() const { return _limbs; }
+    unsigned long size() const { return _size; }        // limbs in use
+    bool is_negative() const { return _negative; }
+
+    int compare(const bigbigint_view &CompVal) const;
+
+    unsigned long bit_length() const;
+    unsigned long popcount() const;
+    unsigned long count_trailing_zeros() const;
+    bool test_bit(unsigned long bit) const;
+
+    std::string to_string(int base = 10) const;
+    unsigned long digits_upper_bound(int base = 10) const;
+    bool write_text(bbi_digit_sink &sink, int base = 10) const;
+
+    // Equal values hash the same, whatever holds them
+    size_t hash() const;
+
+private:
+    const BBI_BASE_TYPE *_limbs;
+    unsigned long _size;        // without the zero limbs on top
+    bool _negative;             // never set for zero
+
+    friend struct bbi_expr_traits<bigbigint_view>;
+    friend class bigbigint;
 };
 
+//  Comparisons between views (and so bigbigints mixed with views)
+inline bool operator ==(const bigbigint_view &val1, const bigbigint_view &val2) { return val1.compare(val2) == 0; }
+inline bool operator !=(const bigbigint_view &val1, const bigbigint_view &val2) { return val1.compare(val2) != 0; }
+inline bool operator <(const bigbigint_view &val1, const bigbigint_view &val2)  { return val1.compare(val2) < 0; }
+inline bool operator <=(const bigbigint_view &val1, const bigbigint_view &val2) { return val1.compare(val2) <= 0; }
+inline bool operator >(const bigbigint_view &val1, const bigbigint_view &val2)  { return val1.compare(val2) > 0; }
+inline bool operator >=(const bigbigint_view &val1, const bigbigint_view &val2) { return val1.compare(val2) >= 0; }
+
+namespace std
+{
+    template <>
+    struct hash<bigbigint_view>
+    {
+        size_t operator ()(const bigbigint_view &val) const { return val.hash(); }
+    };
+
+    template <>
+    struct hash<bigbigint>
+    {
+        size_t operator ()(const bigbigint &val) const { return bigbigint_view(val).hash(); }
+    };
+}
+
 
 //-----------------------------------------------------------------------------
 //                 Non-Member Functions (operator overloads)
@@ -494,7 +941,7 @@ unsigned int operator *=( unsigned int &PlusVal, bigbigint &ValB);
 long operator *=( long& PlusVal, bigbigint &ValB);
 unsigned long operator *=( unsigned long& PlusVal, bigbigint &ValB);
 short operator *=( short& PlusVal, bigbigint &ValB);
-unsigned short operator *=( unsigned short vPlusVal, bigbigint &ValB);
+unsigned short operator *=( unsigned short &vPlusVal, bigbigint &ValB);
 char operator *=( char &PlusVal, bigbigint &ValB);
 unsigned char operator *=( unsigned char &PlusVal, bigbigint &ValB);
 float operator *=( float &PlusVal, bigbigint &ValB);
@@ -518,95 +965,119 @@ unsigned int operator /=( unsigned int &PlusVal, bigbigint &ValB);
 long operator /=( long& PlusVal, bigbigint &ValB);
 unsigned long operator /=( unsigned long& PlusVal, bigbigint &ValB);
 short operator /=( short& PlusVal, bigbigint &ValB);
-unsigned short operator /=( unsigned short vPlusVal, bigbigint &ValB);
+unsigned short operator /=( unsigned short &vPlusVal, bigbigint &ValB);
 char operator /=( char &PlusVal, bigbigint &ValB);
 unsigned char operator /=( unsigned char &PlusVal, bigbigint &ValB);
 float operator /=( float &PlusVal, bigbigint &ValB);
 double operator /=( double &PlusVal, bigbigint &ValB);
 
 //  <type> > [bigbigint]
-bool operator >(const int &SubVal, bigbigint &MyVal);
-bool operator >(const unsigned int &SubVal, bigbigint &MyVal);
-bool operator >(const long &SubVal, bigbigint &MyVal);
-bool operator >(const unsigned long &SubVal, bigbigint &MyVal);
-bool operator >(const short &SubVal, bigbigint &MyVal);
-bool operator >(const unsigned short &SubVal, bigbigint& MyVal);
-bool operator >(const char &SubVal, bigbigint &MyVal);
-bool operator >(const unsigned char &SubVal, bigbigint &MyVal);
-bool operator >(const float &SubVal, bigbigint& MyVal);
-bool operator >(const double &SubVal, bigbigint &MyVal);
+bool operator >(const int &SubVal, const bigbigint &MyVal);
+bool operator >(const unsigned int &SubVal, const bigbigint &MyVal);
+bool operator >(const long &SubVal, const bigbigint &MyVal);
+bool operator >(const unsigned long &SubVal, const bigbigint &MyVal);
+bool operator >(const short &SubVal, const bigbigint &MyVal);
+bool operator >(const unsigned short &SubVal, const bigbigint &MyVal);
+bool operator >(const char &SubVal, const bigbigint &MyVal);
+bool operator >(const unsigned char &SubVal, const bigbigint &MyVal);
+bool operator >(const float &SubVal, const bigbigint &MyVal);
+bool operator >(const double &SubVal, const bigbigint &MyVal);
 
 //  <type> >= [bigbigint]
-bool operator >=(const int &SubVal, bigbigint &MyVal);
-bool operator >=(const unsigned int &SubVal, bigbigint& MyVal);
-bool operator >=(const long &SubVal, bigbigint &MyVal);
-bool operator >=(const unsigned long &SubVal, bigbigint &MyVal);
-bool operator >=(const short &SubVal, bigbigint &MyVal);
-bool operator >=(const unsigned short &SubVal, bigbigint& MyVal);
-bool operator >=(const char &SubVal, bigbigint &MyVal);
-bool operator >=(const unsigned char &SubVal, bigbigint &MyVal);
-bool operator >=(const float &SubVal, bigbigint &MyVal);
-bool operator >=(const double &SubVal, bigbigint &MyVal);
+bool operator >=(const int &SubVal, const bigbigint &MyVal);
+bool operator >=(const unsigned int &SubVal, const bigbigint &MyVal);
+bool operator >=(const long &SubVal, const bigbigint &MyVal);
+bool operator >=(const unsigned long &SubVal, const bigbigint &MyVal);
+bool operator >=(const short &SubVal, const bigbigint &MyVal);
+bool operator >=(const unsigned short &SubVal, const bigbigint &MyVal);
+bool operator >=(const char &SubVal, const bigbigint &MyVal);
+bool operator >=(const unsigned char &SubVal, const bigbigint &MyVal);
+bool operator >=(const float &SubVal, const bigbigint &MyVal);
+bool operator >=(const double &SubVal, const bigbigint &MyVal);
 
 //  <type> < [bigbigint]
-bool operator <(const int &SubVal, bigbigint &MyVal);
-bool operator <(const unsigned int &SubVal, bigbigint &MyVal);
-bool operator <(const long &SubVal, bigbigint& MyVal);
-bool operator <(const unsigned long &SubVal, bigbigint &MyVal);
-bool operator <(const short &SubVal, bigbigint& MyVal);
-bool operator <(const unsigned short &SubVal, bigbigint &MyVal);
-bool operator <(const char &SubVal, bigbigint &MyVal);
-bool operator <(const unsigned char &SubVal, bigbigint &MyVal);
-bool operator <(const float &SubVal, bigbigint& MyVal);
-bool operator <(const double &SubVal, bigbigint &MyVal);
+bool operator <(const int &SubVal, const bigbigint &MyVal);
+bool operator <(const unsigned int &SubVal, const bigbigint &MyVal);
+bool operator <(const long &SubVal, const bigbigint &MyVal);
+bool operator <(const unsigned long &SubVal, const bigbigint &MyVal);
+bool operator <(const short &SubVal, const bigbigint &MyVal);
+bool operator <(const unsigned short &SubVal, const bigbigint &MyVal);
+bool operator <(const char &SubVal, const bigbigint &MyVal);
+bool operator <(const unsigned char &SubVal, const bigbigint &MyVal);
+bool operator <(const float &SubVal, const bigbigint &MyVal);
+bool operator <(const double &SubVal, const bigbigint &MyVal);
 
 //  <type> <= [bigbigint]
-bool operator <=(const int &SubVal, bigbigint &MyVal);
-bool operator <=(const unsigned int &SubVal, bigbigint &MyVal);
-bool operator <=(const long &SubVal, bigbigint& MyVal);
-bool operator <=(const unsigned long &SubVal, bigbigint &MyVal);
-bool operator <=(const short &SubVal, bigbigint& MyVal);
-bool operator <=(const unsigned short &SubVal, bigbigint &MyVal);
-bool operator <=(const char &SubVal, bigbigint &MyVal);
-bool operator <=(const unsigned char &SubVal, bigbigint &MyVal);
-bool operator <=(const float &SubVal, bigbigint& MyVal);
-bool operator <=(const double &SubVal, bigbigint &MyVal);
+bool operator <=(const int &SubVal, const bigbigint &MyVal);
+bool operator <=(const unsigned int &SubVal, const bigbigint &MyVal);
+bool operator <=(const long &SubVal, const bigbigint &MyVal);
+bool operator <=(const unsigned long &SubVal, const bigbigint &MyVal);
+bool operator <=(const short &SubVal, const bigbigint &MyVal);
+bool operator <=(const unsigned short &SubVal, const bigbigint &MyVal);
+bool operator <=(const char &SubVal, const bigbigint &MyVal);
+bool operator <=(const unsigned char &SubVal, const bigbigint &MyVal);
+bool operator <=(const float &SubVal, const bigbigint &MyVal);
+bool operator <=(const double &SubVal, const bigbigint &MyVal);
 
 //  <type> == [bigbigint]
-bool operator ==(const int &SubVal, bigbigint& MyVal);
-bool operator ==(const unsigned int &SubVal, bigbigint& MyVal);
-bool operator ==(const long &SubVal, bigbigint &MyVal);
-bool operator ==(const unsigned long &SubVal, bigbigint& MyVal);
-bool operator ==(const short &SubVal, bigbigint& MyVal);
-bool operator ==(const unsigned short &SubVal, bigbigint &MyVal);
-bool operator ==(const char &SubVal, bigbigint &MyVal);
-bool operator ==(const unsigned char &SubVal, bigbigint &MyVal);
-bool operator ==(const float &SubVal, bigbigint &MyVal);
-bool operator ==(const double &SubVal, bigbigint &MyVal);
+bool operator ==(const int &SubVal, const bigbigint &MyVal);
+bool operator ==(const unsigned int &SubVal, const bigbigint &MyVal);
+bool operator ==(const long &SubVal, const bigbigint &MyVal);
+bool operator ==(const unsigned long &SubVal, const bigbigint &MyVal);
+bool operator ==(const short &SubVal, const bigbigint &MyVal);
+bool operator ==(const unsigned short &SubVal, const bigbigint &MyVal);
+bool operator ==(const char &SubVal, const bigbigint &MyVal);
+bool operator ==(const unsigned char &SubVal, const bigbigint &MyVal);
+bool operator ==(const float &SubVal, const bigbigint &MyVal);
+bool operator ==(const double &SubVal, const bigbigint &MyVal);
 
 //  <type> != [bigbigint]
-bool operator !=(const int &SubVal, bigbigint &MyVal);
-bool operator !=(const unsigned int &SubVal, bigbigint &MyVal);
-bool operator !=(const long &SubVal, bigbigint &MyVal);
-bool operator !=(const unsigned long &SubVal, bigbigint& MyVal);
-bool operator !=(const short &SubVal, bigbigint &MyVal);
-bool operator !=(const unsigned short &SubVal, bigbigint& MyVal);
-bool operator !=(const char &SubVal, bigbigint& MyVal);
-bool operator !=(const unsigned char &SubVal, bigbigint &MyVal);
-bool operator !=(const float &SubVal, bigbigint& MyVal);
-bool operator !=(const double &SubVal, bigbigint &MyVal);
+bool operator !=(const int &SubVal, const bigbigint &MyVal);
+bool operator !=(const unsigned int &SubVal, const bigbigint &MyVal);
+bool operator !=(const long &SubVal, const bigbigint &MyVal);
+bool operator !=(const unsigned long &SubVal, const bigbigint &MyVal);
+bool operator !=(const short &SubVal, const bigbigint &MyVal);
+bool operator !=(const unsigned short &SubVal, const bigbigint &MyVal);
+bool operator !=(const char &SubVal, const bigbigint &MyVal);
+bool operator !=(const unsigned char &SubVal, const bigbigint &MyVal);
+bool operator !=(const float &SubVal, const bigbigint &MyVal);
+bool operator !=(const double &SubVal, const bigbigint &MyVal);
+
+//  <type> & [bigbigint]
+bigbigint operator &(const int &SubVal, const bigbigint &MyVal);
+bigbigint operator &(const unsigned int &SubVal, const bigbigint &MyVal);
+bigbigint operator &(const long &SubVal, const bigbigint &MyVal);
+bigbigint operator &(const unsigned long &SubVal, const bigbigint &MyVal);
+bigbigint operator &(const short &SubVal, const bigbigint &MyVal);
+bigbigint operator &(const unsigned short &SubVal, const bigbigint &MyVal);
+bigbigint operator &(const char &SubVal, const bigbigint &MyVal);
+bigbigint operator &(const unsigned char &SubVal, const bigbigint &MyVal);
+bigbigint operator &(const float &SubVal, const bigbigint &MyVal);
+bigbigint operator &(const double &SubVal, const bigbigint &MyVal);
 
 //  <type> | [bigbigint]
-bigbigint operator |(int &SubVal,  bigbigint& MyVal);
-bigbigint operator |(unsigned int &SubVal,  bigbigint& MyVal);
-bigbigint operator |(long &SubVal,  bigbigint &MyVal);
-bigbigint operator |(unsigned long &SubVal,  bigbigint &MyVal);
-bigbigint operator |(short &SubVal,  bigbigint& MyVal);
-bigbigint operator |(unsigned short &SubVal,  bigbigint &MyVal);
-bigbigint operator |(char &SubVal,  bigbigint &MyVal);
-bigbigint operator |(unsigned char &SubVal,  bigbigint &MyVal);
-bigbigint operator |(float &SubVal,  bigbigint &MyVal);
-bigbigint operator |(double &SubVal,  bigbigint vMyVal);
+bigbigint operator |(const int &SubVal, const bigbigint &MyVal);
+bigbigint operator |(const unsigned int &SubVal, const bigbigint &MyVal);
+bigbigint operator |(const long &SubVal, const bigbigint &MyVal);
+bigbigint operator |(const unsigned long &SubVal, const bigbigint &MyVal);
+bigbigint operator |(const short &SubVal, const bigbigint &MyVal);
+bigbigint operator |(const unsigned short &SubVal, const bigbigint &MyVal);
+bigbigint operator |(const char &SubVal, const bigbigint &MyVal);
+bigbigint operator |(const unsigned char &SubVal, const bigbigint &MyVal);
+bigbigint operator |(const float &SubVal, const bigbigint &MyVal);
+bigbigint operator |(const double &SubVal, const bigbigint &MyVal);
+
+//  <type> ^ [bigbigint]
+bigbigint operator ^(const int &SubVal, const bigbigint &MyVal);
+bigbigint operator ^(const unsigned int &SubVal, const bigbigint &MyVal);
+bigbigint operator ^(const long &SubVal, const bigbigint &MyVal);
+bigbigint operator ^(const unsigned long &SubVal, const bigbigint &MyVal);
+bigbigint operator ^(const short &SubVal, const bigbigint &MyVal);
+bigbigint operator ^(const unsigned short &SubVal, const bigbigint &MyVal);
+bigbigint operator ^(const char &SubVal, const bigbigint &MyVal);
+bigbigint operator ^(const unsigned char &SubVal, const bigbigint &MyVal);
+bigbigint operator ^(const float &SubVal, const bigbigint &MyVal);
+bigbigint operator ^(const double &SubVal, const bigbigint &MyVal);
 
 
 
@@ -618,6 +1089,9 @@ bigbigint operator |(double &SubVal,  bigbigint vMyVal);
 //  The three XOR_Equal operations do the actual
 //  flip-flop of the bytes.  As long as it's a type
 //  on which we can do a SIZEOF(), this will work
+//
+//  (Only kept for old code.  Whole numbers go to and from byte 
+//  strings with import_words / export_words.)
 #if !defined(MEM_ARCH_USES_BIG_ENDIAN)
     #define REVERSE_BYTE_ORDER(__value)         \
         {           \
@@ -635,17 +1109,6 @@ bigbigint operator |(double &SubVal,  bigbigint vMyVal);
 #endif
 
 
-//
-//  This performs a basic 1's compliment (bitwise NOT)
-#define ONES_COMPLEMENT(__big_int_value)    \
-    {                                       \
-        unsigned long _i;                   \
-        for(_i = 0; _i < __big_int_value._length; _i++) {               \
-            ((BBI_BASE_TYPE*)__big_int_value._first_byte)[_i] =         \
-                    ~((BBI_BASE_TYPE*)__big_int_value._first_byte)[_i]; \
-        }                                   \
-    }
-
 //
 //  Basic MIN and MAX macros
 #ifndef MIN
@@ -660,4 +1123,11 @@ bigbigint operator |(double &SubVal,  bigbigint vMyVal);
     #define ABS(x)  ((x) < 0 ? -(x) : (x))
 #endif
 
+
+//-----------------------------------------------------------------------------
+//                          Expression Templates
+//-----------------------------------------------------------------------------
+
+#include "BigBigIntExpr.h"
+
 #endif
\ No newline at end of file
@@ -0,0 +1,452 @@
+// ------------------------------------------------------------
+//  BigBigIntBench.cpp
+//
+//  Created by Richard Andrasek
+//
+//  Purpose:
+//      Micro-benchmarks for the bigbigint class.  Every operation is
+//  timed on operands from 1 limb up to 10M bits (156250 limbs), and
+//  reported as ns per operation and limbs per ns.  The results can
+//  be written out as JSON and compared against an earlier run to
+//  catch regressions.
+//
+//  Build it with the library, optimised, e.g.
+//
+//      g++ -O2 -march=native BigBigIntBench.cpp BigBigInt.cpp
+//          BigBigIntMpn.cpp -pthread -o bbi_bench
+//
+//  and run it as
+//
+//      bbi_bench [options]
+//          --json FILE         write the results to FILE
+//          --baseline FILE     compare against an earlier --json FILE;
+//                              exits with 1 if anything got slower
+//          --tolerance PCT     how much slower counts (default 10)
+//          --min-time SEC      time each case for at least SEC
+//                              (default 0.2)
+//          --max-bits N        largest operand (default 10000000)
+//          --op NAME           only the operations starting with NAME
+//          --threads N         multiply on N threads (0 for one per
+//                              core; see bigbigint::set_mul_threads)
+//          --quick             --min-time 0.02
+//
+//  The quadratic operations (division, decimal text) and powmod stop
+//  at smaller sizes; see bench_ops.
+//
+//  The JSON is one result per line, so it diffs well:
+//
+//      {"op": "mul", "limbs": 64, "ns_per_op": 812.4, "limbs_per_ns": 0.0788},
+//
+// ------------------------------------------------------------
+#include "BigBigInt.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+
+/*******************************************
+ *               OPERANDS                  *
+ *******************************************/
+//
+//  Every operation gets the same operands for a size:  a and b of n
+//  limbs, a dividend of 2n limbs, and the text of a.  They're random
+//  (with the top bit set, so the size is exact), built from raw
+//  words with import_words.
+//
+
+struct bench_operands
+{
+    unsigned long limbs;
+    bigbigint a, b, dividend, small_mod, result;
+    std::string decimal, hex;
+    BBI_BASE_TYPE scalar;
+};
+
+static BBI_BASE_TYPE bench_random_state = 0x9E3779B97F4A7C15ULL;
+
+static BBI_BASE_TYPE bench_random()
+{
+    // xorshift64*
+    bench_random_state ^= bench_random_state >> 12;
+    bench_random_state ^= bench_random_state << 25;
+    bench_random_state ^= bench_random_state >> 27;
+    return bench_random_state * 0x2545F4914F6CDD1DULL;
+}
+
+static void bench_random_value(bigbigint &value, unsigned long limbs)
+{
+    std::vector<BBI_BASE_TYPE> words(limbs);
+    unsigned long i;
+
+    for (i = 0; i < limbs; i++) {
+        words[i] = bench_random();
+    }
+    words[limbs - 1] |= (BBI_BASE_TYPE)1 << (BBI_BASE_BITS - 1);
+    value.import_words(limbs, -1, sizeof(BBI_BASE_TYPE), 0, &words[0]);
+}
+
+static void bench_setup(bench_operands &ops, unsigned long limbs, bool need_text)
+{
+    ops.limbs = limbs;
+    bench_random_value(ops.a, limbs);
+    bench_random_value(ops.b, limbs);
+    bench_random_value(ops.dividend, 2 * limbs);
+    bench_random_value(ops.small_mod, MIN(limbs, 64UL));
+    ops.scalar = bench_random() | 1;
+    ops.decimal.clear();
+    ops.hex.clear();
+    if (need_text) {
+        ops.decimal = ops.a.to_string(10);
+        ops.hex = ops.a.to_string(16);
+    }
+}
+
+
+/*******************************************
+ *              OPERATIONS                 *
+ *******************************************/
+//
+//  One call is one operation.  The result goes into ops.result (or
+//  a static) so the compiler can't drop the work.
+//
+
+static volatile long bench_sink;
+
+static void op_add(bench_operands &o)       { o.result = o.a + o.b; }
+static void op_sub(bench_operands &o)       { o.result = o.a - o.b; }
+static void op_add_assign(bench_operands &o) { o.result += o.a; }
+static void op_mul(bench_operands &o)       { o.result = o.a * o.b; }
+static void op_sqr(bench_operands &o)       { o.result = o.a * o.a; }
+static void op_muladd(bench_operands &o)    { o.result = o.a * o.b + o.a; }
+static void op_div(bench_operands &o)       { o.result = o.dividend / o.b; }
+static void op_mod(bench_operands &o)       { o.result = o.dividend % o.b; }
+static void op_shl(bench_operands &o)       { o.result = o.a << 77; }
+static void op_shr(bench_operands &o)       { o.result = o.a >> 77; }
+static void op_shl_assign(bench_operands &o) { o.result = o.a; o.result <<= 77; }
+static void op_and(bench_operands &o)       { o.result = o.a & o.b; }
+static void op_or(bench_operands &o)        { o.result = o.a | o.b; }
+static void op_xor(bench_operands &o)       { o.result = o.a ^ o.b; }
+static void op_compare(bench_operands &o)   { bench_sink = bench_sink + o.a.compare(o.b); }
+static void op_equal(bench_operands &o)     { bench_sink = bench_sink + (o.a == o.a); }
+static void op_popcount(bench_operands &o)  { bench_sink = bench_sink + (long)o.a.popcount(); }
+static void op_add_ui(bench_operands &o)    { o.result = o.a + (unsigned long)o.scalar; }
+static void op_sub_ui(bench_operands &o)    { o.result = o.a - (unsigned long)o.scalar; }
+static void op_mul_ui(bench_operands &o)    { o.result = o.a * (unsigned long)o.scalar; }
+static void op_div_ui(bench_operands &o)    { o.result = o.a / (unsigned long)o.scalar; }
+static void op_mod_ui(bench_operands &o)    { o.result = o.a % (unsigned long)o.scalar; }
+static void op_mul_assign_ui(bench_operands &o) { o.result = o.a; o.result *= (unsigned long)o.scalar; }
+static void op_increment(bench_operands &o) { ++o.result; }
+static void op_compare_ui(bench_operands &o) { bench_sink = bench_sink + (o.a > (unsigned long)o.scalar); }
+static void op_to_string10(bench_operands &o) { bench_sink = bench_sink + (long)o.a.to_string(10).size(); }
+static void op_to_string16(bench_operands &o) { bench_sink = bench_sink + (long)o.a.to_string(16).size(); }
+static void op_from_string10(bench_operands &o) { o.result.from_string(o.decimal, 10); }
+static void op_from_string16(bench_operands &o) { o.result.from_string(o.hex, 16); }
+static void op_to_double(bench_operands &o) { bench_sink = bench_sink + (long)(double)o.a; }
+static void op_powmod(bench_operands &o)    { o.result = o.b.powmod(o.a, o.small_mod); }
+
+//
+//  max_limbs keeps the slow operations to sizes that finish in a
+//  sensible time (--max-bits still applies on top).  The powmod
+//  exponent is a, so its cost is cubic in the size; the modulus
+//  stops growing at 64 limbs.
+struct bench_op
+{
+    const char *name;
+    void (*run)(bench_operands &);
+    unsigned long max_limbs;
+    bool needs_text;
+};
+
+static const bench_op bench_ops[] = {
+    { "add",            op_add,             ~0UL,   false },
+    { "sub",            op_sub,             ~0UL,   false },
+    { "add_assign",     op_add_assign,      ~0UL,   false },
+    { "mul",            op_mul,             ~0UL,   false },
+    { "sqr",            op_sqr,             ~0UL,   false },
+    { "muladd",         op_muladd,          ~0UL,   false },
+    { "div",            op_div,             16384,  false },
+    { "mod",            op_mod,             16384,  false },
+    { "shl",            op_shl,             ~0UL,   false },
+    { "shr",            op_shr,             ~0UL,   false },
+    { "shl_assign",     op_shl_assign,      ~0UL,   false },
+    { "and",            op_and,             ~0UL,   false },
+    { "or",             op_or,              ~0UL,   false },
+    { "xor",            op_xor,             ~0UL,   false },
+    { "compare",        op_compare,         ~0UL,   false },
+    { "equal",          op_equal,           ~0UL,   false },
+    { "popcount",       op_popcount,        ~0UL,   false },
+    { "add_ui",         op_add_ui,          ~0UL,   false },
+    { "sub_ui",         op_sub_ui,          ~0UL,   false },
+    { "mul_ui",         op_mul_ui,          ~0UL,   false },
+    { "mul_assign_ui",  op_mul_assign_ui,   ~0UL,   false },
+    { "div_ui",         op_div_ui,          ~0UL,   false },
+    { "mod_ui",         op_mod_ui,          ~0UL,   false },
+    { "increment",      op_increment,       ~0UL,   false },
+    { "compare_ui",     op_compare_ui,      ~0UL,   false },
+    { "to_double",      op_to_double,       ~0UL,   false },
+    { "to_string10",    op_to_string10,     32768,  false },
+    { "to_string16",    op_to_string16,     ~0UL,   false },
+    { "from_string10",  op_from_string10,   32768,  true },
+    { "from_string16",  op_from_string16,   ~0UL,   true },
+    { "powmod",         op_powmod,          64,     false },
+};
+
+#define BENCH_NUM_OPS   (sizeof(bench_ops) / sizeof(bench_ops[0]))
+
+
+/*******************************************
+ *                TIMING                   *
+ *******************************************/
+
+struct bench_result
+{
+    std::string op;
+    unsigned long limbs;
+    double ns_per_op;
+};
+
+static double bench_seconds()
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//
+//  Runs the operation in batches, doubling the batch until one takes
+//  min_time, and reports the best of three batches of that size (the
+//  least disturbed by everything else on the machine).
+static double bench_time(const bench_op &op, bench_operands &ops, double min_time)
+{
+    unsigned long batch, i;
+    double start, elapsed, best;
+    int round;
+
+    // Warm up (first touch of the result, the scratch stack, the
+    // radix power cache)
+    ops.result = ops.a;
+    op.run(ops);
+
+    batch = 1;
+    for (;;) {
+        ops.result = ops.a;
+        start = bench_seconds();
+        for (i = 0; i < batch; i++) {
+            op.run(ops);
+        }
+        elapsed = bench_seconds() - start;
+        if (elapsed >= min_time || batch >= (1UL << 30)) {
+            break;
+        }
+        // Jump close to the right size once there's something to go on
+        if (elapsed > min_time / 100) {
+            batch = (unsigned long)(batch * (min_time / elapsed) * 1.1) + 1;
+        }
+        else {
+            batch *= 8;
+        }
+    }
+
+    best = elapsed;
+    for (round = 0; round < 2; round++) {
+        ops.result = ops.a;
+        start = bench_seconds();
+        for (i = 0; i < batch; i++) {
+            op.run(ops);
+        }
+        elapsed = bench_seconds() - start;
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return (best * 1e9) / batch;
+}
+
+
+/*******************************************
+ *            JSON / BASELINE              *
+ *******************************************/
+
+static bool bench_write_json(const char *path, const std::vector<bench_result> &results)
+{
+    FILE *out;
+    unsigned long i;
+
+    out = fopen(path, "w");
+    if (out == NULL) {
+        return false;
+    }
+    fprintf(out, "{\n\"results\": [\n");
+    for (i = 0; i < results.size(); i++) {
+        fprintf(out, "{\"op\": \"%s\", \"limbs\": %lu, \"ns_per_op\": %.3f, \"limbs_per_ns\": %.6g}%s\n",
+                results[i].op.c_str(), results[i].limbs, results[i].ns_per_op,
+                results[i].limbs / results[i].ns_per_op,
+                (i + 1 < results.size() ? "," : ""));
+    }
+    fprintf(out, "]\n}\n");
+    return (fclose(out) == 0);
+}
+
+//
+//  Reads back what bench_write_json wrote (one result per line; any
+//  other line is skipped)
+static bool bench_read_json(const char *path, std::vector<bench_result> &results)
+{
+    char line[512], name[128];
+    bench_result result;
+    FILE *in;
+
+    in = fopen(path, "r");
+    if (in == NULL) {
+        return false;
+    }
+    while (fgets(line, sizeof(line), in) != NULL) {
+        if (sscanf(line, "{\"op\": \"%127[^\"]\", \"limbs\": %lu, \"ns_per_op\": %lf",
+                   name, &result.limbs, &result.ns_per_op) == 3) {
+            result.op = name;
+            results.push_back(result);
+        }
+    }
+    fclose(in);
+    return true;
+}
+
+static const bench_result *bench_find(const std::vector<bench_result> &results,
+                                      const std::string &op, unsigned long limbs)
+{
+    unsigned long i;
+
+    for (i = 0; i < results.size(); i++) {
+        if (results[i].op == op && results[i].limbs == limbs) {
+            return &results[i];
+        }
+    }
+    return NULL;
+}
+
+
+/*******************************************
+ *                 MAIN                    *
+ *******************************************/
+
+static void bench_usage()
+{
+    fprintf(stderr, "usage: bbi_bench [--json FILE] [--baseline FILE] [--tolerance PCT]\n"
+                    "                 [--min-time SEC] [--max-bits N] [--op NAME] [--threads N]\n"
+                    "                 [--quick]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *json_path, *baseline_path, *only_op;
+    double min_time, tolerance, change;
+    unsigned long max_bits, limbs, size, i, regressions;
+    std::vector<unsigned long> sizes;
+    std::vector<bench_result> results, baseline;
+    const bench_result *before;
+    bench_operands ops;
+    bench_result result;
+    int arg;
+    bool need_text;
+
+    json_path = NULL;
+    baseline_path = NULL;
+    only_op = NULL;
+    min_time = 0.2;
+    tolerance = 10;
+    max_bits = 10000000;
+    for (arg = 1; arg < argc; arg++) {
+        if (strcmp(argv[arg], "--quick") == 0) {
+            min_time = 0.02;
+        }
+        else if (arg + 1 >= argc) {
+            bench_usage();
+        }
+        else if (strcmp(argv[arg], "--json") == 0) {
+            json_path = argv[++arg];
+        }
+        else if (strcmp(argv[arg], "--baseline") == 0) {
+            baseline_path = argv[++arg];
+        }
+        else if (strcmp(argv[arg], "--tolerance") == 0) {
+            tolerance = atof(argv[++arg]);
+        }
+        else if (strcmp(argv[arg], "--min-time") == 0) {
+            min_time = atof(argv[++arg]);
+        }
+        else if (strcmp(argv[arg], "--max-bits") == 0) {
+            max_bits = strtoul(argv[++arg], NULL, 10);
+        }
+        else if (strcmp(argv[arg], "--op") == 0) {
+            only_op = argv[++arg];
+        }
+        else if (strcmp(argv[arg], "--threads") == 0) {
+            bigbigint::set_mul_threads((unsigned int)strtoul(argv[++arg], NULL, 10));
+        }
+        else {
+            bench_usage();
+        }
+    }
+    if (baseline_path != NULL && !bench_read_json(baseline_path, baseline)) {
+        fprintf(stderr, "bbi_bench: can't read %s\n", baseline_path);
+        return 2;
+    }
+
+    // 1, 2, 4, ... limbs, then exactly 10M bits
+    for (limbs = 1; limbs * BBI_BASE_BITS <= max_bits; limbs *= 2) {
+        sizes.push_back(limbs);
+    }
+    limbs = (max_bits + BBI_BASE_BITS - 1) / BBI_BASE_BITS;
+    if (sizes.empty() || sizes.back() != limbs) {
+        sizes.push_back(limbs);
+    }
+
+    printf("%-16s %10s %16s %12s%s\n", "op", "limbs", "ns/op", "limbs/ns",
+           (baseline_path != NULL ? "    vs baseline" : ""));
+    regressions = 0;
+    for (size = 0; size < sizes.size(); size++) {
+        limbs = sizes[size];
+        need_text = false;
+        for (i = 0; i < BENCH_NUM_OPS; i++) {
+            if (bench_ops[i].needs_text && limbs <= bench_ops[i].max_limbs) {
+                need_text = true;
+            }
+        }
+        bench_setup(ops, limbs, need_text);
+
+        for (i = 0; i < BENCH_NUM_OPS; i++) {
+            if (limbs > bench_ops[i].max_limbs) continue;
+            if (only_op != NULL && strncmp(bench_ops[i].name, only_op, strlen(only_op)) != 0) continue;
+
+            result.op = bench_ops[i].name;
+            result.limbs = limbs;
+            result.ns_per_op = bench_time(bench_ops[i], ops, min_time);
+            results.push_back(result);
+
+            printf("%-16s %10lu %16.1f %12.4g", result.op.c_str(), result.limbs,
+                   result.ns_per_op, result.limbs / result.ns_per_op);
+            before = bench_find(baseline, result.op, result.limbs);
+            if (before != NULL) {
+                change = ((result.ns_per_op / before->ns_per_op) - 1) * 100;
+                printf("    %+7.1f%%%s", change, (change > tolerance ? "  REGRESSION" : ""));
+                if (change > tolerance) {
+                    regressions++;
+                }
+            }
+            printf("\n");
+            fflush(stdout);
+        }
+    }
+
+    if (json_path != NULL && !bench_write_json(json_path, results)) {
+        fprintf(stderr, "bbi_bench: can't write %s\n", json_path);
+        return 2;
+    }
+    if (baseline_path != NULL) {
+        printf("%lu regression%s over %.0f%%\n", regressions, (regressions == 1 ? "" : "s"), tolerance);
+    }
+    return (regressions != 0 ? 1 : 0);
+}
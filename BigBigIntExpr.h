@@ -0,0 +1,435 @@
+/*
+ * Name:    BigBigIntExpr.h
+ * Purpose: Expression templates for the bigbigint class
+ *
+ * Author:  Richard Andrasek
+ * Date:    18-Oct-2026
+ *
+ *  Note: this is included at the bottom of BigBigInt.h.  Don't
+ *  include it directly.
+ */
+
+#ifndef __Andrasek_BigBigIntExpr_hpp__
+#define __Andrasek_BigBigIntExpr_hpp__
+
+//-----------------------------------------------------------------------------
+//                            Required Includes
+//-----------------------------------------------------------------------------
+
+#include <type_traits>
+
+//-----------------------------------------------------------------------------
+//                                 Notes
+//-----------------------------------------------------------------------------
+//
+//  bigbigint +, - and * (between two bigbigints) don't compute anything
+//  on their own.  They return a small proxy (bbi_expr) that remembers
+//  the operands, so that a statement like
+//
+//      x = a*b + c*d - e;
+//
+//  builds a tree of proxies, and the work is done once the tree lands
+//  in a bigbigint (the constructor, =, += or -=).  At that point:
+//
+//   - the destination is sized once, from the worst-case limb count
+//     of the whole tree,
+//   - the first term is written straight into the destination,
+//   - every other term is added (or subtracted) in place, and a
+//     product term is accumulated with a fused multiply-add, so the
+//     product itself never exists on its own.
+//
+//  The only time a temporary is needed is for a product whose operand
+//  is itself a sum or difference, e.g. (a+b)*c.  If the destination
+//  is also one of the operands (a = b*a), the tree is evaluated into
+//  a temporary that is then swapped in (no copy).
+//
+//  The proxies hold references to their bigbigint operands, so they
+//  must not outlive the statement that made them (auto x = a + b;
+//  leaves x dangling).  A bigbigint_view works as an operand too, 
+//  with its limbs used where they are.
+//
+//  Anything else an expression is used with (/, comparisons, shifts,
+//  native types, ...) evaluates it into a bigbigint first, so
+//  existing code keeps working unchanged.
+//
+
+#define BBI_EXPR_ADD    '+'
+#define BBI_EXPR_SUB    '-'
+#define BBI_EXPR_MUL    '*'
+
+
+//-----------------------------------------------------------------------------
+//                          Operand Traits
+//-----------------------------------------------------------------------------
+//
+//  Every operand type (a bigbigint, a view, a nested expression or the
+//  zero used for unary minus) tells the expression how to:
+//      limbs()      - upper bound on the number of limbs in its value
+//      aliases()    - whether a given bigbigint is one of its operands
+//      assign()     - dest = value
+//      accumulate() - dest += value  (or -= if negate is set)
+//  and provides an "operand" holder that gives a multiplication a
+//  plain bigbigint to work with.
+//
+
+//  Zero (the left side of -expr)
+struct bbi_expr_zero {};
+
+template <>
+struct bbi_expr_traits<bigbigint>
+{
+    typedef const bigbigint & stored_type;
+
+    struct operand
+    {
+        const bigbigint &val;
+        operand(const bigbigint &value) : val(value) {}
+    };
+
+    static unsigned long limbs(const bigbigint &val) { return val._size(); }
+
+    static bool aliases(const bigbigint &val, const bigbigint *dest) { return (&val == dest); }
+
+    static void assign(const bigbigint &val, bigbigint &dest) { dest = val; }
+
+    static void accumulate(const bigbigint &val, bigbigint &dest, bool negate)
+    {
+        dest._add_signed(val, negate);
+    }
+
+    static void clear(bigbigint &dest)
+    {
+        dest.zero_fill();
+        dest._flags = 0;
+    }
+};
+
+//  A view is held by value (it's only a pointer and a size), and lends
+//  its limbs to a read-only bigbigint when one is needed.  It aliases
+//  the destination if their limbs overlap at all.
+template <>
+struct bbi_expr_traits<bigbigint_view>
+{
+    typedef bigbigint_view stored_type;
+
+    struct operand
+    {
+        const bigbigint val;
+        operand(const bigbigint_view &view) : val(view, bigbigint::_BORROW) {}
+    };
+
+    static unsigned long limbs(const bigbigint_view &view) { return view._size; }
+
+    static bool aliases(const bigbigint_view &view, const bigbigint *dest)
+    {
+        return (view._limbs < dest->_limbs + dest->_length && 
+                dest->_limbs < view._limbs + view._size);
+    }
+
+    static void assign(const bigbigint_view &view, bigbigint &dest)
+    {
+        operand tVal(view);
+        dest = tVal.val;
+    }
+
+    static void accumulate(const bigbigint_view &view, bigbigint &dest, bool negate)
+    {
+        operand tVal(view);
+        dest._add_signed(tVal.val, negate);
+    }
+};
+
+template <>
+struct bbi_expr_traits<bbi_expr_zero>
+{
+    typedef bbi_expr_zero stored_type;
+
+    struct operand
+    {
+        bigbigint val;
+        operand(const bbi_expr_zero &) {}
+    };
+
+    static unsigned long limbs(const bbi_expr_zero &) { return 0; }
+    static bool aliases(const bbi_expr_zero &, const bigbigint *) { return false; }
+    static void assign(const bbi_expr_zero &, bigbigint &dest) { bbi_expr_traits<bigbigint>::clear(dest); }
+    static void accumulate(const bbi_expr_zero &, bigbigint &, bool) {}
+};
+
+template <class __lhs, class __rhs, char __op>
+struct bbi_expr_traits< bbi_expr<__lhs, __rhs, __op> >
+{
+    typedef bbi_expr<__lhs, __rhs, __op> stored_type;
+
+    struct operand
+    {
+        bigbigint val;
+        operand(const stored_type &expr) : val(expr) {}
+    };
+
+    static unsigned long limbs(const stored_type &expr) { return expr.limbs(); }
+    static bool aliases(const stored_type &expr, const bigbigint *dest) { return expr.aliases(dest); }
+    static void assign(const stored_type &expr, bigbigint &dest) { expr.assign(dest); }
+
+    static void accumulate(const stored_type &expr, bigbigint &dest, bool negate)
+    {
+        expr.accumulate(dest, negate);
+    }
+};
+
+//  Which types take part in expressions
+template <class __type> struct bbi_expr_operand { static const bool value = false; };
+template <> struct bbi_expr_operand<bigbigint> { static const bool value = true; };
+template <> struct bbi_expr_operand<bigbigint_view> { static const bool value = true; };
+template <class __lhs, class __rhs, char __op>
+struct bbi_expr_operand< bbi_expr<__lhs, __rhs, __op> > { static const bool value = true; };
+
+
+//-----------------------------------------------------------------------------
+//                          Expression Node
+//-----------------------------------------------------------------------------
+
+template <class __lhs, class __rhs, char __op>
+class bbi_expr
+{
+    typedef bbi_expr_traits<__lhs> lhs_traits;
+    typedef bbi_expr_traits<__rhs> rhs_traits;
+
+// ----
+public:
+// ----
+
+    bbi_expr(const __lhs &lhs, const __rhs &rhs) : _lhs(lhs), _rhs(rhs) {}
+
+    //
+    //  Upper bound on the number of limbs in the result
+    unsigned long limbs() const
+    {
+        unsigned long lhs_limbs, rhs_limbs;
+
+        lhs_limbs = lhs_traits::limbs(_lhs);
+        rhs_limbs = rhs_traits::limbs(_rhs);
+        if (__op == BBI_EXPR_MUL) {
+            return lhs_limbs + rhs_limbs;
+        }
+        return MAX(lhs_limbs, rhs_limbs) + 1;
+    }
+
+    bool aliases(const bigbigint *dest) const
+    {
+        return (lhs_traits::aliases(_lhs, dest) || rhs_traits::aliases(_rhs, dest));
+    }
+
+    //
+    //  dest = expression   (dest must not be one of the operands)
+    void assign(bigbigint &dest) const
+    {
+        if (__op == BBI_EXPR_MUL) {
+            typename lhs_traits::operand val1(_lhs);
+            typename rhs_traits::operand val2(_rhs);
+            dest._assign_product(val1.val, val2.val);
+            return;
+        }
+        _assign_sum(_lhs, _rhs, dest, (__op == BBI_EXPR_SUB));
+    }
+
+    //
+    //  dest += expression  (or -= if negate is set)
+    void accumulate(bigbigint &dest, bool negate) const
+    {
+        if (__op == BBI_EXPR_MUL) {
+            typename lhs_traits::operand val1(_lhs);
+            typename rhs_traits::operand val2(_rhs);
+            dest._add_product(val1.val, val2.val, negate);
+            return;
+        }
+        lhs_traits::accumulate(_lhs, dest, negate);
+        rhs_traits::accumulate(_rhs, dest, (__op == BBI_EXPR_SUB) != negate);
+    }
+
+
+// -----
+private:
+// -----
+
+    //
+    //  dest = lhs + rhs  (or lhs - rhs):  the first term goes in, the
+    //  second is accumulated on top of it...
+    template <class __a, class __b>
+    static void _assign_sum(const __a &lhs, const __b &rhs, bigbigint &dest, bool negate)
+    {
+        bbi_expr_traits<__a>::assign(lhs, dest);
+        bbi_expr_traits<__b>::accumulate(rhs, dest, negate);
+    }
+
+    //  ...unless both are plain numbers, which is a single pass.
+    static void _assign_sum(const bigbigint &lhs, const bigbigint &rhs, bigbigint &dest, bool negate)
+    {
+        dest._assign_sum(lhs, rhs, negate);
+    }
+
+    typename lhs_traits::stored_type _lhs;
+    typename rhs_traits::stored_type _rhs;
+};
+
+
+//-----------------------------------------------------------------------------
+//                  bigbigint members that take an expression
+//-----------------------------------------------------------------------------
+
+template <class __lhs, class __rhs, char __op>
+bigbigint::bigbigint(const bbi_expr<__lhs, __rhs, __op> &expr)
+{
+    this->_constructor(expr.limbs());
+    expr.assign(*this);
+}
+
+template <class __lhs, class __rhs, char __op>
+bigbigint &bigbigint::operator =(const bbi_expr<__lhs, __rhs, __op> &expr)
+{
+    if (expr.aliases(this)) {
+        // We're one of the operands.  Work it out on the side.
+        bigbigint tVal(expr);
+        this->_swap(tVal);
+        return *this;
+    }
+    this->_presize(expr.limbs());
+    expr.assign(*this);
+    return *this;
+}
+
+template <class __lhs, class __rhs, char __op>
+bigbigint &bigbigint::operator +=(const bbi_expr<__lhs, __rhs, __op> &expr)
+{
+    if (expr.aliases(this)) {
+        bigbigint tVal(expr);
+        this->_add_signed(tVal, false);
+        return *this;
+    }
+    this->_reserve(MAX(this->_size(), expr.limbs()) + 1);
+    expr.accumulate(*this, false);
+    return *this;
+}
+
+template <class __lhs, class __rhs, char __op>
+bigbigint &bigbigint::operator -=(const bbi_expr<__lhs, __rhs, __op> &expr)
+{
+    if (expr.aliases(this)) {
+        bigbigint tVal(expr);
+        this->_add_signed(tVal, true);
+        return *this;
+    }
+    this->_reserve(MAX(this->_size(), expr.limbs()) + 1);
+    expr.accumulate(*this, true);
+    return *this;
+}
+
+
+//-----------------------------------------------------------------------------
+//                  Operators that build expressions
+//-----------------------------------------------------------------------------
+
+//  The operands are taken as forwarding references so that a plain
+//  (non-const) bigbigint is an exact match; otherwise the member
+//  operators that take a native type (through operator double) would
+//  be just as good a match.
+template <class __type>
+struct bbi_expr_decay { typedef typename std::remove_cv<typename std::remove_reference<__type>::type>::type type; };
+
+#define BBI_EXPR_OPERATOR(__sym, __op)                                      \
+    template <class __lhs, class __rhs>                                     \
+    inline typename std::enable_if<                                         \
+        bbi_expr_operand<typename bbi_expr_decay<__lhs>::type>::value &&    \
+        bbi_expr_operand<typename bbi_expr_decay<__rhs>::type>::value,      \
+        bbi_expr<typename bbi_expr_decay<__lhs>::type,                      \
+                 typename bbi_expr_decay<__rhs>::type, __op> >::type        \
+    operator __sym(__lhs &&lhs, __rhs &&rhs)                                \
+    {                                                                       \
+        return bbi_expr<typename bbi_expr_decay<__lhs>::type,               \
+                        typename bbi_expr_decay<__rhs>::type, __op>(lhs, rhs); \
+    }
+
+BBI_EXPR_OPERATOR(+, BBI_EXPR_ADD)
+BBI_EXPR_OPERATOR(-, BBI_EXPR_SUB)
+BBI_EXPR_OPERATOR(*, BBI_EXPR_MUL)
+
+//  Unary minus on an expression:  -e == 0 - e
+template <class __lhs, class __rhs, char __op>
+inline bbi_expr<bbi_expr_zero, bbi_expr<__lhs, __rhs, __op>, BBI_EXPR_SUB>
+operator -(const bbi_expr<__lhs, __rhs, __op> &expr)
+{
+    return bbi_expr<bbi_expr_zero, bbi_expr<__lhs, __rhs, __op>, BBI_EXPR_SUB>(
+                bbi_expr_zero(), expr);
+}
+
+
+//-----------------------------------------------------------------------------
+//          Everything else:  evaluate the expression, then carry on
+//-----------------------------------------------------------------------------
+
+//  <expression> op <native type>  (+, -, *)
+#define BBI_EXPR_NATIVE_OPERATOR(__sym)                                     \
+    template <class __lhs, class __rhs, char __op, class __type>            \
+    inline typename std::enable_if<std::is_arithmetic<__type>::value,       \
+                                   bigbigint>::type                         \
+    operator __sym(const bbi_expr<__lhs, __rhs, __op> &expr, __type val)    \
+    {                                                                       \
+        bigbigint tVal(expr);                                               \
+        return (tVal __sym val);                                            \
+    }                                                                       \
+    template <class __lhs, class __rhs, char __op, class __type>            \
+    inline typename std::enable_if<std::is_arithmetic<__type>::value,       \
+                                   bigbigint>::type                         \
+    operator __sym(__type val, const bbi_expr<__lhs, __rhs, __op> &expr)    \
+    {                                                                       \
+        bigbigint tVal(expr);                                               \
+        return (val __sym tVal);                                            \
+    }
+
+BBI_EXPR_NATIVE_OPERATOR(+)
+BBI_EXPR_NATIVE_OPERATOR(-)
+BBI_EXPR_NATIVE_OPERATOR(*)
+
+//  <expression> op <anything>
+#define BBI_EXPR_EVAL_OPERATOR(__sym, __ret)                                \
+    template <class __lhs, class __rhs, char __op, class __type>            \
+    inline __ret operator __sym(const bbi_expr<__lhs, __rhs, __op> &expr,   \
+                                const __type &val)                          \
+    {                                                                       \
+        bigbigint tVal(expr);                                               \
+        return (tVal __sym val);                                            \
+    }
+
+BBI_EXPR_EVAL_OPERATOR(/, bigbigint)
+BBI_EXPR_EVAL_OPERATOR(%, bigbigint)
+BBI_EXPR_EVAL_OPERATOR(<<, bigbigint)
+BBI_EXPR_EVAL_OPERATOR(>>, bigbigint)
+BBI_EXPR_EVAL_OPERATOR(&, bigbigint)
+BBI_EXPR_EVAL_OPERATOR(|, bigbigint)
+BBI_EXPR_EVAL_OPERATOR(^, bigbigint)
+BBI_EXPR_EVAL_OPERATOR(>, bool)
+BBI_EXPR_EVAL_OPERATOR(>=, bool)
+BBI_EXPR_EVAL_OPERATOR(<, bool)
+BBI_EXPR_EVAL_OPERATOR(<=, bool)
+BBI_EXPR_EVAL_OPERATOR(==, bool)
+BBI_EXPR_EVAL_OPERATOR(!=, bool)
+
+//  <native type> op <expression>  (comparisons)
+#define BBI_EXPR_NATIVE_COMPARE(__sym)                                      \
+    template <class __lhs, class __rhs, char __op, class __type>            \
+    inline typename std::enable_if<std::is_arithmetic<__type>::value,       \
+                                   bool>::type                              \
+    operator __sym(__type val, const bbi_expr<__lhs, __rhs, __op> &expr)    \
+    {                                                                       \
+        bigbigint tVal(expr);                                               \
+        return (val __sym tVal);                                            \
+    }
+
+BBI_EXPR_NATIVE_COMPARE(>)
+BBI_EXPR_NATIVE_COMPARE(>=)
+BBI_EXPR_NATIVE_COMPARE(<)
+BBI_EXPR_NATIVE_COMPARE(<=)
+BBI_EXPR_NATIVE_COMPARE(==)
+BBI_EXPR_NATIVE_COMPARE(!=)
+
+#endif
@@ -0,0 +1,2650 @@
+// ------------------------------------------------------------
+//  BigBigIntMpn.cpp
+//
+//  Created by Richard Andrasek
+//
+//  Purpose:
+//      The limb layer under the bigbigint class:  unsigned 
+//  arithmetic on raw arrays of limbs.  See BigBigIntMpn.h for the
+//  rules every function here follows.
+//
+// ------------------------------------------------------------
+#include "BigBigIntMpn.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <system_error>
+#if defined(__AVX2__) || defined(__AVX512F__)
+    #include <immintrin.h>
+#endif
+
+#ifndef MIN
+#define MIN(val1, val2) ((val1) < (val2) ? (val1) : (val2))
+#endif
+
+#ifndef MAX
+#define MAX(val1, val2) ((val1) > (val2) ? (val1) : (val2))
+#endif
+
+#if defined(BBI_TUNE_PROGRAM)
+//  The thresholds as variables (see BigBigIntMpn.h).  BigBigIntTune 
+//  sets them all before it times anything.
+bbi_tune_params bbi_tune;
+#endif
+
+
+//
+//  BBI_UMUL:  (hi, lo) = a * b
+#if defined(__SIZEOF_INT128__)
+    #define BBI_UMUL(__hi, __lo, __a, __b)                          \
+        {                                                           \
+            unsigned __int128 __prod;                               \
+            __prod = (unsigned __int128)(__a) * (__b);              \
+            (__lo) = (BBI_BASE_TYPE)__prod;                         \
+            (__hi) = (BBI_BASE_TYPE)(__prod >> BBI_BASE_BITS);      \
+        }
+#elif defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+    #define BBI_UMUL(__hi, __lo, __a, __b)                          \
+        {                                                           \
+            (__lo) = _umul128((__a), (__b), &(__hi));               \
+        }
+#else
+    #define BBI_UMUL(__hi, __lo, __a, __b)                          \
+        {                                                           \
+            BBI_BASE_TYPE __al, __ah, __bl, __bh, __p0, __p1, __p2, __mid; \
+            __al = (__a) & 0xFFFFFFFFULL; __ah = (__a) >> 32;       \
+            __bl = (__b) & 0xFFFFFFFFULL; __bh = (__b) >> 32;       \
+            __p0 = __al * __bl;                                     \
+            __p1 = __al * __bh;                                     \
+            __p2 = __ah * __bl;                                     \
+            __mid = (__p0 >> 32) + (__p1 & 0xFFFFFFFFULL) + (__p2 & 0xFFFFFFFFULL); \
+            (__hi) = __ah * __bh + (__p1 >> 32) + (__p2 >> 32) + (__mid >> 32); \
+            (__lo) = (__mid << 32) | (__p0 & 0xFFFFFFFFULL);        \
+        }
+#endif
+
+//
+//  BBI_UDIV:  q = (hi, lo) / d, r = (hi, lo) % d   (hi must be < d)
+#if defined(__SIZEOF_INT128__)
+    #define BBI_UDIV(__q, __r, __hi, __lo, __d)                     \
+        {                                                           \
+            unsigned __int128 __num;                                \
+            BBI_BASE_TYPE __div;                                    \
+            __num = ((unsigned __int128)(__hi) << BBI_BASE_BITS) | (__lo); \
+            __div = (__d);                                          \
+            (__q) = (BBI_BASE_TYPE)(__num / __div);                 \
+            (__r) = (BBI_BASE_TYPE)(__num % __div);                 \
+        }
+#elif defined(_MSC_VER) && defined(_M_X64) && (_MSC_VER >= 1920)
+    #define BBI_UDIV(__q, __r, __hi, __lo, __d)                     \
+        {                                                           \
+            BBI_BASE_TYPE __rem;                                    \
+            (__q) = _udiv128((__hi), (__lo), (__d), &__rem);        \
+            (__r) = __rem;                                          \
+        }
+#else
+    //  No 128-bit divide:  plain shift-and-subtract, a bit at a time
+    static BBI_BASE_TYPE bbi_udiv_portable(BBI_BASE_TYPE hi, BBI_BASE_TYPE lo, 
+                                           BBI_BASE_TYPE d, BBI_BASE_TYPE *r)
+    {
+        BBI_BASE_TYPE q, top;
+        int i;
+
+        q = 0;
+        for (i = 0; i < BBI_BASE_BITS; i++) {
+            top = hi >> (BBI_BASE_BITS - 1);
+            hi = (hi << 1) | (lo >> (BBI_BASE_BITS - 1));
+            lo <<= 1;
+            q <<= 1;
+            if (top || hi >= d) {
+                hi -= d;
+                q |= 1;
+            }
+        }
+        *r = hi;
+        return q;
+    }
+    #define BBI_UDIV(__q, __r, __hi, __lo, __d)                     \
+        {                                                           \
+            BBI_BASE_TYPE __rem;                                    \
+            (__q) = bbi_udiv_portable((__hi), (__lo), (__d), &__rem); \
+            (__r) = __rem;                                          \
+        }
+#endif
+
+//
+//  Number of limbs actually in use (ignoring leading zeroes)
+unsigned long bbi_normalize(const BBI_BASE_TYPE *a, unsigned long n)
+{
+    while (n > 0 && a[n - 1] == 0) {
+        n--;
+    }
+    return n;
+}
+
+//
+//  Compare two magnitudes.  Returns -1, 0 or 1.
+int bbi_cmp(const BBI_BASE_TYPE *a, unsigned long an, 
+            const BBI_BASE_TYPE *b, unsigned long bn)
+{
+    an = bbi_normalize(a, an);
+    bn = bbi_normalize(b, bn);
+    if (an != bn) {
+        return (an > bn ? 1 : -1);
+    }
+    while (an > 0) {
+        an--;
+        if (a[an] != b[an]) {
+            return (a[an] > b[an] ? 1 : -1);
+        }
+    }
+    return 0;
+}
+
+//
+//  Compare a magnitude with a single limb.  Returns -1, 0 or 1.
+int bbi_cmp_1(const BBI_BASE_TYPE *a, unsigned long n, BBI_BASE_TYPE b)
+{
+    BBI_BASE_TYPE val;
+
+    n = bbi_normalize(a, n);
+    if (n > 1) {
+        return 1;
+    }
+    val = (n == 1 ? a[0] : 0);
+    return ((val > b) - (val < b));
+}
+
+//
+//  The four carry-chain kernels (add_n, sub_n, addmul_1, submul_1) 
+//  come in a portable version and an ADX/BMI2 version, and 
+//  bbi_kernels() picks one set at run time.  Everything else calls 
+//  them by their plain names (bbi_add_n, ...) defined after that.
+//
+
+//
+//  r = a + b  (n limbs each).  Returns the carry.
+static BBI_BASE_TYPE bbi_add_n_portable(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                                        const BBI_BASE_TYPE *b, unsigned long n)
+{
+    BBI_BASE_TYPE carry, sum;
+    unsigned long i;
+
+    carry = 0;
+    for (i = 0; i < n; i++) {
+        sum = a[i] + carry;
+        carry = (sum < carry);
+        r[i] = sum + b[i];
+        carry += (r[i] < sum);
+    }
+    return carry;
+}
+
+//
+//  r = a - b  (n limbs each).  Returns the borrow.
+static BBI_BASE_TYPE bbi_sub_n_portable(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                                        const BBI_BASE_TYPE *b, unsigned long n)
+{
+    BBI_BASE_TYPE borrow, diff, val, sub;
+    unsigned long i;
+
+    borrow = 0;
+    for (i = 0; i < n; i++) {
+        val = a[i];
+        sub = b[i];
+        diff = val - sub;
+        r[i] = diff - borrow;
+        borrow = (val < sub) | (diff < borrow);
+    }
+    return borrow;
+}
+
+//
+//  r += a * b  (a is n limbs, b is a single limb).  Returns the carry limb.
+static BBI_BASE_TYPE bbi_addmul_1_portable(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                                           unsigned long n, BBI_BASE_TYPE b)
+{
+    BBI_BASE_TYPE carry, hi, lo;
+    unsigned long i;
+
+    carry = 0;
+    for (i = 0; i < n; i++) {
+        BBI_UMUL(hi, lo, a[i], b);
+        lo += carry;
+        hi += (lo < carry);
+        r[i] += lo;
+        carry = hi + (r[i] < lo);
+    }
+    return carry;
+}
+
+//
+//  r -= a * b  (a is n limbs, b is a single limb).  Returns the borrow limb.
+static BBI_BASE_TYPE bbi_submul_1_portable(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                                           unsigned long n, BBI_BASE_TYPE b)
+{
+    BBI_BASE_TYPE borrow, hi, lo, val;
+    unsigned long i;
+
+    borrow = 0;
+    for (i = 0; i < n; i++) {
+        BBI_UMUL(hi, lo, a[i], b);
+        lo += borrow;
+        hi += (lo < borrow);
+        val = r[i];
+        r[i] = val - lo;
+        borrow = hi + (val < lo);
+    }
+    return borrow;
+}
+
+//
+//  ADX/BMI2 versions of the four kernels above.
+//
+//  add_n and sub_n are the intrinsics:  the compiler keeps the carry
+//  in the flags from one limb to the next instead of rebuilding it 
+//  with a compare.
+//
+//  addmul_1 and submul_1 need two carry chains at once (the high half
+//  of each product into the next low half, and that sum into r).  The
+//  intrinsics can't say that, and what the compiler makes of them is
+//  slower than the portable loops, so these two are written in 
+//  assembly:  mulx gives the 128-bit product without touching the 
+//  flags, adcx carries the product chain in CF and adox the chain 
+//  into r in OF.  Only GCC and Clang have the inline assembly; with 
+//  MSVC the portable ones stay.
+//
+//  These are compiled for ADX/BMI2 on their own, and only called 
+//  when cpuid says the processor has them (see bbi_kernels below).
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+    #include <cpuid.h>
+    #include <immintrin.h>
+    #define BBI_HAVE_ADX_KERNELS
+    #define BBI_HAVE_ADX_ASM
+    #define BBI_ADX_TARGET      __attribute__((target("adx,bmi2")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+    #include <immintrin.h>
+    #define BBI_HAVE_ADX_KERNELS
+    #define BBI_ADX_TARGET
+#endif
+
+#if defined(BBI_HAVE_ADX_KERNELS)
+BBI_ADX_TARGET
+static BBI_BASE_TYPE bbi_add_n_adx(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                                   const BBI_BASE_TYPE *b, unsigned long n)
+{
+    unsigned long long sum;
+    unsigned char carry;
+    unsigned long i;
+
+    carry = 0;
+    for (i = 0; i < n; i++) {
+        carry = _addcarryx_u64(carry, a[i], b[i], &sum);
+        r[i] = sum;
+    }
+    return carry;
+}
+
+BBI_ADX_TARGET
+static BBI_BASE_TYPE bbi_sub_n_adx(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                                   const BBI_BASE_TYPE *b, unsigned long n)
+{
+    unsigned long long diff;
+    unsigned char borrow;
+    unsigned long i;
+
+    borrow = 0;
+    for (i = 0; i < n; i++) {
+        borrow = _subborrow_u64(borrow, a[i], b[i], &diff);
+        r[i] = diff;
+    }
+    return borrow;
+}
+
+#if defined(BBI_HAVE_ADX_ASM)
+//
+//  Four limbs a pass.  xor clears both flags to start; lea and jrcxz 
+//  step the pointers and count without touching either (dec would
+//  clobber OF).  At the end both pending carries go into the high 
+//  half, which can't overflow since the whole carry fits in a limb.
+//  The n % 4 limbs left over are done the portable way.
+BBI_ADX_TARGET
+static BBI_BASE_TYPE bbi_addmul_1_adx(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                                      unsigned long n, BBI_BASE_TYPE b)
+{
+    BBI_BASE_TYPE carry, hi, lo, tmp;
+    unsigned long blocks, i;
+
+    carry = 0;
+    blocks = n / 4;
+    if (blocks != 0) {
+        __asm__ (
+            "xor    %k[lo], %k[lo]\n\t"
+            "1:\n\t"
+            "mulx   (%[a]), %[lo], %[tmp]\n\t"
+            "adcx   %[carry], %[lo]\n\t"
+            "adox   (%[r]), %[lo]\n\t"
+            "mov    %[lo], (%[r])\n\t"
+            "mulx   8(%[a]), %[lo], %[carry]\n\t"
+            "adcx   %[tmp], %[lo]\n\t"
+            "adox   8(%[r]), %[lo]\n\t"
+            "mov    %[lo], 8(%[r])\n\t"
+            "mulx   16(%[a]), %[lo], %[tmp]\n\t"
+            "adcx   %[carry], %[lo]\n\t"
+            "adox   16(%[r]), %[lo]\n\t"
+            "mov    %[lo], 16(%[r])\n\t"
+            "mulx   24(%[a]), %[lo], %[carry]\n\t"
+            "adcx   %[tmp], %[lo]\n\t"
+            "adox   24(%[r]), %[lo]\n\t"
+            "mov    %[lo], 24(%[r])\n\t"
+            "lea    32(%[a]), %[a]\n\t"
+            "lea    32(%[r]), %[r]\n\t"
+            "lea    -1(%[blocks]), %[blocks]\n\t"
+            "jrcxz  2f\n\t"
+            "jmp    1b\n\t"
+            "2:\n\t"
+            "mov    $0, %k[lo]\n\t"
+            "adcx   %[lo], %[carry]\n\t"
+            "adox   %[lo], %[carry]\n\t"
+            : [r] "+r" (r), [a] "+r" (a), [blocks] "+c" (blocks), 
+              [carry] "+r" (carry), [lo] "=&r" (lo), [tmp] "=&r" (tmp)
+            : "d" (b)
+            : "cc", "memory");
+    }
+
+    for (i = 0; i < n % 4; i++) {
+        BBI_UMUL(hi, lo, a[i], b);
+        lo += carry;
+        hi += (lo < carry);
+        r[i] += lo;
+        carry = hi + (r[i] < lo);
+    }
+    return carry;
+}
+
+//
+//  There's no subtract that uses OF, but r - x == ~(~r + x) and not 
+//  leaves the flags alone, so this is the addmul_1 loop with each 
+//  limb of r complemented on the way in and out.  The carry out of
+//  ~r + x is the borrow out of r - x.
+BBI_ADX_TARGET
+static BBI_BASE_TYPE bbi_submul_1_adx(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                                      unsigned long n, BBI_BASE_TYPE b)
+{
+    BBI_BASE_TYPE borrow, hi, lo, tmp, val;
+    unsigned long blocks, i;
+
+    borrow = 0;
+    blocks = n / 4;
+    if (blocks != 0) {
+        __asm__ (
+            "xor    %k[lo], %k[lo]\n\t"
+            "1:\n\t"
+            "mulx   (%[a]), %[lo], %[tmp]\n\t"
+            "adcx   %[borrow], %[lo]\n\t"
+            "mov    (%[r]), %[val]\n\t"
+            "not    %[val]\n\t"
+            "adox   %[val], %[lo]\n\t"
+            "not    %[lo]\n\t"
+            "mov    %[lo], (%[r])\n\t"
+            "mulx   8(%[a]), %[lo], %[borrow]\n\t"
+            "adcx   %[tmp], %[lo]\n\t"
+            "mov    8(%[r]), %[val]\n\t"
+            "not    %[val]\n\t"
+            "adox   %[val], %[lo]\n\t"
+            "not    %[lo]\n\t"
+            "mov    %[lo], 8(%[r])\n\t"
+            "mulx   16(%[a]), %[lo], %[tmp]\n\t"
+            "adcx   %[borrow], %[lo]\n\t"
+            "mov    16(%[r]), %[val]\n\t"
+            "not    %[val]\n\t"
+            "adox   %[val], %[lo]\n\t"
+            "not    %[lo]\n\t"
+            "mov    %[lo], 16(%[r])\n\t"
+            "mulx   24(%[a]), %[lo], %[borrow]\n\t"
+            "adcx   %[tmp], %[lo]\n\t"
+            "mov    24(%[r]), %[val]\n\t"
+            "not    %[val]\n\t"
+            "adox   %[val], %[lo]\n\t"
+            "not    %[lo]\n\t"
+            "mov    %[lo], 24(%[r])\n\t"
+            "lea    32(%[a]), %[a]\n\t"
+            "lea    32(%[r]), %[r]\n\t"
+            "lea    -1(%[blocks]), %[blocks]\n\t"
+            "jrcxz  2f\n\t"
+            "jmp    1b\n\t"
+            "2:\n\t"
+            "mov    $0, %k[lo]\n\t"
+            "adcx   %[lo], %[borrow]\n\t"
+            "adox   %[lo], %[borrow]\n\t"
+            : [r] "+r" (r), [a] "+r" (a), [blocks] "+c" (blocks), 
+              [borrow] "+r" (borrow), [lo] "=&r" (lo), [tmp] "=&r" (tmp), 
+              [val] "=&r" (val)
+            : "d" (b)
+            : "cc", "memory");
+    }
+
+    for (i = 0; i < n % 4; i++) {
+        BBI_UMUL(hi, lo, a[i], b);
+        lo += borrow;
+        hi += (lo < borrow);
+        val = r[i];
+        r[i] = val - lo;
+        borrow = hi + (val < lo);
+    }
+    return borrow;
+}
+#endif
+
+//
+//  cpuid leaf 7:  EBX bit 8 is BMI2 (mulx), bit 19 is ADX (adcx/adox)
+static bool bbi_cpu_has_adx()
+{
+    unsigned int regs[4];
+
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, 0, 0);
+    if (info[0] < 7) return false;
+    __cpuidex(info, 7, 0);
+    regs[1] = (unsigned int)info[1];
+#else
+    if (!__get_cpuid_count(7, 0, &regs[0], &regs[1], &regs[2], &regs[3])) {
+        return false;
+    }
+#endif
+    return ((regs[1] >> 8) & 1) && ((regs[1] >> 19) & 1);
+}
+#endif
+
+//
+//  The carry-chain kernels in use.  Picked the first time any of
+//  them is needed (a function local static, so this is thread safe
+//  and can't run into static initialization order problems when a
+//  bigbigint is built by another module's constructor), then never
+//  looked at again.
+typedef BBI_BASE_TYPE (*bbi_n_kernel)(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                                      const BBI_BASE_TYPE *b, unsigned long n);
+typedef BBI_BASE_TYPE (*bbi_1_kernel)(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                                      unsigned long n, BBI_BASE_TYPE b);
+
+struct bbi_kernel_table
+{
+    bbi_n_kernel add_n;
+    bbi_n_kernel sub_n;
+    bbi_1_kernel addmul_1;
+    bbi_1_kernel submul_1;
+};
+
+static bbi_kernel_table bbi_select_kernels()
+{
+    bbi_kernel_table table;
+
+    table.add_n = bbi_add_n_portable;
+    table.sub_n = bbi_sub_n_portable;
+    table.addmul_1 = bbi_addmul_1_portable;
+    table.submul_1 = bbi_submul_1_portable;
+
+#if defined(BBI_HAVE_ADX_KERNELS)
+    if (bbi_cpu_has_adx()) {
+        table.add_n = bbi_add_n_adx;
+        table.sub_n = bbi_sub_n_adx;
+#if defined(BBI_HAVE_ADX_ASM)
+        table.addmul_1 = bbi_addmul_1_adx;
+        table.submul_1 = bbi_submul_1_adx;
+#endif
+    }
+#endif
+    return table;
+}
+
+static const bbi_kernel_table &bbi_kernels()
+{
+    static const bbi_kernel_table table = bbi_select_kernels();
+    return table;
+}
+
+//
+//  r = a + b  (n limbs each).  Returns the carry.
+BBI_BASE_TYPE bbi_add_n(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                        const BBI_BASE_TYPE *b, unsigned long n)
+{
+    return bbi_kernels().add_n(r, a, b, n);
+}
+
+//
+//  r = a - b  (n limbs each).  Returns the borrow.  r may be b.
+BBI_BASE_TYPE bbi_sub_n(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                        const BBI_BASE_TYPE *b, unsigned long n)
+{
+    return bbi_kernels().sub_n(r, a, b, n);
+}
+
+//
+//  r += a * b  (a is n limbs, b is a single limb).  Returns the carry limb.
+//  This is the workhorse of multiplication.
+BBI_BASE_TYPE bbi_addmul_1(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                           unsigned long n, BBI_BASE_TYPE b)
+{
+    return bbi_kernels().addmul_1(r, a, n, b);
+}
+
+//
+//  r -= a * b  (a is n limbs, b is a single limb).  Returns the borrow limb.
+BBI_BASE_TYPE bbi_submul_1(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                           unsigned long n, BBI_BASE_TYPE b)
+{
+    return bbi_kernels().submul_1(r, a, n, b);
+}
+
+//
+//  r = a + b  (a is n limbs, b is a single limb).  Returns the carry.
+//  The carry loop stops as soon as there's nothing left to carry.
+BBI_BASE_TYPE bbi_add_1(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                        unsigned long n, BBI_BASE_TYPE b)
+{
+    unsigned long i;
+
+    for (i = 0; i < n; i++) {
+        r[i] = a[i] + b;
+        if (r[i] >= b) {
+            // No carry out of this limb.  Copy the rest (if needed).
+            if (r != a) {
+                memcpy(r + i + 1, a + i + 1, (n - i - 1) * sizeof(BBI_BASE_TYPE));
+            }
+            return 0;
+        }
+        b = 1;
+    }
+    return b;
+}
+
+//
+//  r = a + b  (a is an limbs, b is bn limbs, an >= bn).  Returns the carry.
+BBI_BASE_TYPE bbi_add(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long an, 
+                      const BBI_BASE_TYPE *b, unsigned long bn)
+{
+    BBI_BASE_TYPE carry;
+
+    carry = bbi_add_n(r, a, b, bn);
+    return bbi_add_1(r + bn, a + bn, an - bn, carry);
+}
+
+//
+//  r = a - b  (a is n limbs, b is a single limb).  Returns the borrow.
+//  Like bbi_add_1, this stops as soon as the borrow is absorbed.
+BBI_BASE_TYPE bbi_sub_1(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                        unsigned long n, BBI_BASE_TYPE b)
+{
+    unsigned long i;
+    BBI_BASE_TYPE val;
+
+    for (i = 0; i < n; i++) {
+        val = a[i];
+        r[i] = val - b;
+        if (val >= b) {
+            if (r != a) {
+                memcpy(r + i + 1, a + i + 1, (n - i - 1) * sizeof(BBI_BASE_TYPE));
+            }
+            return 0;
+        }
+        b = 1;
+    }
+    return b;
+}
+
+//
+//  r = a - b  (a is an limbs, b is bn limbs, an >= bn).  Returns the borrow.
+BBI_BASE_TYPE bbi_sub(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long an, 
+                      const BBI_BASE_TYPE *b, unsigned long bn)
+{
+    BBI_BASE_TYPE borrow;
+
+    borrow = bbi_sub_n(r, a, b, bn);
+    return bbi_sub_1(r + bn, a + bn, an - bn, borrow);
+}
+
+//
+//  r = a << cnt  (n limbs, 0 < cnt < BBI_BASE_BITS).  Returns the bits
+//  shifted out of the top limb (in the bottom of the returned limb).
+//
+//  This runs from the top limb down, so r may be a, or start above
+//  a (the same rule as memmove), which is how the limb offset and
+//  the bit shift get done in a single pass.  With AVX2 the middle
+//  of the loop does four limbs at a time:  each lane takes its own
+//  limb shifted up, ORed with the limb below it shifted down (a
+//  64-bit funnel shift).
+BBI_BASE_TYPE bbi_lshift(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                         unsigned long n, unsigned int cnt)
+{
+    BBI_BASE_TYPE out;
+    unsigned long i;
+    unsigned int back;
+
+    back = BBI_BASE_BITS - cnt;
+    out = a[n - 1] >> back;
+
+    i = n - 1;
+#if defined(__AVX2__)
+    {
+        __m128i vec_cnt, vec_back;
+        __m256i high, low;
+
+        vec_cnt = _mm_cvtsi32_si128(cnt);
+        vec_back = _mm_cvtsi32_si128(back);
+        while (i >= 4) {
+            // r[i-3 .. i] from a[i-3 .. i] and a[i-4 .. i-1]
+            high = _mm256_loadu_si256((const __m256i *)(a + i - 3));
+            low = _mm256_loadu_si256((const __m256i *)(a + i - 4));
+            _mm256_storeu_si256((__m256i *)(r + i - 3), 
+                _mm256_or_si256(_mm256_sll_epi64(high, vec_cnt), 
+                                _mm256_srl_epi64(low, vec_back)));
+            i -= 4;
+        }
+    }
+#endif
+    for (; i > 0; i--) {
+        r[i] = (a[i] << cnt) | (a[i - 1] >> back);
+    }
+    r[0] = a[0] << cnt;
+    return out;
+}
+
+//
+//  r = a >> cnt  (n limbs, 0 < cnt < BBI_BASE_BITS).  Returns the bits
+//  shifted out of the bottom limb (in the top of the returned limb).
+//
+//  The mirror image of bbi_lshift:  bottom up, so r may be a or start
+//  below it.
+BBI_BASE_TYPE bbi_rshift(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                         unsigned long n, unsigned int cnt)
+{
+    BBI_BASE_TYPE out;
+    unsigned long i;
+    unsigned int back;
+
+    back = BBI_BASE_BITS - cnt;
+    out = a[0] << back;
+
+    i = 0;
+#if defined(__AVX2__)
+    {
+        __m128i vec_cnt, vec_back;
+        __m256i high, low;
+
+        vec_cnt = _mm_cvtsi32_si128(cnt);
+        vec_back = _mm_cvtsi32_si128(back);
+        while (i + 4 < n) {
+            // r[i .. i+3] from a[i .. i+3] and a[i+1 .. i+4]
+            low = _mm256_loadu_si256((const __m256i *)(a + i));
+            high = _mm256_loadu_si256((const __m256i *)(a + i + 1));
+            _mm256_storeu_si256((__m256i *)(r + i), 
+                _mm256_or_si256(_mm256_srl_epi64(low, vec_cnt), 
+                                _mm256_sll_epi64(high, vec_back)));
+            i += 4;
+        }
+    }
+#endif
+    for (; i < n - 1; i++) {
+        r[i] = (a[i] >> cnt) | (a[i + 1] << back);
+    }
+    r[n - 1] = a[n - 1] >> cnt;
+    return out;
+}
+
+//
+//  r = -a  (two's complement over n limbs)
+void bbi_neg(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long n)
+{
+    unsigned long i;
+    BBI_BASE_TYPE carry;
+
+    carry = 1;
+    for (i = 0; i < n; i++) {
+        r[i] = ~a[i] + carry;
+        carry = (carry && r[i] == 0);
+    }
+}
+
+//
+//  r = a & b, a | b, a ^ b  (n limbs each, r may be a or b)
+//
+//  These are plain word-wise loops; with AVX-512 or AVX2 the bulk
+//  goes eight or four limbs at a time, so a long run is limited by
+//  memory bandwidth rather than by the loop.
+#if defined(__AVX512F__)
+    #define BBI_LOGIC_AVX512(__vec_op)                                      \
+        for (; i + 8 <= n; i += 8) {                                        \
+            _mm512_storeu_si512((void *)(r + i), __vec_op(                  \
+                _mm512_loadu_si512((const void *)(a + i)),                  \
+                _mm512_loadu_si512((const void *)(b + i))));                \
+        }
+#else
+    #define BBI_LOGIC_AVX512(__vec_op)
+#endif
+
+#if defined(__AVX2__)
+    #define BBI_LOGIC_AVX2(__vec_op)                                        \
+        for (; i + 4 <= n; i += 4) {                                        \
+            _mm256_storeu_si256((__m256i *)(r + i), __vec_op(               \
+                _mm256_loadu_si256((const __m256i *)(a + i)),               \
+                _mm256_loadu_si256((const __m256i *)(b + i))));             \
+        }
+#else
+    #define BBI_LOGIC_AVX2(__vec_op)
+#endif
+
+#define BBI_LOGIC_KERNEL(__name, __op, __avx2_op, __avx512_op)             \
+void __name(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a,                       \
+            const BBI_BASE_TYPE *b, unsigned long n)                        \
+{                                                                           \
+    unsigned long i;                                                        \
+                                                                            \
+    i = 0;                                                                  \
+    BBI_LOGIC_AVX512(__avx512_op)                                           \
+    BBI_LOGIC_AVX2(__avx2_op)                                               \
+    for (; i < n; i++) {                                                    \
+        r[i] = a[i] __op b[i];                                              \
+    }                                                                       \
+}
+
+BBI_LOGIC_KERNEL(bbi_and_n, &, _mm256_and_si256, _mm512_and_si512)
+BBI_LOGIC_KERNEL(bbi_ior_n, |, _mm256_or_si256, _mm512_or_si512)
+BBI_LOGIC_KERNEL(bbi_xor_n, ^, _mm256_xor_si256, _mm512_xor_si512)
+
+//
+//  r = a * b  (a is n limbs, b is a single limb).  Returns the high limb.
+BBI_BASE_TYPE bbi_mul_1(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                        unsigned long n, BBI_BASE_TYPE b)
+{
+    BBI_BASE_TYPE carry, hi, lo;
+    unsigned long i;
+
+    carry = 0;
+    for (i = 0; i < n; i++) {
+        BBI_UMUL(hi, lo, a[i], b);
+        lo += carry;
+        carry = hi + (lo < carry);
+        r[i] = lo;
+    }
+    return carry;
+}
+
+//
+//  q = a / b  (a is n limbs, b is a single non-zero limb).
+//  Returns the remainder.  q may be a.
+BBI_BASE_TYPE bbi_divrem_1(BBI_BASE_TYPE *q, const BBI_BASE_TYPE *a, 
+                           unsigned long n, BBI_BASE_TYPE b)
+{
+    BBI_BASE_TYPE rem;
+
+    rem = 0;
+    while (n > 0) {
+        n--;
+        BBI_UDIV(q[n], rem, rem, a[n], b);
+    }
+    return rem;
+}
+
+//
+//  a % b  (a is n limbs, b is a single non-zero limb)
+BBI_BASE_TYPE bbi_mod_1(const BBI_BASE_TYPE *a, unsigned long n, BBI_BASE_TYPE b)
+{
+    BBI_BASE_TYPE rem, quot;
+
+    rem = 0;
+    while (n > 0) {
+        n--;
+        BBI_UDIV(quot, rem, rem, a[n], b);
+    }
+    (void)quot;
+    return rem;
+}
+
+//
+//  r = a * b  (a and b are n limbs each), schoolbook:  one 
+//  bbi_addmul_1 pass per limb of b.
+static void bbi_mul_basecase(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long an, 
+                             const BBI_BASE_TYPE *b, unsigned long bn)
+{
+    unsigned long j;
+
+    r[an] = bbi_mul_1(r, a, an, b[0]);
+    for (j = 1; j < bn; j++) {
+        r[an + j] = bbi_addmul_1(r + j, a, an, b[j]);
+    }
+}
+
+//
+//  Scratch needed by bbi_mul_karatsuba for n limbs:  each level 
+//  keeps 6m + 1 limbs (m = the high half) and hands the rest down.
+static unsigned long bbi_mul_karatsuba_scratch(unsigned long n)
+{
+    unsigned long total, m;
+
+    total = 0;
+    while (n >= BBI_MUL_KARATSUBA_THRESHOLD) {
+        m = n - (n / 2);
+        total += (6 * m) + 1;
+        n = m;
+    }
+    return total;
+}
+
+//
+//  The steps of a Karatsuba multiplication (see bbi_mul_karatsuba) 
+//  around its three products, for it and bbi_mul_karatsuba_par.
+//
+//  bbi_karatsuba_diffs writes |a1 - a0| and |b1 - b0|, m limbs each,
+//  and returns true when (a1 - a0)(b1 - b0) is negative.  When the 
+//  low half is the larger one the high half fits in h limbs, so the
+//  top limb (if any) is 0.
+static bool bbi_karatsuba_diffs(BBI_BASE_TYPE *diff_a, BBI_BASE_TYPE *diff_b, 
+                                const BBI_BASE_TYPE *a, const BBI_BASE_TYPE *b, 
+                                unsigned long h, unsigned long m)
+{
+    bool prod_negative;
+
+    prod_negative = false;
+    if (bbi_cmp(a + h, m, a, h) >= 0) {
+        bbi_sub(diff_a, a + h, m, a, h);
+    }
+    else {
+        bbi_sub_n(diff_a, a, a + h, h);
+        diff_a[m - 1] = (m > h ? 0 : diff_a[m - 1]);
+        prod_negative = true;
+    }
+    if (bbi_cmp(b + h, m, b, h) >= 0) {
+        bbi_sub(diff_b, b + h, m, b, h);
+    }
+    else {
+        bbi_sub_n(diff_b, b, b + h, h);
+        diff_b[m - 1] = (m > h ? 0 : diff_b[m - 1]);
+        prod_negative = !prod_negative;
+    }
+    return prod_negative;
+}
+
+//
+//  r (2n limbs) holds a0 b0 and a1 b1 and prod is |a1 - a0| |b1 - b0|.
+//  Adds middle = a0 b0 + a1 b1 -/+ prod (2m + 1 limbs of room) in at B^h.
+static void bbi_karatsuba_combine(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *prod, 
+                                  BBI_BASE_TYPE *middle, unsigned long n, 
+                                  unsigned long h, unsigned long m, bool prod_negative)
+{
+    BBI_BASE_TYPE carry;
+
+    middle[2 * m] = bbi_add(middle, r + (2 * h), 2 * m, r, 2 * h);
+    if (prod_negative) {
+        middle[2 * m] += bbi_add_n(middle, middle, prod, 2 * m);
+    }
+    else {
+        middle[2 * m] -= bbi_sub_n(middle, middle, prod, 2 * m);
+    }
+
+    carry = bbi_add_n(r + h, r + h, middle, (2 * m) + 1);
+    bbi_add_1(r + h + (2 * m) + 1, r + h + (2 * m) + 1, 
+              (2 * n) - h - (2 * m) - 1, carry);
+}
+
+//
+//  r = a * b  (n limbs each, 2n limbs out), Karatsuba
+//
+//  Split each operand at h = n/2 limbs, a = a1 B^h + a0, and use
+//
+//      a0 b1 + a1 b0 = a0 b0 + a1 b1 - (a1 - a0)(b1 - b0)
+//
+//  so three half-size products do the work of four.  The 
+//  differences are taken as magnitudes with the sign tracked 
+//  separately, which keeps every piece at m = n - h limbs.
+//
+//  scratch holds bbi_mul_karatsuba_scratch(n) limbs.  The first
+//  6m + 1 are ours (the two differences, their product and the 
+//  middle sum) and the recursive calls share the rest.
+static void bbi_mul_karatsuba(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                              const BBI_BASE_TYPE *b, unsigned long n, 
+                              BBI_BASE_TYPE *scratch)
+{
+    BBI_BASE_TYPE *diff_a, *diff_b, *prod, *middle, *next_scratch;
+    unsigned long h, m;
+    bool prod_negative;
+
+    if (n < BBI_MUL_KARATSUBA_THRESHOLD) {
+        bbi_mul_basecase(r, a, n, b, n);
+        return;
+    }
+
+    h = n / 2;
+    m = n - h;
+    diff_a = scratch;
+    diff_b = diff_a + m;
+    prod = diff_b + m;
+    middle = prod + (2 * m);
+    next_scratch = middle + (2 * m) + 1;
+
+    prod_negative = bbi_karatsuba_diffs(diff_a, diff_b, a, b, h, m);
+    bbi_mul_karatsuba(prod, diff_a, diff_b, m, next_scratch);
+
+    // a0 b0 and a1 b1 go straight to their places in r
+    bbi_mul_karatsuba(r, a, b, h, next_scratch);
+    bbi_mul_karatsuba(r + (2 * h), a + h, b + h, m, next_scratch);
+
+    bbi_karatsuba_combine(r, prod, middle, n, h, m, prod_negative);
+}
+
+//
+//  FFT multiplication
+//
+//  From BBI_MUL_FFT_THRESHOLD limbs up the limbs are taken as the 
+//  coefficients of two polynomials, which are multiplied with number
+//  theoretic transforms (an FFT done with integers mod a prime) and
+//  the product's coefficients carried into limbs.  A coefficient is
+//  a sum of at most n limb products, below n 2^128, so it's worked
+//  out mod three primes just under 2^62 (about 2^186 between them)
+//  and put back together with the Chinese remainder theorem.  Each 
+//  prime is c 2^50 + 1, which gives transforms of up to 2^50 points.
+//
+//  Products mod p are Montgomery's (bbi_ntt_mul), and the values are
+//  only reduced to below 2p or 4p between the butterflies (Harvey's
+//  lazy butterflies), which is what needs p under 2^62.  The forward
+//  transform is decimation in frequency, leaving its output in bit
+//  reversed order, and the inverse is decimation in time, taking it 
+//  in that order, so neither needs a pass to reorder.  Both work a 
+//  whole level at a time until the pieces fit in the cache and then
+//  finish each piece on its own.
+//
+#define BBI_NTT_PRIMES      3
+#define BBI_NTT_BLOCK       4096    // points, a piece that's finished on its own
+
+struct bbi_ntt_prime
+{
+    BBI_BASE_TYPE p;
+    BBI_BASE_TYPE p_inv;        // -1/p mod 2^64
+    BBI_BASE_TYPE one;          // 2^64 mod p, 1 in Montgomery form
+    BBI_BASE_TYPE r2;           // 2^128 mod p
+    BBI_BASE_TYPE generator;    // of the multiplicative group, Montgomery form
+};
+
+struct bbi_ntt_constants
+{
+    bbi_ntt_prime primes[BBI_NTT_PRIMES];
+
+    // For the CRT (Montgomery form):  1/p0 mod p1, p0 mod p2 and 
+    // 1/(p0 p1) mod p2, and p0 p1 itself
+    BBI_BASE_TYPE inv_p0;
+    BBI_BASE_TYPE p0_mod_p2;
+    BBI_BASE_TYPE inv_p0p1;
+    BBI_BASE_TYPE p0p1[2];
+};
+
+//
+//  a b / 2^64 mod p (Montgomery's REDC), below 2p, for a b < p 2^64.
+//  Adding m p clears the low limb, which carries out of it unless lo
+//  was already 0.
+static inline BBI_BASE_TYPE bbi_ntt_mul(BBI_BASE_TYPE a, BBI_BASE_TYPE b, 
+                                        const bbi_ntt_prime &prime)
+{
+    BBI_BASE_TYPE hi, lo, m, mhi, mlo;
+
+    BBI_UMUL(hi, lo, a, b);
+    m = lo * prime.p_inv;
+    BBI_UMUL(mhi, mlo, m, prime.p);
+    (void)mlo;
+    return hi + mhi + (lo != 0);
+}
+
+static inline BBI_BASE_TYPE bbi_ntt_reduce(BBI_BASE_TYPE a, BBI_BASE_TYPE m)
+{
+    return (a >= m ? a - m : a);
+}
+
+//
+//  base^e mod p, in and out in Montgomery form (below p)
+static BBI_BASE_TYPE bbi_ntt_pow(BBI_BASE_TYPE base, BBI_BASE_TYPE e, 
+                                 const bbi_ntt_prime &prime)
+{
+    BBI_BASE_TYPE result;
+
+    result = prime.one;
+    while (e != 0) {
+        if (e & 1) {
+            result = bbi_ntt_reduce(bbi_ntt_mul(result, base, prime), prime.p);
+        }
+        base = bbi_ntt_reduce(bbi_ntt_mul(base, base, prime), prime.p);
+        e >>= 1;
+    }
+    return result;
+}
+
+//  a (below p) in Montgomery form
+static BBI_BASE_TYPE bbi_ntt_to_mont(BBI_BASE_TYPE a, const bbi_ntt_prime &prime)
+{
+    return bbi_ntt_reduce(bbi_ntt_mul(a, prime.r2, prime), prime.p);
+}
+
+static bbi_ntt_prime bbi_ntt_make_prime(BBI_BASE_TYPE p, BBI_BASE_TYPE generator)
+{
+    bbi_ntt_prime prime;
+    BBI_BASE_TYPE inv, hi, lo, quot;
+    int i;
+
+    // Newton's iteration doubles the good bits, and p is its own 
+    // inverse to 3 bits
+    inv = p;
+    for (i = 0; i < 5; i++) {
+        inv *= 2 - (p * inv);
+    }
+
+    prime.p = p;
+    prime.p_inv = 0 - inv;
+    prime.one = (0 - p) % p;
+    BBI_UMUL(hi, lo, prime.one, prime.one);
+    BBI_UDIV(quot, prime.r2, hi, lo, p);
+    (void)quot;
+    prime.generator = bbi_ntt_to_mont(generator, prime);
+    return prime;
+}
+
+static bbi_ntt_constants bbi_ntt_setup()
+{
+    bbi_ntt_constants ntt;
+    const bbi_ntt_prime *primes;
+    BBI_BASE_TYPE p0p1;
+
+    ntt.primes[0] = bbi_ntt_make_prime(0x3FDC000000000001ULL, 3);    // 4087 2^50 + 1
+    ntt.primes[1] = bbi_ntt_make_prime(0x3F18000000000001ULL, 10);   // 4038 2^50 + 1
+    ntt.primes[2] = bbi_ntt_make_prime(0x3EC4000000000001ULL, 37);   // 4017 2^50 + 1
+    primes = ntt.primes;
+
+    // Inverses by Fermat, a^(p - 2)
+    ntt.inv_p0 = bbi_ntt_pow(bbi_ntt_to_mont(primes[0].p - primes[1].p, primes[1]), 
+                             primes[1].p - 2, primes[1]);
+    ntt.p0_mod_p2 = bbi_ntt_to_mont(primes[0].p - primes[2].p, primes[2]);
+    p0p1 = bbi_ntt_reduce(bbi_ntt_mul(ntt.p0_mod_p2, 
+                                      bbi_ntt_to_mont(primes[1].p - primes[2].p, primes[2]), 
+                                      primes[2]), primes[2].p);
+    ntt.inv_p0p1 = bbi_ntt_pow(p0p1, primes[2].p - 2, primes[2]);
+    BBI_UMUL(ntt.p0p1[1], ntt.p0p1[0], primes[0].p, primes[1].p);
+    return ntt;
+}
+
+static const bbi_ntt_constants &bbi_ntt()
+{
+    static const bbi_ntt_constants ntt = bbi_ntt_setup();
+    return ntt;
+}
+
+//
+//  roots[h + j] = w^j for the 2h-th root of unity w = root^(n / 2h),
+//  j < h, for h = n/2, n/4, .. 1 (each level's twiddle factors, in 
+//  Montgomery form).  Only the top level is multiplied out; every 
+//  other one is every second entry of the level above.
+static void bbi_ntt_roots(BBI_BASE_TYPE *roots, unsigned long n, BBI_BASE_TYPE root, 
+                          const bbi_ntt_prime &prime)
+{
+    unsigned long h, j;
+
+    h = n / 2;
+    roots[h] = prime.one;
+    for (j = 1; j < h; j++) {
+        roots[h + j] = bbi_ntt_reduce(bbi_ntt_mul(roots[h + j - 1], root, prime), prime.p);
+    }
+    for (h /= 2; h >= 1; h /= 2) {
+        for (j = 0; j < h; j++) {
+            roots[h + j] = roots[(2 * h) + (2 * j)];
+        }
+    }
+}
+
+//
+//  Butterflies first to last of the forward transform's block a, 
+//  pairing a[j] with a[j + h] (w the level's twiddles).  Takes and 
+//  leaves values below 2p.
+static inline void bbi_ntt_forward_span(BBI_BASE_TYPE *a, unsigned long h, 
+                                        unsigned long first, unsigned long last, 
+                                        const BBI_BASE_TYPE *w, const bbi_ntt_prime &prime)
+{
+    BBI_BASE_TYPE p2, u, v, sum;
+    unsigned long j;
+
+    p2 = 2 * prime.p;
+    for (j = first; j < last; j++) {
+        u = a[j];
+        v = a[j + h];
+        sum = u + v;
+        a[j] = (sum >= p2 ? sum - p2 : sum);
+        a[j + h] = bbi_ntt_mul(u - v + p2, w[j], prime);
+    }
+}
+
+//
+//  The inverse transform's, the other way round.  Takes and leaves 
+//  values below 4p.
+static inline void bbi_ntt_inverse_span(BBI_BASE_TYPE *a, unsigned long h, 
+                                        unsigned long first, unsigned long last, 
+                                        const BBI_BASE_TYPE *w, const bbi_ntt_prime &prime)
+{
+    BBI_BASE_TYPE p2, u, v;
+    unsigned long j;
+
+    p2 = 2 * prime.p;
+    for (j = first; j < last; j++) {
+        u = a[j];
+        u = (u >= p2 ? u - p2 : u);
+        v = bbi_ntt_mul(a[j + h], w[j], prime);
+        a[j] = u + v;
+        a[j + h] = u - v + p2;
+    }
+}
+
+//
+//  One level of the forward transform:  the butterflies m/2 apart in
+//  each m point block of a (n points)
+static void bbi_ntt_forward_level(BBI_BASE_TYPE *a, unsigned long n, unsigned long m, 
+                                  const BBI_BASE_TYPE *roots, const bbi_ntt_prime &prime)
+{
+    unsigned long i;
+
+    for (i = 0; i < n; i += m) {
+        bbi_ntt_forward_span(a + i, m / 2, 0, m / 2, roots + (m / 2), prime);
+    }
+}
+
+static void bbi_ntt_inverse_level(BBI_BASE_TYPE *a, unsigned long n, unsigned long m, 
+                                  const BBI_BASE_TYPE *roots, const bbi_ntt_prime &prime)
+{
+    unsigned long i;
+
+    for (i = 0; i < n; i += m) {
+        bbi_ntt_inverse_span(a + i, m / 2, 0, m / 2, roots + (m / 2), prime);
+    }
+}
+
+//
+//  The transforms of a (n points, a power of two), in place
+static void bbi_ntt_forward(BBI_BASE_TYPE *a, unsigned long n, 
+                            const BBI_BASE_TYPE *roots, const bbi_ntt_prime &prime)
+{
+    unsigned long m;
+
+    if (n > BBI_NTT_BLOCK) {
+        bbi_ntt_forward_level(a, n, n, roots, prime);
+        bbi_ntt_forward(a, n / 2, roots, prime);
+        bbi_ntt_forward(a + (n / 2), n / 2, roots, prime);
+        return;
+    }
+    for (m = n; m >= 2; m /= 2) {
+        bbi_ntt_forward_level(a, n, m, roots, prime);
+    }
+}
+
+static void bbi_ntt_inverse(BBI_BASE_TYPE *a, unsigned long n, 
+                            const BBI_BASE_TYPE *roots, const bbi_ntt_prime &prime)
+{
+    unsigned long m;
+
+    if (n > BBI_NTT_BLOCK) {
+        bbi_ntt_inverse(a, n / 2, roots, prime);
+        bbi_ntt_inverse(a + (n / 2), n / 2, roots, prime);
+        bbi_ntt_inverse_level(a, n, n, roots, prime);
+        return;
+    }
+    for (m = 2; m <= n; m *= 2) {
+        bbi_ntt_inverse_level(a, n, m, roots, prime);
+    }
+}
+
+//
+//  Points first to last of a (an limbs, then zeros) mod p, into x.
+//  Times 1 in Montgomery form is a limb mod p, below 2p.
+static void bbi_ntt_convert(BBI_BASE_TYPE *x, const BBI_BASE_TYPE *a, unsigned long an, 
+                            unsigned long first, unsigned long last, 
+                            const bbi_ntt_prime &prime)
+{
+    unsigned long i, end;
+
+    end = MAX(MIN(an, last), first);
+    for (i = first; i < end; i++) {
+        x[i] = bbi_ntt_mul(a[i], prime.one, prime);
+    }
+    memset(x + end, 0, (last - end) * sizeof(BBI_BASE_TYPE));
+}
+
+//
+//  The forward transform of a (an limbs), into x (n points)
+static void bbi_ntt_load(BBI_BASE_TYPE *x, unsigned long n, const BBI_BASE_TYPE *a, 
+                         unsigned long an, const BBI_BASE_TYPE *roots, 
+                         const bbi_ntt_prime &prime)
+{
+    bbi_ntt_convert(x, a, an, 0, n, prime);
+    bbi_ntt_forward(x, n, roots, prime);
+}
+
+//
+//  The pointwise products come out of REDC over 2^64, and the inverse
+//  transform leaves them n times over, so they're scaled by 2^64 / n
+//  (in Montgomery form, 2^128 / n)
+static BBI_BASE_TYPE bbi_ntt_scale(unsigned long n, const bbi_ntt_prime &prime)
+{
+    BBI_BASE_TYPE scale;
+
+    scale = bbi_ntt_pow(bbi_ntt_to_mont(n, prime), prime.p - 2, prime);
+    return bbi_ntt_reduce(bbi_ntt_mul(scale, prime.r2, prime), prime.p);
+}
+
+//  x = x * y * scale, points first to last (y == x squares)
+static void bbi_ntt_pointwise(BBI_BASE_TYPE *x, const BBI_BASE_TYPE *y, 
+                              unsigned long first, unsigned long last, 
+                              BBI_BASE_TYPE scale, const bbi_ntt_prime &prime)
+{
+    unsigned long i;
+
+    for (i = first; i < last; i++) {
+        x[i] = bbi_ntt_mul(bbi_ntt_mul(x[i], y[i], prime), scale, prime);
+    }
+}
+
+//
+//  Coefficients first to last of the product, from their residues:
+//  each one, v0 + v1 p0 + v2 p0 p1 (Garner), goes into three limbs 
+//  x2 x1 x0, added in at its place with the carry (two limbs) from 
+//  the one before.  carry is the carry into first going in, and out 
+//  of last - 1 (for last and last + 1) coming out.
+static void bbi_ntt_garner(BBI_BASE_TYPE *r, BBI_BASE_TYPE *const *residues, 
+                           unsigned long first, unsigned long last, BBI_BASE_TYPE *carry)
+{
+    const bbi_ntt_constants &ntt = bbi_ntt();
+    BBI_BASE_TYPE v0, v1, v2, t, hi, lo, hi2, lo2, x0, x1, x2, carry0, carry1, k;
+    unsigned long i;
+
+    carry0 = carry[0];
+    carry1 = carry[1];
+    for (i = first; i < last; i++) {
+        v0 = bbi_ntt_reduce(bbi_ntt_reduce(residues[0][i], 2 * ntt.primes[0].p), ntt.primes[0].p);
+        v1 = bbi_ntt_reduce(bbi_ntt_reduce(residues[1][i], 2 * ntt.primes[1].p), ntt.primes[1].p);
+        v2 = bbi_ntt_reduce(bbi_ntt_reduce(residues[2][i], 2 * ntt.primes[2].p), ntt.primes[2].p);
+
+        t = bbi_ntt_reduce(v0, ntt.primes[1].p);
+        t = (v1 >= t ? v1 - t : v1 + ntt.primes[1].p - t);
+        v1 = bbi_ntt_reduce(bbi_ntt_mul(t, ntt.inv_p0, ntt.primes[1]), ntt.primes[1].p);
+
+        t = bbi_ntt_reduce(v0, ntt.primes[2].p) + 
+            bbi_ntt_mul(v1, ntt.p0_mod_p2, ntt.primes[2]);
+        t = bbi_ntt_reduce(bbi_ntt_reduce(t, 2 * ntt.primes[2].p), ntt.primes[2].p);
+        t = (v2 >= t ? v2 - t : v2 + ntt.primes[2].p - t);
+        v2 = bbi_ntt_reduce(bbi_ntt_mul(t, ntt.inv_p0p1, ntt.primes[2]), ntt.primes[2].p);
+
+        // v0 + v1 p0 is below p0 p1, well inside two limbs
+        BBI_UMUL(hi, lo, v1, ntt.primes[0].p);
+        x0 = v0 + lo;
+        x1 = hi + (x0 < lo);
+
+        BBI_UMUL(hi, lo, v2, ntt.p0p1[0]);
+        BBI_UMUL(hi2, lo2, v2, ntt.p0p1[1]);
+        x0 += lo;
+        k = (x0 < lo);
+        x1 += k;
+        x2 = hi2 + (x1 < k);
+        lo2 += hi;
+        x2 += (lo2 < hi);
+        x1 += lo2;
+        x2 += (x1 < lo2);
+
+        x0 += carry0;
+        k = (x0 < carry0);
+        x1 += k;
+        x2 += (x1 < k);
+        x1 += carry1;
+        x2 += (x1 < carry1);
+
+        r[i] = x0;
+        carry0 = x1;
+        carry1 = x2;
+    }
+    carry[0] = carry0;
+    carry[1] = carry1;
+}
+
+//
+//  The transform length for an an by bn limb product
+static unsigned long bbi_ntt_length(unsigned long an, unsigned long bn)
+{
+    unsigned long n;
+
+    n = 2;
+    while (n < an + bn - 1) {
+        n *= 2;
+    }
+    return n;
+}
+
+//
+//  r = a * b  (a is an limbs, b is bn limbs, r gets an + bn), with 
+//  the transforms above.  a == b squares, with one forward transform
+//  per prime rather than two.
+static void bbi_mul_fft(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long an, 
+                        const BBI_BASE_TYPE *b, unsigned long bn)
+{
+    const bbi_ntt_constants &ntt = bbi_ntt();
+    BBI_BASE_TYPE *residues[BBI_NTT_PRIMES], *x, *y, *roots;
+    BBI_BASE_TYPE root, carry[2];
+    unsigned long n, num_coeffs;
+    int j;
+    bool square;
+
+    square = (a == b && an == bn);
+    num_coeffs = an + bn - 1;
+    n = bbi_ntt_length(an, bn);
+
+    bbi_tmp_scope tmp;
+    for (j = 0; j < BBI_NTT_PRIMES; j++) {
+        residues[j] = tmp.alloc(n);
+    }
+    y = (square ? NULL : tmp.alloc(n));
+    roots = tmp.alloc(n);
+
+    for (j = 0; j < BBI_NTT_PRIMES; j++) {
+        const bbi_ntt_prime &prime = ntt.primes[j];
+
+        root = bbi_ntt_pow(prime.generator, (prime.p - 1) / n, prime);
+        bbi_ntt_roots(roots, n, root, prime);
+        x = residues[j];
+        bbi_ntt_load(x, n, a, an, roots, prime);
+        if (!square) {
+            bbi_ntt_load(y, n, b, bn, roots, prime);
+        }
+        bbi_ntt_pointwise(x, square ? x : y, 0, n, bbi_ntt_scale(n, prime), prime);
+
+        // The inverse transform's twiddles are the powers of 1/root
+        bbi_ntt_roots(roots, n, bbi_ntt_pow(root, n - 1, prime), prime);
+        bbi_ntt_inverse(x, n, roots, prime);
+    }
+
+    carry[0] = carry[1] = 0;
+    bbi_ntt_garner(r, residues, 0, num_coeffs, carry);
+    r[num_coeffs] = carry[0];
+}
+
+//
+//  Parallel multiplication
+//
+//  From the size set with bbi_set_mul_threads up, bbi_mul hands the
+//  three products of the top few Karatsuba levels to a pool of 
+//  worker threads as jobs, and does the rest of each step (the 
+//  differences going in, the middle term coming out) itself.  A 
+//  thread that has queued jobs runs the first, and then, rather 
+//  than sleep, takes any still queued (its own, or anybody's) until
+//  its own are done.  That keeps a job waiting on jobs of its own 
+//  from holding up a thread:  what it waits for is either still 
+//  queued, and so gets run, or already running somewhere else.
+//
+//  Every job runs on its thread's own scratch stack.  A job taken 
+//  while waiting is finished (and its scratch released) before the
+//  wait returns, so the stacks stay LIFO.
+//
+//  FFT products are split by their points instead (see the parallel
+//  FFT below), with the same pool.
+//
+#define BBI_MUL_PARALLEL_PIECES     8       // jobs per thread to aim for
+#define BBI_MUL_PARALLEL_MIN_JOB    256     // limbs
+
+struct bbi_ntt_par;
+struct bbi_mul_job;
+
+static void bbi_mul_karatsuba_job(bbi_mul_job *job);
+
+struct bbi_mul_job
+{
+    void (*run)(bbi_mul_job *job);
+    BBI_BASE_TYPE *r;
+    const BBI_BASE_TYPE *a, *b;
+    unsigned long n;
+    unsigned int depth;
+    int *pending;       // jobs in its set not done yet (under the pool lock)
+
+    // FFT jobs:  the product, the prime, the points to do (or the 
+    // block's butterflies) and, for Garner, the carry out of them
+    const bbi_ntt_par *fft;
+    int index;
+    unsigned long first, last;
+    BBI_BASE_TYPE carry[2];
+};
+
+class bbi_mul_pool
+{
+public:
+    bbi_mul_pool() : _stop(false) {}
+    ~bbi_mul_pool() { this->resize(1); }
+
+    unsigned int resize(unsigned int num_threads);
+    void run(bbi_mul_job *jobs, int num_jobs);
+
+private:
+    std::mutex _lock;
+    std::condition_variable _wake;
+    std::deque<bbi_mul_job *> _queue;
+    std::vector<std::thread> _workers;
+    bool _stop;
+
+    void _worker();
+    void _run_job(bbi_mul_job *job, std::unique_lock<std::mutex> &lock);
+};
+
+static std::atomic<unsigned int> bbi_mul_num_threads(1);
+static std::atomic<unsigned long> bbi_mul_parallel_min(BBI_MUL_PARALLEL_THRESHOLD);
+
+//  Made the first time it's needed, so it's there for anyone's 
+//  static constructors, and gone (its threads joined) at exit
+static bbi_mul_pool &bbi_mul_threads_pool()
+{
+    static bbi_mul_pool pool;
+
+    return pool;
+}
+
+//
+//  Stops the workers and starts num_threads - 1 new ones (the thread
+//  asking for a product is the other one).  Returns how many threads
+//  that makes, which is fewer if the system won't start them all.
+unsigned int bbi_mul_pool::resize(unsigned int num_threads)
+{
+    unsigned int i;
+
+    {
+        std::lock_guard<std::mutex> guard(this->_lock);
+        this->_stop = true;
+    }
+    this->_wake.notify_all();
+    for (i = 0; i < this->_workers.size(); i++) {
+        this->_workers[i].join();
+    }
+    this->_workers.clear();
+    this->_stop = false;
+
+    for (i = 1; i < num_threads; i++) {
+        try {
+            this->_workers.push_back(std::thread(&bbi_mul_pool::_worker, this));
+        }
+        catch (const std::system_error &) {
+            break;
+        }
+    }
+    return (unsigned int)this->_workers.size() + 1;
+}
+
+//
+//  Runs the jobs (on this thread and any free workers) and returns 
+//  when they're all done
+void bbi_mul_pool::run(bbi_mul_job *jobs, int num_jobs)
+{
+    std::unique_lock<std::mutex> lock(this->_lock);
+    bbi_mul_job *job;
+    int pending, i;
+
+    pending = num_jobs;
+    for (i = 0; i < num_jobs; i++) {
+        jobs[i].pending = &pending;
+    }
+    for (i = 1; i < num_jobs; i++) {
+        this->_queue.push_back(&jobs[i]);
+    }
+    this->_wake.notify_all();
+    this->_run_job(&jobs[0], lock);
+
+    // The newest jobs are the smallest and likely our own, so take 
+    // from the back and leave the big ones at the front to the workers
+    while (pending != 0) {
+        if (this->_queue.empty()) {
+            this->_wake.wait(lock);
+            continue;
+        }
+        job = this->_queue.back();
+        this->_queue.pop_back();
+        this->_run_job(job, lock);
+    }
+}
+
+void bbi_mul_pool::_worker()
+{
+    std::unique_lock<std::mutex> lock(this->_lock);
+    bbi_mul_job *job;
+
+    while (!this->_stop) {
+        if (this->_queue.empty()) {
+            this->_wake.wait(lock);
+            continue;
+        }
+        job = this->_queue.front();
+        this->_queue.pop_front();
+        this->_run_job(job, lock);
+    }
+}
+
+//
+//  Called and returns with the lock held
+void bbi_mul_pool::_run_job(bbi_mul_job *job, std::unique_lock<std::mutex> &lock)
+{
+    lock.unlock();
+    job->run(job);
+    lock.lock();
+
+    if (--(*job->pending) == 0) {
+        this->_wake.notify_all();
+    }
+}
+
+//
+//  Levels of an n limb product to split across the threads (0 to 
+//  keep it on this one).  Each level makes three times the jobs at
+//  half the size, and it's worth going until there are several jobs
+//  per thread so that the last ones to finish aren't left running 
+//  on their own.
+static unsigned int bbi_mul_parallel_depth(unsigned long n)
+{
+    unsigned long num_threads, num_jobs;
+    unsigned int depth;
+
+    num_threads = bbi_mul_num_threads.load(std::memory_order_relaxed);
+    if (num_threads < 2 || n < bbi_mul_parallel_min.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+
+    depth = 0;
+    num_jobs = 1;
+    while (num_jobs < num_threads * BBI_MUL_PARALLEL_PIECES && 
+           (n >> (depth + 1)) >= BBI_MUL_PARALLEL_MIN_JOB) {
+        depth++;
+        num_jobs *= 3;
+    }
+    return depth;
+}
+
+//
+//  r = a * b  (n limbs each, 2n limbs out), bbi_mul_karatsuba with
+//  the products of the top depth levels run as pool jobs.  Takes its
+//  scratch from the stack of whichever thread it's on.
+static void bbi_mul_karatsuba_par(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                                  const BBI_BASE_TYPE *b, unsigned long n, 
+                                  unsigned int depth)
+{
+    bbi_mul_job jobs[3];
+    BBI_BASE_TYPE *diff_a, *diff_b, *prod, *middle;
+    unsigned long h, m;
+    bool prod_negative;
+
+    bbi_tmp_scope tmp;
+    if (depth == 0 || n < BBI_MUL_KARATSUBA_THRESHOLD) {
+        bbi_mul_karatsuba(r, a, b, n, tmp.alloc(bbi_mul_karatsuba_scratch(n)));
+        return;
+    }
+
+    h = n / 2;
+    m = n - h;
+    diff_a = tmp.alloc((6 * m) + 1);
+    diff_b = diff_a + m;
+    prod = diff_b + m;
+    middle = prod + (2 * m);
+
+    prod_negative = bbi_karatsuba_diffs(diff_a, diff_b, a, b, h, m);
+
+    jobs[0].r = r + (2 * h);
+    jobs[0].a = a + h;
+    jobs[0].b = b + h;
+    jobs[0].n = m;
+    jobs[1].r = prod;
+    jobs[1].a = diff_a;
+    jobs[1].b = diff_b;
+    jobs[1].n = m;
+    jobs[2].r = r;
+    jobs[2].a = a;
+    jobs[2].b = b;
+    jobs[2].n = h;
+    jobs[0].depth = jobs[1].depth = jobs[2].depth = depth - 1;
+    jobs[0].run = jobs[1].run = jobs[2].run = bbi_mul_karatsuba_job;
+    bbi_mul_threads_pool().run(jobs, 3);
+
+    bbi_karatsuba_combine(r, prod, middle, n, h, m, prod_negative);
+}
+
+static void bbi_mul_karatsuba_job(bbi_mul_job *job)
+{
+    bbi_mul_karatsuba_par(job->r, job->a, job->b, job->n, job->depth);
+}
+
+//
+//  Parallel FFT
+//
+//  Each step of bbi_mul_fft is cut into pieces of its points for 
+//  each prime:  the twiddles and the operands mod p going in, the 
+//  pointwise products (and the inverse twiddles) in the middle, and
+//  Garner coming out.  A transform does its top level in pieces and
+//  then its two halves as two jobs, and so on down until there are 
+//  about as many as threads.  The only part left on one thread is
+//  adding in the carry out of each Garner piece.
+//
+//  Every prime has its own twiddles (each level's worked out on its
+//  own, rather than copied from the one above) and its own copy of 
+//  b, so it takes 9n limbs of scratch for n points where the single
+//  thread version takes 5n.
+//
+struct bbi_ntt_par
+{
+    const BBI_BASE_TYPE *a, *b;
+    unsigned long an, bn, n;
+    BBI_BASE_TYPE *residues[BBI_NTT_PRIMES];
+    BBI_BASE_TYPE *y[BBI_NTT_PRIMES];           // NULL to square
+    BBI_BASE_TYPE *roots[BBI_NTT_PRIMES];
+    BBI_BASE_TYPE root[BBI_NTT_PRIMES], inverse_root[BBI_NTT_PRIMES];
+    BBI_BASE_TYPE scale[BBI_NTT_PRIMES];
+};
+
+//
+//  roots[first .. last) of the table bbi_ntt_roots makes, each level's
+//  from its own root
+static void bbi_ntt_roots_range(BBI_BASE_TYPE *roots, unsigned long n, BBI_BASE_TYPE root, 
+                                unsigned long first, unsigned long last, 
+                                const bbi_ntt_prime &prime)
+{
+    BBI_BASE_TYPE step, w;
+    unsigned long h, end, i;
+
+    // roots[0] isn't used
+    i = MAX(first, 1UL);
+    while (i < last) {
+        h = 1UL << (BBI_BASE_BITS - 1 - BBI_CLZ((BBI_BASE_TYPE)i));
+        end = MIN(last, 2 * h);
+        step = bbi_ntt_pow(root, n / (2 * h), prime);
+        w = bbi_ntt_pow(step, i - h, prime);
+        for (; i < end; i++) {
+            roots[i] = w;
+            w = bbi_ntt_reduce(bbi_ntt_mul(w, step, prime), prime.p);
+        }
+    }
+}
+
+//
+//  Adds copies of job to jobs, for count points cut into num pieces
+static void bbi_ntt_split(std::vector<bbi_mul_job> &jobs, bbi_mul_job job, 
+                          unsigned long count, unsigned long num)
+{
+    unsigned long k;
+
+    for (k = 0; k < num; k++) {
+        job.first = (count * k) / num;
+        job.last = (count * (k + 1)) / num;
+        jobs.push_back(job);
+    }
+}
+
+static void bbi_ntt_setup_job(bbi_mul_job *job)
+{
+    const bbi_ntt_par *fft = job->fft;
+    const bbi_ntt_prime &prime = bbi_ntt().primes[job->index];
+
+    bbi_ntt_roots_range(fft->roots[job->index], fft->n, fft->root[job->index], 
+                        job->first, job->last, prime);
+    bbi_ntt_convert(fft->residues[job->index], fft->a, fft->an, job->first, job->last, prime);
+    if (fft->y[job->index] != NULL) {
+        bbi_ntt_convert(fft->y[job->index], fft->b, fft->bn, job->first, job->last, prime);
+    }
+}
+
+static void bbi_ntt_middle_job(bbi_mul_job *job)
+{
+    const bbi_ntt_par *fft = job->fft;
+    const bbi_ntt_prime &prime = bbi_ntt().primes[job->index];
+    BBI_BASE_TYPE *x;
+
+    x = fft->residues[job->index];
+    bbi_ntt_pointwise(x, (fft->y[job->index] != NULL) ? fft->y[job->index] : x, 
+                      job->first, job->last, fft->scale[job->index], prime);
+    bbi_ntt_roots_range(fft->roots[job->index], fft->n, fft->inverse_root[job->index], 
+                        job->first, job->last, prime);
+}
+
+static void bbi_ntt_garner_job(bbi_mul_job *job)
+{
+    bbi_ntt_garner(job->r, job->fft->residues, job->first, job->last, job->carry);
+}
+
+//  Butterflies first to last of the top level of block r (n points)
+static void bbi_ntt_forward_level_job(bbi_mul_job *job)
+{
+    bbi_ntt_forward_span(job->r, job->n / 2, job->first, job->last, 
+                         job->fft->roots[job->index] + (job->n / 2), 
+                         bbi_ntt().primes[job->index]);
+}
+
+static void bbi_ntt_inverse_level_job(bbi_mul_job *job)
+{
+    bbi_ntt_inverse_span(job->r, job->n / 2, job->first, job->last, 
+                         job->fft->roots[job->index] + (job->n / 2), 
+                         bbi_ntt().primes[job->index]);
+}
+
+//
+//  The transforms of block r (n points) in about depth pieces:  the
+//  top level in pieces and each half in half as many, down to one
+static void bbi_ntt_transform_job(bbi_mul_job *job, bool forward)
+{
+    std::vector<bbi_mul_job> jobs;
+    bbi_mul_job level, half;
+    unsigned long n;
+
+    n = job->n;
+    if (job->depth < 2 || n <= BBI_NTT_BLOCK) {
+        if (forward) {
+            bbi_ntt_forward(job->r, n, job->fft->roots[job->index], bbi_ntt().primes[job->index]);
+        }
+        else {
+            bbi_ntt_inverse(job->r, n, job->fft->roots[job->index], bbi_ntt().primes[job->index]);
+        }
+        return;
+    }
+
+    level = *job;
+    level.run = (forward ? bbi_ntt_forward_level_job : bbi_ntt_inverse_level_job);
+    half = *job;
+    half.n = n / 2;
+    half.depth = (job->depth + 1) / 2;
+
+    if (forward) {
+        bbi_ntt_split(jobs, level, n / 2, MIN((unsigned long)job->depth, n / BBI_NTT_BLOCK));
+        bbi_mul_threads_pool().run(&jobs[0], (int)jobs.size());
+        jobs.clear();
+    }
+    jobs.push_back(half);
+    half.r += n / 2;
+    jobs.push_back(half);
+    bbi_mul_threads_pool().run(&jobs[0], (int)jobs.size());
+    if (!forward) {
+        jobs.clear();
+        bbi_ntt_split(jobs, level, n / 2, MIN((unsigned long)job->depth, n / BBI_NTT_BLOCK));
+        bbi_mul_threads_pool().run(&jobs[0], (int)jobs.size());
+    }
+}
+
+static void bbi_ntt_forward_job(bbi_mul_job *job)
+{
+    bbi_ntt_transform_job(job, true);
+}
+
+static void bbi_ntt_inverse_job(bbi_mul_job *job)
+{
+    bbi_ntt_transform_job(job, false);
+}
+
+//
+//  r = a * b as bbi_mul_fft does it, split across the pool
+static void bbi_mul_fft_par(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long an, 
+                            const BBI_BASE_TYPE *b, unsigned long bn)
+{
+    const bbi_ntt_constants &ntt = bbi_ntt();
+    std::vector<bbi_mul_job> jobs;
+    bbi_mul_job job;
+    bbi_ntt_par fft;
+    BBI_BASE_TYPE carry;
+    unsigned long num_coeffs, num_pieces, k;
+    unsigned int num_threads;
+    int j;
+    bool square;
+
+    square = (a == b && an == bn);
+    num_coeffs = an + bn - 1;
+    num_threads = bbi_mul_num_threads.load(std::memory_order_relaxed);
+    fft.a = a;
+    fft.an = an;
+    fft.b = b;
+    fft.bn = bn;
+    fft.n = bbi_ntt_length(an, bn);
+    num_pieces = MAX(MIN((unsigned long)num_threads * BBI_MUL_PARALLEL_PIECES, 
+                         fft.n / BBI_NTT_BLOCK), 1UL);
+
+    bbi_tmp_scope tmp;
+    for (j = 0; j < BBI_NTT_PRIMES; j++) {
+        const bbi_ntt_prime &prime = ntt.primes[j];
+
+        fft.residues[j] = tmp.alloc(fft.n);
+        fft.y[j] = (square ? NULL : tmp.alloc(fft.n));
+        fft.roots[j] = tmp.alloc(fft.n);
+        fft.root[j] = bbi_ntt_pow(prime.generator, (prime.p - 1) / fft.n, prime);
+        fft.inverse_root[j] = bbi_ntt_pow(fft.root[j], fft.n - 1, prime);
+        fft.scale[j] = bbi_ntt_scale(fft.n, prime);
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.fft = &fft;
+
+    // The twiddles and the operands mod each prime
+    job.run = bbi_ntt_setup_job;
+    for (j = 0; j < BBI_NTT_PRIMES; j++) {
+        job.index = j;
+        bbi_ntt_split(jobs, job, fft.n, num_pieces);
+    }
+    bbi_mul_threads_pool().run(&jobs[0], (int)jobs.size());
+    jobs.clear();
+
+    // Their transforms
+    job.run = bbi_ntt_forward_job;
+    job.n = fft.n;
+    job.depth = num_threads;
+    for (j = 0; j < BBI_NTT_PRIMES; j++) {
+        job.index = j;
+        job.r = fft.residues[j];
+        jobs.push_back(job);
+        if (!square) {
+            job.r = fft.y[j];
+            jobs.push_back(job);
+        }
+    }
+    bbi_mul_threads_pool().run(&jobs[0], (int)jobs.size());
+    jobs.clear();
+
+    // The pointwise products, and the inverse twiddles in place of 
+    // the forward ones
+    job.run = bbi_ntt_middle_job;
+    for (j = 0; j < BBI_NTT_PRIMES; j++) {
+        job.index = j;
+        bbi_ntt_split(jobs, job, fft.n, num_pieces);
+    }
+    bbi_mul_threads_pool().run(&jobs[0], (int)jobs.size());
+    jobs.clear();
+
+    job.run = bbi_ntt_inverse_job;
+    for (j = 0; j < BBI_NTT_PRIMES; j++) {
+        job.index = j;
+        job.r = fft.residues[j];
+        jobs.push_back(job);
+    }
+    bbi_mul_threads_pool().run(&jobs[0], (int)jobs.size());
+    jobs.clear();
+
+    // Garner, and then each piece's carry into the start of the next
+    // (and whatever it carries into after that)
+    job.run = bbi_ntt_garner_job;
+    job.r = r;
+    job.index = 0;
+    bbi_ntt_split(jobs, job, num_coeffs, num_pieces);
+    bbi_mul_threads_pool().run(&jobs[0], (int)jobs.size());
+
+    r[num_coeffs] = jobs.back().carry[0];
+    for (k = 0; k + 1 < jobs.size(); k++) {
+        carry = bbi_add_n(r + jobs[k].last, r + jobs[k].last, jobs[k].carry, 2);
+        bbi_add_1(r + jobs[k].last + 2, r + jobs[k].last + 2, num_coeffs - 1 - jobs[k].last, carry);
+    }
+}
+
+void bbi_set_mul_threads(unsigned int num_threads, unsigned long min_limbs)
+{
+    if (num_threads == 0) {
+        num_threads = MAX(std::thread::hardware_concurrency(), 1U);
+    }
+
+    bbi_mul_num_threads.store(1, std::memory_order_relaxed);
+    num_threads = bbi_mul_threads_pool().resize(num_threads);
+    bbi_mul_parallel_min.store(min_limbs, std::memory_order_relaxed);
+    bbi_mul_num_threads.store(num_threads, std::memory_order_relaxed);
+}
+
+unsigned int bbi_mul_threads()
+{
+    return bbi_mul_num_threads.load(std::memory_order_relaxed);
+}
+
+//
+//  r = a * b  (n limbs each), on this thread with scratch when depth
+//  is 0, otherwise split across the pool
+static void bbi_mul_balanced(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                             const BBI_BASE_TYPE *b, unsigned long n, 
+                             BBI_BASE_TYPE *scratch, unsigned int depth)
+{
+    if (depth == 0) {
+        bbi_mul_karatsuba(r, a, b, n, scratch);
+    }
+    else {
+        bbi_mul_karatsuba_par(r, a, b, n, depth);
+    }
+}
+
+//
+//  r = a * b  (a is an limbs, b is bn limbs, an >= bn >= 1)
+//  r must have room for an + bn limbs and must not overlap a or b.
+//
+//  Schoolbook below BBI_MUL_KARATSUBA_THRESHOLD limbs, Karatsuba 
+//  above it and FFT from BBI_MUL_FFT_THRESHOLD, split across threads
+//  from the size set with bbi_set_mul_threads.  Below the FFT a long
+//  a is cut into bn limb pieces, each multiplied by b and added in 
+//  at its offset; the FFT takes it whole.
+void bbi_mul(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long an, 
+             const BBI_BASE_TYPE *b, unsigned long bn)
+{
+    BBI_BASE_TYPE *scratch, *piece;
+    BBI_BASE_TYPE carry;
+    unsigned long offset, piece_size;
+    unsigned int depth;
+
+    if (bn < BBI_MUL_KARATSUBA_THRESHOLD) {
+        bbi_mul_basecase(r, a, an, b, bn);
+        return;
+    }
+
+    depth = bbi_mul_parallel_depth(bn);
+    if (bn >= BBI_MUL_FFT_THRESHOLD) {
+        if (depth == 0) {
+            bbi_mul_fft(r, a, an, b, bn);
+        }
+        else {
+            bbi_mul_fft_par(r, a, an, b, bn);
+        }
+        return;
+    }
+
+    bbi_tmp_scope tmp;
+    scratch = (depth == 0 ? tmp.alloc(bbi_mul_karatsuba_scratch(bn)) : NULL);
+    bbi_mul_balanced(r, a, b, bn, scratch, depth);
+    if (an == bn) return;
+
+    piece = tmp.alloc(2 * bn);
+    for (offset = bn; offset < an; offset += bn) {
+        piece_size = MIN(bn, an - offset);
+        if (piece_size == bn) {
+            bbi_mul_balanced(piece, a + offset, b, bn, scratch, depth);
+        }
+        else {
+            bbi_mul(piece, b, bn, a + offset, piece_size);
+        }
+
+        // r[offset .. offset + bn) already holds the top of the last 
+        // piece, everything above it is new
+        carry = bbi_add_n(r + offset, r + offset, piece, bn);
+        bbi_add_1(r + offset + bn, piece + bn, piece_size, carry);
+    }
+}
+
+//
+//  r = a * a  (n limbs, n >= 1).  r gets 2n limbs and must not 
+//  overlap a.
+//
+//  Each cross product a[i] * a[j] (i < j) shows up twice in the 
+//  square, so we add them up once, double the lot with a one bit
+//  shift and then add the squares of the limbs on the diagonal.
+//  That's about half the limb products bbi_mul would do, but none of
+//  Karatsuba's savings, so from BBI_SQR_KARATSUBA_THRESHOLD limbs up
+//  bbi_mul does the job instead.
+void bbi_sqr(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long n)
+{
+    BBI_BASE_TYPE hi, lo, carry, sum;
+    unsigned long i;
+
+    if (n == 1) {
+        BBI_UMUL(r[1], r[0], a[0], a[0]);
+        return;
+    }
+    if (n >= BBI_SQR_KARATSUBA_THRESHOLD) {
+        bbi_mul(r, a, n, a, n);
+        return;
+    }
+
+    // The cross products, row by row.  Row i starts at r[2i + 1] and
+    // its carry lands on r[n + i], which no earlier row has reached.
+    r[0] = 0;
+    r[n] = bbi_mul_1(r + 1, a + 1, n - 1, a[0]);
+    for (i = 1; i < n - 1; i++) {
+        r[n + i] = bbi_addmul_1(r + (2 * i) + 1, a + i + 1, n - i - 1, a[i]);
+    }
+    r[(2 * n) - 1] = 0;
+
+    // Double them (the top bit is free:  they add up to less than 
+    // half of the square)
+    bbi_lshift(r, r, 2 * n, 1);
+
+    // And the diagonal
+    carry = 0;
+    for (i = 0; i < n; i++) {
+        BBI_UMUL(hi, lo, a[i], a[i]);
+
+        sum = r[2 * i] + carry;
+        carry = (sum < carry);
+        r[2 * i] = sum + lo;
+        carry += (r[2 * i] < lo);
+
+        sum = r[(2 * i) + 1] + carry;
+        carry = (sum < carry);
+        r[(2 * i) + 1] = sum + hi;
+        carry += (r[(2 * i) + 1] < hi);
+    }
+}
+
+//
+//  q = a / d, r = a % d  (Knuth's Algorithm D, TAOCP 4.3.1)
+//
+//  The divisor is shifted until its top bit is set (and the dividend
+//  along with it, into scratch), which makes the two-limb by one-limb
+//  estimate of each quotient limb at most two too big.  The check 
+//  against the second divisor limb almost always fixes that, and the 
+//  rare estimate that is still one too big gets caught by the borrow
+//  out of the multiply-and-subtract and added back.
+void bbi_divrem(BBI_BASE_TYPE *q, BBI_BASE_TYPE *r, 
+                const BBI_BASE_TYPE *a, unsigned long an, 
+                const BBI_BASE_TYPE *d, unsigned long dn, 
+                BBI_BASE_TYPE *scratch)
+{
+    BBI_BASE_TYPE *un, *vn;
+    BBI_BASE_TYPE qhat, rhat, prod_hi, prod_lo, top, borrow, divisor_top;
+    unsigned long j;
+    unsigned int shift;
+    bool rhat_overflow;
+
+    if (dn == 1) {
+        r[0] = bbi_divrem_1(q, a, an, d[0]);
+        return;
+    }
+
+    // Normalized copies:  un is an + 1 limbs, vn is dn limbs
+    un = scratch;
+    vn = scratch + an + 1;
+    shift = BBI_CLZ(d[dn - 1]);
+    if (shift != 0) {
+        bbi_lshift(vn, d, dn, shift);
+        un[an] = bbi_lshift(un, a, an, shift);
+    }
+    else {
+        memcpy(vn, d, dn * sizeof(BBI_BASE_TYPE));
+        memcpy(un, a, an * sizeof(BBI_BASE_TYPE));
+        un[an] = 0;
+    }
+    divisor_top = vn[dn - 1];
+
+    j = an - dn + 1;
+    while (j > 0) {
+        j--;
+
+        // Estimate this quotient limb from the top two limbs.  un's top
+        // limb is never above divisor_top (what's left is always less
+        // than the divisor), and when it's equal the estimate is B - 1.
+        top = un[j + dn];
+        if (top == divisor_top) {
+            qhat = BBI_BASE_MAX;
+            rhat = un[j + dn - 1] + divisor_top;
+            rhat_overflow = (rhat < divisor_top);
+        }
+        else {
+            BBI_UDIV(qhat, rhat, top, un[j + dn - 1], divisor_top);
+            rhat_overflow = false;
+        }
+
+        // Too big if qhat * vn[dn - 2] > (rhat, un[j + dn - 2])
+        while (!rhat_overflow) {
+            BBI_UMUL(prod_hi, prod_lo, qhat, vn[dn - 2]);
+            if (prod_hi < rhat || (prod_hi == rhat && prod_lo <= un[j + dn - 2])) {
+                break;
+            }
+            qhat--;
+            rhat += divisor_top;
+            rhat_overflow = (rhat < divisor_top);
+        }
+
+        // un[j .. j + dn] -= qhat * vn, and add back if that went negative
+        borrow = bbi_submul_1(un + j, vn, dn, qhat);
+        un[j + dn] = top - borrow;
+        if (top < borrow) {
+            qhat--;
+            un[j + dn] += bbi_add_n(un + j, un + j, vn, dn);
+        }
+        q[j] = qhat;
+    }
+
+    // The remainder is what's left in the bottom of un, shifted back
+    if (shift != 0) {
+        bbi_rshift(r, un, dn, shift);
+    }
+    else {
+        memcpy(r, un, dn * sizeof(BBI_BASE_TYPE));
+    }
+}
+
+
+//
+//  Radix conversion
+//
+//  Digits are ASCII ('0'-'9' then lower case letters, either case 
+//  going in), most significant first.  Bases that are a power of two just pick the 
+//  bits out.  The others divide by the "big base" (the largest power
+//  of the base that fits in a limb, 10^19 for decimal) and split each
+//  remainder into digits, so there's one limb division per 19 decimal
+//  digits rather than one per digit.  Reading a string back is the 
+//  same thing with a multiply and add per chunk.  Both are quadratic;
+//  bigbigint's to_string() and from_string() cut big numbers down to
+//  size before calling these.
+//
+static const char bbi_digit_chars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+//
+//  Returns the big base, and the number of digits it holds in *digits
+static BBI_BASE_TYPE bbi_big_base(int base, unsigned int *digits)
+{
+    BBI_BASE_TYPE big_base;
+
+    big_base = (BBI_BASE_TYPE)base;
+    *digits = 1;
+    while (big_base <= BBI_BASE_MAX / (BBI_BASE_TYPE)base) {
+        big_base *= (BBI_BASE_TYPE)base;
+        (*digits)++;
+    }
+    return big_base;
+}
+
+//
+//  Writes the low count digits of val backwards, ending just before end.
+//  Returns the new start.  Decimal gets its own loop so the compiler 
+//  can turn the divisions into multiplications.
+static char *bbi_limb_digits(char *end, BBI_BASE_TYPE val, int base, unsigned int count)
+{
+    if (base == 10) {
+        while (count > 0) {
+            *--end = (char)('0' + val % 10);
+            val /= 10;
+            count--;
+        }
+    }
+    else {
+        while (count > 0) {
+            *--end = bbi_digit_chars[val % (BBI_BASE_TYPE)base];
+            val /= (BBI_BASE_TYPE)base;
+            count--;
+        }
+    }
+    return end;
+}
+
+//
+//  Number of digits a (n limbs) needs in the given base (2 - 36).  
+//  Exact for powers of two, otherwise it may be one too big.  Zero 
+//  takes one digit.
+unsigned long bbi_sizeinbase(const BBI_BASE_TYPE *a, unsigned long n, int base)
+{
+    unsigned long bits;
+    unsigned int log2_base;
+
+    n = bbi_normalize(a, n);
+    if (n == 0) {
+        return 1;
+    }
+    bits = n * BBI_BASE_BITS - BBI_CLZ(a[n - 1]);
+
+    if ((base & (base - 1)) == 0) {
+        log2_base = BBI_CTZ((BBI_BASE_TYPE)base);
+        return (bits + log2_base - 1) / log2_base;
+    }
+
+    // bits * log(2) / log(base), nudged up so rounding can't leave 
+    // it short
+    return (unsigned long)((double)bits * (log(2.0) / log((double)base)) * (1.0 + 1e-12)) + 1;
+}
+
+//
+//  Writes a (n limbs) to str in the given base (2 - 36), without 
+//  leading zeros and without a terminator, and returns the number of
+//  digits.  str must hold bbi_sizeinbase(a, n, base) characters.
+unsigned long bbi_get_str(char *str, int base, const BBI_BASE_TYPE *a, unsigned long n)
+{
+    BBI_BASE_TYPE big_base, rem, *t;
+    unsigned long bits, count, index, i;
+    unsigned int log2_base, digits, shift;
+    char *end, *p;
+
+    n = bbi_normalize(a, n);
+    if (n == 0) {
+        str[0] = '0';
+        return 1;
+    }
+
+    // Power of two:  each digit is a run of log2_base bits, which
+    // may straddle two limbs
+    if ((base & (base - 1)) == 0) {
+        log2_base = BBI_CTZ((BBI_BASE_TYPE)base);
+        bits = n * BBI_BASE_BITS - BBI_CLZ(a[n - 1]);
+        count = (bits + log2_base - 1) / log2_base;
+        for (i = 0; i < count; i++) {
+            index = (i * log2_base) / BBI_BASE_BITS;
+            shift = (i * log2_base) % BBI_BASE_BITS;
+            rem = a[index] >> shift;
+            if (shift + log2_base > BBI_BASE_BITS && index + 1 < n) {
+                rem |= a[index + 1] << (BBI_BASE_BITS - shift);
+            }
+            str[count - 1 - i] = bbi_digit_chars[rem & (base - 1)];
+        }
+        return count;
+    }
+
+    big_base = bbi_big_base(base, &digits);
+    end = str + bbi_sizeinbase(a, n, base);
+    p = end;
+
+    // One limb:  no copy needed
+    if (n == 1) {
+        rem = a[0];
+        while (rem >= big_base) {
+            p = bbi_limb_digits(p, rem % big_base, base, digits);
+            rem /= big_base;
+        }
+    }
+    else {
+        bbi_tmp_scope tmp;
+
+        t = tmp.alloc(n);
+        memcpy(t, a, n * sizeof(BBI_BASE_TYPE));
+        while (n > 1) {
+            rem = bbi_divrem_1(t, t, n, big_base);
+            n -= (t[n - 1] == 0);
+            p = bbi_limb_digits(p, rem, base, digits);
+        }
+        rem = t[0];
+        while (rem >= big_base) {
+            p = bbi_limb_digits(p, rem % big_base, base, digits);
+            rem /= big_base;
+        }
+    }
+
+    // The top chunk, without its leading zeros
+    do {
+        *--p = bbi_digit_chars[rem % (BBI_BASE_TYPE)base];
+        rem /= (BBI_BASE_TYPE)base;
+    } while (rem != 0);
+
+    count = (unsigned long)(end - p);
+    memmove(str, p, count);
+    return count;
+}
+
+
+//
+//  Value of the digit c (0-9, then a-z or A-Z), or 99 if it isn't one
+int bbi_digit_value(char c)
+{
+    if (c >= '0' && c <= '9') return (c - '0');
+    if (c >= 'a' && c <= 'z') return (c - 'a' + 10);
+    if (c >= 'A' && c <= 'Z') return (c - 'A' + 10);
+    return 99;
+}
+
+//
+//  Limbs bbi_set_str needs for len digits in the given base.  Every 
+//  full big base chunk of digits fits in a limb, and for a power of 
+//  two base that's at least as many bits as the digits hold.
+unsigned long bbi_set_str_size(unsigned long len, int base)
+{
+    unsigned int digits;
+
+    bbi_big_base(base, &digits);
+    return (len / digits) + 1;
+}
+
+//
+//  Sets r from the len digits in str (most significant first, all 
+//  valid for the base, no sign).  Returns the number of limbs, without
+//  leading zeros.  r must hold bbi_set_str_size(len, base) limbs.
+unsigned long bbi_set_str(BBI_BASE_TYPE *r, const char *str, unsigned long len, int base)
+{
+    BBI_BASE_TYPE big_base, chunk, carry;
+    unsigned long n, i;
+    unsigned int log2_base, digits, bits, j;
+
+    n = 0;
+
+    // Power of two:  pack the bits in from the least significant digit
+    if ((base & (base - 1)) == 0) {
+        log2_base = BBI_CTZ((BBI_BASE_TYPE)base);
+        chunk = 0;
+        bits = 0;
+        for (i = len; i > 0; i--) {
+            carry = (BBI_BASE_TYPE)bbi_digit_value(str[i - 1]);
+            chunk |= carry << bits;
+            bits += log2_base;
+            if (bits >= BBI_BASE_BITS) {
+                r[n++] = chunk;
+                bits -= BBI_BASE_BITS;
+                chunk = (bits != 0 ? carry >> (log2_base - bits) : 0);
+            }
+        }
+        if (bits != 0) {
+            r[n++] = chunk;
+        }
+        return bbi_normalize(r, n);
+    }
+
+    // Otherwise a chunk of digits at a time:  r = r * big_base + chunk,
+    // with the odd sized chunk first
+    big_base = bbi_big_base(base, &digits);
+    j = (unsigned int)(len % digits);
+    if (j == 0) {
+        j = digits;
+    }
+    for (i = 0; i < len; i += j, j = digits) {
+        chunk = 0;
+        for (bits = 0; bits < j; bits++) {
+            chunk = (chunk * (BBI_BASE_TYPE)base) + (BBI_BASE_TYPE)bbi_digit_value(str[i + bits]);
+        }
+
+        if (n == 0) {
+            r[0] = chunk;
+            n = (chunk != 0);
+            continue;
+        }
+        carry = bbi_mul_1(r, r, n, big_base);
+        carry += bbi_add_1(r, r, n, chunk);
+        if (carry != 0) {
+            r[n++] = carry;
+        }
+    }
+    return n;
+}
+
+
+
+//
+//  Raw import / export
+//
+//  Byte k of the magnitude (k = 0 the lowest) is byte k % size of 
+//  word k / size, and bbi_byte_offset turns that into an offset in 
+//  the buffer.  Going through that a byte at a time always works, but
+//  nearly every format is one of:
+//
+//   - a little endian byte string (order -1, endian -1),
+//   - a big endian byte string (order 1, endian 1, network order), or
+//   - whole 64-bit words in either order, either byte order,
+//
+//  and for those every full limb is one (unaligned) 8 byte move, 
+//  reversed in word order and/or byte swapped.  bbi_move_words does 
+//  that a limb at a time with bswap, or four at a time with AVX2 
+//  (vpshufb swaps the bytes, vpermq reverses the words).  Only the
+//  odd bytes at the top go through the byte loop.
+//
+
+//  Where byte k of the magnitude is in the buffer
+static inline unsigned long bbi_byte_offset(unsigned long k, unsigned long count, 
+                                            int order, unsigned long size, int endian)
+{
+    unsigned long word, byte;
+
+    word = k / size;
+    byte = k % size;
+    if (order > 0) {
+        word = count - 1 - word;
+    }
+    if (endian > 0) {
+        byte = size - 1 - byte;
+    }
+    return (word * size) + byte;
+}
+
+//  Word i of dst = word i of src (or word n - 1 - i when reverse is 
+//  set), byte swapped when swap is set.  8 byte words, any alignment.
+static void bbi_move_words(unsigned char *dst, const unsigned char *src, 
+                           unsigned long n, bool reverse, bool swap)
+{
+    BBI_BASE_TYPE word;
+    unsigned long i;
+
+    i = 0;
+#if defined(__AVX2__)
+    {
+        __m256i swap_mask, vec;
+
+        swap_mask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                     7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+        for (; i + 4 <= n; i += 4) {
+            if (reverse) {
+                vec = _mm256_loadu_si256((const __m256i *)(src + 8 * (n - i - 4)));
+                vec = _mm256_permute4x64_epi64(vec, 0x1B);
+            }
+            else {
+                vec = _mm256_loadu_si256((const __m256i *)(src + 8 * i));
+            }
+            if (swap) {
+                vec = _mm256_shuffle_epi8(vec, swap_mask);
+            }
+            _mm256_storeu_si256((__m256i *)(dst + 8 * i), vec);
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        memcpy(&word, src + 8 * (reverse ? n - 1 - i : i), sizeof(word));
+        if (swap) {
+            word = BBI_BSWAP(word);
+        }
+        memcpy(dst + 8 * i, &word, sizeof(word));
+    }
+}
+
+//
+//  How many of the buffer's low bytes are whole limbs that can go 
+//  through bbi_move_words (limit of them, at most), and how:  the 
+//  buffer offset of the run, and whether it's reversed or swapped.
+//  Returns the number of limbs (0 if the layout has no fast path).
+static unsigned long bbi_word_run(unsigned long count, int order, unsigned long size, 
+                                  int endian, unsigned long limit, unsigned long *offset, 
+                                  bool *reverse, bool *swap)
+{
+    unsigned long total, n;
+
+    total = count * size;
+    *offset = 0;
+    *reverse = (order > 0);
+    *swap = (endian != BBI_HOST_ENDIAN);
+    if (order < 0 && endian < 0) {
+        n = MIN(total / 8, limit);
+    }
+    else if (order > 0 && endian > 0) {
+        n = MIN(total / 8, limit);
+        *offset = total - (8 * n);
+    }
+    else if (size == 8) {
+        n = MIN(count, limit);
+        *offset = (order > 0 ? 8 * (count - n) : 0);
+    }
+    else {
+        return 0;
+    }
+    return n;
+}
+
+//  Limbs needed for count words of size bytes
+unsigned long bbi_import_size(unsigned long count, unsigned long size)
+{
+    return ((count * size) + 7) / 8;
+}
+
+//
+//  r = the count words at data.  Returns the limb count.
+unsigned long bbi_import(BBI_BASE_TYPE *r, unsigned long count, int order, 
+                         unsigned long size, int endian, const void *data)
+{
+    const unsigned char *src;
+    unsigned long total, num_limbs, n, offset, k;
+    bool reverse, swap;
+
+    src = (const unsigned char *)data;
+    total = count * size;
+    num_limbs = bbi_import_size(count, size);
+    if (num_limbs == 0) {
+        return 0;
+    }
+    if (endian == 0) {
+        endian = BBI_HOST_ENDIAN;
+    }
+    if (size == 1) {
+        // Byte order in a one byte word doesn't matter, so this is a
+        // byte string in word order
+        endian = order;
+    }
+
+    n = bbi_word_run(count, order, size, endian, num_limbs, &offset, &reverse, &swap);
+    bbi_move_words((unsigned char *)r, src + offset, n, reverse, swap);
+
+    memset(r + n, 0, (num_limbs - n) * sizeof(BBI_BASE_TYPE));
+    for (k = 8 * n; k < total; k++) {
+        r[k / 8] |= (BBI_BASE_TYPE)src[bbi_byte_offset(k, count, order, size, endian)] << (8 * (k % 8));
+    }
+    return bbi_normalize(r, num_limbs);
+}
+
+//  Words of size bytes needed for a
+unsigned long bbi_export_count(const BBI_BASE_TYPE *a, unsigned long n, unsigned long size)
+{
+    unsigned long bytes;
+
+    n = bbi_normalize(a, n);
+    if (n == 0) {
+        return 0;
+    }
+    bytes = (n * 8) - (BBI_CLZ(a[n - 1]) / 8);
+    return (bytes + size - 1) / size;
+}
+
+//
+//  The low count words of a to data
+void bbi_export(void *data, unsigned long count, int order, unsigned long size, 
+                int endian, const BBI_BASE_TYPE *a, unsigned long n)
+{
+    unsigned char *dst;
+    unsigned long total, limit, run, offset, k;
+    bool reverse, swap;
+
+    dst = (unsigned char *)data;
+    total = count * size;
+    if (endian == 0) {
+        endian = BBI_HOST_ENDIAN;
+    }
+    if (size == 1) {
+        endian = order;
+    }
+
+    // Past the top of a it's all zeros
+    limit = MIN(total, n * 8);
+    if (limit < total) {
+        memset(dst, 0, total);
+    }
+
+    run = bbi_word_run(count, order, size, endian, limit / 8, &offset, &reverse, &swap);
+    bbi_move_words(dst + offset, (const unsigned char *)a, run, reverse, swap);
+
+    for (k = 8 * run; k < limit; k++) {
+        dst[bbi_byte_offset(k, count, order, size, endian)] = (unsigned char)(a[k / 8] >> (8 * (k % 8)));
+    }
+}
+
+//
+//  The scratch stack
+//
+//  Each thread has its own list of blocks.  Allocations bump a 
+//  pointer in the top block; when it's full a new block (at least 
+//  double the last) goes on top, so earlier pointers never move.  
+//  Restoring a mark pops back down to it.  The last block popped is
+//  kept as a spare, which is what makes a loop of same-sized 
+//  multiplications stop calling malloc after the first one.
+//
+#define BBI_TMP_MIN_BLOCK   4096    // limbs
+
+struct bbi_tmp_block
+{
+    bbi_tmp_block *prev;
+    unsigned long size;
+    unsigned long used;
+    BBI_BASE_TYPE *limbs;
+};
+
+struct bbi_tmp_stack
+{
+    bbi_tmp_block *top;
+    bbi_tmp_block *spare;
+
+    ~bbi_tmp_stack()
+    {
+        bbi_tmp_block *block;
+
+        while (top != NULL) {
+            block = top;
+            top = block->prev;
+            free(block);
+        }
+        free(spare);
+    }
+};
+
+static thread_local bbi_tmp_stack bbi_tmp = { NULL, NULL };
+
+bbi_tmp_mark bbi_tmp_save()
+{
+    bbi_tmp_mark mark;
+
+    mark.block = bbi_tmp.top;
+    mark.used = (bbi_tmp.top != NULL ? bbi_tmp.top->used : 0);
+    return mark;
+}
+
+BBI_BASE_TYPE *bbi_tmp_alloc(unsigned long n)
+{
+    bbi_tmp_block *block;
+    BBI_BASE_TYPE *limbs;
+    unsigned long size;
+
+    block = bbi_tmp.top;
+    if (block == NULL || block->size - block->used < n) {
+        size = MAX(n, BBI_TMP_MIN_BLOCK);
+        if (block != NULL) {
+            size = MAX(size, 2 * block->size);
+        }
+
+        if (bbi_tmp.spare != NULL && bbi_tmp.spare->size >= size) {
+            block = bbi_tmp.spare;
+            bbi_tmp.spare = NULL;
+        }
+        else {
+            block = (bbi_tmp_block *)malloc(sizeof(bbi_tmp_block) + 
+                                            (size * sizeof(BBI_BASE_TYPE)));
+            if (block == NULL)
+                exit(2);
+            block->size = size;
+            block->limbs = (BBI_BASE_TYPE *)(block + 1);
+        }
+        block->used = 0;
+        block->prev = bbi_tmp.top;
+        bbi_tmp.top = block;
+    }
+
+    limbs = block->limbs + block->used;
+    block->used += n;
+    return limbs;
+}
+
+void bbi_tmp_restore(bbi_tmp_mark mark)
+{
+    bbi_tmp_block *block;
+
+    while (bbi_tmp.top != mark.block) {
+        block = bbi_tmp.top;
+        bbi_tmp.top = block->prev;
+
+        // Keep the bigger of this one and the old spare
+        if (bbi_tmp.spare == NULL || bbi_tmp.spare->size < block->size) {
+            free(bbi_tmp.spare);
+            bbi_tmp.spare = block;
+        }
+        else {
+            free(block);
+        }
+    }
+    if (bbi_tmp.top != NULL) {
+        bbi_tmp.top->used = mark.used;
+    }
+}
+
@@ -0,0 +1,400 @@
+/*
+ * Name:    BigBigIntMpn.h
+ * Purpose: Unsigned arithmetic on raw limb arrays (the layer under bigbigint)
+ *
+ * Author:  Richard Andrasek
+ * Date:    18-Oct-2026
+ *
+ */
+
+#ifndef __Andrasek_BigBigIntMpn_hpp__
+#define __Andrasek_BigBigIntMpn_hpp__
+
+//-----------------------------------------------------------------------------
+//                            Required Includes
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+//                              Base Defines
+//-----------------------------------------------------------------------------
+
+//  The base type (one "limb" of the number)
+//  Requirements:
+//  1)  Must be unsigned
+//  2)  64 bits.  Limb products are formed with BBI_UMUL (see 
+//      BigBigIntMpn.cpp), which uses the compiler's 128-bit support.
+//  
+#define BBI_BASE_TYPE uint64_t
+#define BBI_BASE_BITS 64
+#define BBI_BASE_MAX  0xFFFFFFFFFFFFFFFFULL
+
+//  Byte order of the machine.  Define MEM_ARCH_USES_BIG_ENDIAN for a 
+//  big endian one; compilers that say what they're building for 
+//  (__BYTE_ORDER__) get it set automatically.  BBI_HOST_ENDIAN is the
+//  same thing as an endian argument for bbi_import / bbi_export.
+#if !defined(MEM_ARCH_USES_BIG_ENDIAN) && defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+    #if (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        #define MEM_ARCH_USES_BIG_ENDIAN
+    #endif
+#endif
+#if defined(MEM_ARCH_USES_BIG_ENDIAN)
+    #define BBI_HOST_ENDIAN     1
+#else
+    #define BBI_HOST_ENDIAN     (-1)
+#endif
+
+//  Where the algorithms change over, in limbs.  The right values 
+//  depend on the processor:  BigBigIntTune.cpp measures them and 
+//  writes bbi_tune.h, which is picked up here when it's next to the 
+//  sources.  Anything it (or the command line) doesn't define gets 
+//  the default below.
+//
+//  BBI_MUL_KARATSUBA_THRESHOLD:  below this many limbs (in the shorter
+//      operand) bbi_mul uses schoolbook multiplication, at or above 
+//      it Karatsuba
+//  BBI_SQR_KARATSUBA_THRESHOLD:  below this bbi_sqr uses its own 
+//      schoolbook squaring, at or above it bbi_mul
+//  BBI_MUL_FFT_THRESHOLD:  from this many limbs (in the shorter 
+//      operand) bbi_mul and bbi_sqr use FFT multiplication
+//  BBI_MUL_PARALLEL_THRESHOLD:  the default for the size (of the 
+//      shorter operand) from which bbi_mul splits a product across
+//      threads, when there's more than one (see bbi_set_mul_threads)
+#if defined(__has_include)
+    #if __has_include("bbi_tune.h")
+        #include "bbi_tune.h"
+    #endif
+#endif
+#ifndef BBI_MUL_KARATSUBA_THRESHOLD
+    #define BBI_MUL_KARATSUBA_THRESHOLD   32
+#endif
+#ifndef BBI_SQR_KARATSUBA_THRESHOLD
+    #define BBI_SQR_KARATSUBA_THRESHOLD   BBI_MUL_KARATSUBA_THRESHOLD
+#endif
+#ifndef BBI_MUL_FFT_THRESHOLD
+    #define BBI_MUL_FFT_THRESHOLD         4096
+#endif
+#ifndef BBI_MUL_PARALLEL_THRESHOLD
+    #define BBI_MUL_PARALLEL_THRESHOLD    2048
+#endif
+#if BBI_MUL_KARATSUBA_THRESHOLD < 2 || BBI_SQR_KARATSUBA_THRESHOLD < 2
+    #error The Karatsuba thresholds must be at least 2
+#endif
+
+//  The tuner builds the library with BBI_TUNE_PROGRAM defined, which
+//  turns the thresholds into variables it can move between timings
+//  (GMP's tuneup does the same).  String conversions below 
+//  BBI_TUNE_GET_STR_LIMIT limbs use a stack buffer, so that's as high
+//  as the tuner takes BBI_GET_STR_DC_THRESHOLD.
+#if defined(BBI_TUNE_PROGRAM)
+    struct bbi_tune_params
+    {
+        unsigned long mul_karatsuba;
+        unsigned long sqr_karatsuba;
+        unsigned long mul_fft;
+        unsigned long get_str_dc;
+        unsigned long set_str_dc;
+    };
+    extern bbi_tune_params bbi_tune;
+
+    #undef BBI_MUL_KARATSUBA_THRESHOLD
+    #undef BBI_SQR_KARATSUBA_THRESHOLD
+    #undef BBI_MUL_FFT_THRESHOLD
+    #define BBI_MUL_KARATSUBA_THRESHOLD   bbi_tune.mul_karatsuba
+    #define BBI_SQR_KARATSUBA_THRESHOLD   bbi_tune.sqr_karatsuba
+    #define BBI_MUL_FFT_THRESHOLD         bbi_tune.mul_fft
+    #define BBI_TUNE_GET_STR_LIMIT        256
+#endif
+
+//-----------------------------------------------------------------------------
+//                          Notes
+//-----------------------------------------------------------------------------
+//
+//  These are the functions the bigbigint class does all of its 
+//  arithmetic with, for code that wants to manage its own buffers 
+//  (no copies, no signs, no per-call malloc).  The naming and the rules
+//  follow GMP's mpn layer:
+//
+//  - A number is an array of BBI_BASE_TYPE limbs, least significant
+//    limb first, plus a limb count.  Leading zero limbs are allowed
+//    unless a function says otherwise.
+//  - The caller supplies every output buffer, big enough for the 
+//    size given with the function.  The only memory used behind 
+//    your back is the per-thread scratch stack (see the end of this
+//    file), and that stops growing once it's big enough.
+//  - An output may be the same array as an input (r == a) unless 
+//    the function says otherwise, but must not partially overlap it.
+//  - Carries, borrows and the bits shifted out come back as the 
+//    return value.
+//
+//  The add/subtract/multiply-accumulate kernels pick an ADX/BMI2 
+//  version at run time when the processor has one.
+//
+//  A bigbigint's limbs are laid out the same way, so the class is 
+//  nothing more than these plus an allocation and a sign.
+//
+//      BBI_BASE_TYPE a[2] = { 5, 1 }, b[2] = { 7, 0 }, r[4];
+//      bbi_mul(r, a, 2, b, 2);         // r = (2^64 + 5) * 7
+//
+
+//-----------------------------------------------------------------------------
+//                          Limb Helpers
+//-----------------------------------------------------------------------------
+//
+//  BBI_CLZ / BBI_CTZ:  leading / trailing zero bits of a (non-zero) limb
+//  BBI_POPCOUNT:  number of 1 bits in a limb
+//  BBI_BSWAP:  a limb with its bytes in the opposite order
+//
+//  The builtins turn into single lzcnt/tzcnt/popcnt instructions when
+//  the target has them (-mlzcnt -mbmi -mpopcnt, or -march=native).
+#if defined(__GNUC__) || defined(__clang__)
+    #define BBI_CLZ(__a)        ((unsigned int)__builtin_clzll(__a))
+    #define BBI_CTZ(__a)        ((unsigned int)__builtin_ctzll(__a))
+    #define BBI_POPCOUNT(__a)   ((unsigned int)__builtin_popcountll(__a))
+    #define BBI_BSWAP(__a)      ((BBI_BASE_TYPE)__builtin_bswap64(__a))
+#elif defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+    static inline unsigned int bbi_clz_msvc(BBI_BASE_TYPE a)
+    {
+        unsigned long index;
+        _BitScanReverse64(&index, a);
+        return (unsigned int)(BBI_BASE_BITS - 1 - index);
+    }
+    static inline unsigned int bbi_ctz_msvc(BBI_BASE_TYPE a)
+    {
+        unsigned long index;
+        _BitScanForward64(&index, a);
+        return (unsigned int)index;
+    }
+    #define BBI_CLZ(__a)        bbi_clz_msvc(__a)
+    #define BBI_CTZ(__a)        bbi_ctz_msvc(__a)
+    #define BBI_POPCOUNT(__a)   ((unsigned int)__popcnt64(__a))
+    #define BBI_BSWAP(__a)      ((BBI_BASE_TYPE)_byteswap_uint64(__a))
+#else
+    static inline unsigned int bbi_clz_portable(BBI_BASE_TYPE a)
+    {
+        unsigned int count;
+
+        count = 0;
+        while ((a >> (BBI_BASE_BITS - 1)) == 0) {
+            a <<= 1;
+            count++;
+        }
+        return count;
+    }
+    static inline unsigned int bbi_ctz_portable(BBI_BASE_TYPE a)
+    {
+        unsigned int count;
+
+        count = 0;
+        while ((a & 1) == 0) {
+            a >>= 1;
+            count++;
+        }
+        return count;
+    }
+    static inline unsigned int bbi_popcount_portable(BBI_BASE_TYPE a)
+    {
+        a = a - ((a >> 1) & 0x5555555555555555ULL);
+        a = (a & 0x3333333333333333ULL) + ((a >> 2) & 0x3333333333333333ULL);
+        a = (a + (a >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return (unsigned int)((a * 0x0101010101010101ULL) >> 56);
+    }
+    #define BBI_CLZ(__a)        bbi_clz_portable(__a)
+    #define BBI_CTZ(__a)        bbi_ctz_portable(__a)
+    static inline BBI_BASE_TYPE bbi_bswap_portable(BBI_BASE_TYPE a)
+    {
+        a = ((a & 0x00FF00FF00FF00FFULL) << 8) | ((a >> 8) & 0x00FF00FF00FF00FFULL);
+        a = ((a & 0x0000FFFF0000FFFFULL) << 16) | ((a >> 16) & 0x0000FFFF0000FFFFULL);
+        return (a << 32) | (a >> 32);
+    }
+    #define BBI_POPCOUNT(__a)   bbi_popcount_portable(__a)
+    #define BBI_BSWAP(__a)      bbi_bswap_portable(__a)
+#endif
+
+
+//-----------------------------------------------------------------------------
+//                          Limb Array Functions
+//-----------------------------------------------------------------------------
+
+//  Size and comparison
+unsigned long bbi_normalize(const BBI_BASE_TYPE *a, unsigned long n);   // n without the leading zero limbs
+int bbi_cmp(const BBI_BASE_TYPE *a, unsigned long an,                   // -1, 0 or 1
+            const BBI_BASE_TYPE *b, unsigned long bn);
+int bbi_cmp_1(const BBI_BASE_TYPE *a, unsigned long n, BBI_BASE_TYPE b);
+
+//  Addition.  r = a + b, returns the carry (0 or 1).
+//  bbi_add needs an >= bn and writes an limbs.
+BBI_BASE_TYPE bbi_add_n(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                        const BBI_BASE_TYPE *b, unsigned long n);
+BBI_BASE_TYPE bbi_add_1(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                        unsigned long n, BBI_BASE_TYPE b);
+BBI_BASE_TYPE bbi_add(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long an, 
+                      const BBI_BASE_TYPE *b, unsigned long bn);
+
+//  Subtraction.  r = a - b, returns the borrow (0 or 1).
+//  bbi_sub needs an >= bn and writes an limbs.
+BBI_BASE_TYPE bbi_sub_n(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                        const BBI_BASE_TYPE *b, unsigned long n);
+BBI_BASE_TYPE bbi_sub_1(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                        unsigned long n, BBI_BASE_TYPE b);
+BBI_BASE_TYPE bbi_sub(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long an, 
+                      const BBI_BASE_TYPE *b, unsigned long bn);
+
+//  r = -a mod B^n  (two's complement)
+void bbi_neg(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long n);
+
+//  Multiplication by a single limb.  bbi_mul_1 sets r = a * b, 
+//  bbi_addmul_1 does r += a * b and bbi_submul_1 does r -= a * b.  
+//  All three return the limb that would go at r[n] (the carry, or 
+//  for submul_1 the borrow).
+BBI_BASE_TYPE bbi_mul_1(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                        unsigned long n, BBI_BASE_TYPE b);
+BBI_BASE_TYPE bbi_addmul_1(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                           unsigned long n, BBI_BASE_TYPE b);
+BBI_BASE_TYPE bbi_submul_1(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                           unsigned long n, BBI_BASE_TYPE b);
+
+//  Full products.  bbi_mul needs an >= bn >= 1 and writes an + bn 
+//  limbs; bbi_sqr writes 2n limbs.  Here r must NOT overlap the inputs.
+//  Large products take their temporaries from the scratch stack, and
+//  very large ones can be spread over several threads (see Threads 
+//  below).
+void bbi_mul(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long an, 
+             const BBI_BASE_TYPE *b, unsigned long bn);
+void bbi_sqr(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, unsigned long n);
+
+//  Division by a single non-zero limb.  bbi_divrem_1 writes the n 
+//  limb quotient to q and returns the remainder; bbi_mod_1 only 
+//  returns the remainder.
+BBI_BASE_TYPE bbi_divrem_1(BBI_BASE_TYPE *q, const BBI_BASE_TYPE *a, 
+                           unsigned long n, BBI_BASE_TYPE b);
+BBI_BASE_TYPE bbi_mod_1(const BBI_BASE_TYPE *a, unsigned long n, BBI_BASE_TYPE b);
+
+//  Division.  q = a / d (an - dn + 1 limbs), r = a % d (dn limbs).
+//  Needs an >= dn >= 1 and d[dn - 1] != 0.  scratch must hold 
+//  BBI_DIVREM_SCRATCH(an, dn) limbs.  q and r may be a or d, but 
+//  not each other.
+#define BBI_DIVREM_SCRATCH(__an, __dn)  ((__an) + (__dn) + 1)
+void bbi_divrem(BBI_BASE_TYPE *q, BBI_BASE_TYPE *r, 
+                const BBI_BASE_TYPE *a, unsigned long an, 
+                const BBI_BASE_TYPE *d, unsigned long dn, 
+                BBI_BASE_TYPE *scratch);
+
+//  Shifts by 0 < cnt < BBI_BASE_BITS over n limbs.  They return the
+//  bits shifted out (in the bottom of the limb for bbi_lshift, the
+//  top for bbi_rshift).  bbi_lshift may write to a higher address 
+//  than a and bbi_rshift to a lower one, as with memmove; shift by
+//  whole limbs by offsetting r.
+BBI_BASE_TYPE bbi_lshift(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                         unsigned long n, unsigned int cnt);
+BBI_BASE_TYPE bbi_rshift(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+                         unsigned long n, unsigned int cnt);
+
+//  Word-wise logic, r = a & b, a | b, a ^ b over n limbs
+void bbi_and_n(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+               const BBI_BASE_TYPE *b, unsigned long n);
+void bbi_ior_n(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+               const BBI_BASE_TYPE *b, unsigned long n);
+void bbi_xor_n(BBI_BASE_TYPE *r, const BBI_BASE_TYPE *a, 
+               const BBI_BASE_TYPE *b, unsigned long n);
+
+//  Radix conversion, bases 2 - 36.  bbi_get_str writes a as ASCII 
+//  digits (lower case letters above 9), most significant first, with
+//  no leading zeros and no terminator, and returns the digit count.
+//  str must hold bbi_sizeinbase(a, n, base) characters, which is 
+//  exact for powers of two and otherwise may be one too big.  
+//  bbi_get_str is quadratic for bases that aren't a power of two.
+unsigned long bbi_sizeinbase(const BBI_BASE_TYPE *a, unsigned long n, int base);
+unsigned long bbi_get_str(char *str, int base, const BBI_BASE_TYPE *a, unsigned long n);
+
+//  bbi_set_str goes the other way:  r = the len digits in str, which 
+//  must all be valid for the base (no sign, either case), and returns
+//  the limb count without leading zeros.  r must hold 
+//  bbi_set_str_size(len, base) limbs.  bbi_digit_value gives a 
+//  digit's value, or 99 if c isn't a digit.
+unsigned long bbi_set_str_size(unsigned long len, int base);
+unsigned long bbi_set_str(BBI_BASE_TYPE *r, const char *str, unsigned long len, int base);
+int bbi_digit_value(char c);
+
+//  Raw words, as GMP's mpz_import / mpz_export (without nails).  The
+//  buffer is count words of size bytes each.  order is 1 for the most
+//  significant word first or -1 for the least;  endian is 1 for big 
+//  endian bytes in a word, -1 for little endian or 0 for the host's.
+//  (Network order is order 1, endian 1, any size.)
+//
+//  bbi_import sets r from the buffer and returns the limb count 
+//  without leading zeros.  r must hold bbi_import_size(count, size) 
+//  limbs.  bbi_export writes the low count * size bytes of a to the
+//  buffer, zero filled above a;  bbi_export_count is the smallest 
+//  count that holds all of a (0 for zero).  Neither buffer may 
+//  overlap the limbs.
+unsigned long bbi_import_size(unsigned long count, unsigned long size);
+unsigned long bbi_import(BBI_BASE_TYPE *r, unsigned long count, int order, 
+                         unsigned long size, int endian, const void *data);
+unsigned long bbi_export_count(const BBI_BASE_TYPE *a, unsigned long n, unsigned long size);
+void bbi_export(void *data, unsigned long count, int order, unsigned long size, 
+                int endian, const BBI_BASE_TYPE *a, unsigned long n);
+
+//-----------------------------------------------------------------------------
+//                              Threads
+//-----------------------------------------------------------------------------
+//
+//  bbi_mul (and bbi_sqr, which hands it the big squares) can spread 
+//  a product whose shorter operand has min_limbs limbs or more over 
+//  num_threads threads:  the one asking for it and num_threads - 1 
+//  workers kept waiting in a pool.  The pieces are the Karatsuba 
+//  subproducts of the top few levels, or for an FFT product, pieces
+//  of each transform and each step between them (which takes 9 
+//  limbs of scratch per transform point rather than 5).  0 threads 
+//  means one per core.
+//  The default, 1, keeps everything on the calling thread and starts
+//  no others.  Set it while no multiplication is running.  (Some 
+//  systems need -pthread to link.)
+//
+//  bbi_mul_threads() is the number in use, which is less than asked
+//  for if the system wouldn't start them all.
+void bbi_set_mul_threads(unsigned int num_threads, unsigned long min_limbs);
+unsigned int bbi_mul_threads();
+
+//-----------------------------------------------------------------------------
+//                          Scratch Space
+//-----------------------------------------------------------------------------
+//
+//  A per-thread stack for kernel temporaries (GMP's TMP_ALLOC).  Take
+//  a mark, allocate what you need, and restore the mark when you're 
+//  done; everything allocated since the mark is released at once, 
+//  in LIFO order.  Once the stack has grown to the size a job needs,
+//  doing it again doesn't allocate.  Memory from here is not zeroed.
+//
+//      bbi_tmp_scope tmp;                          // takes the mark
+//      BBI_BASE_TYPE *t = tmp.alloc(2 * n);        // ...released when
+//                                                  // tmp goes away
+//
+struct bbi_tmp_mark
+{
+    void *block;
+    unsigned long used;
+};
+
+bbi_tmp_mark bbi_tmp_save();
+BBI_BASE_TYPE *bbi_tmp_alloc(unsigned long n);
+void bbi_tmp_restore(bbi_tmp_mark mark);
+
+class bbi_tmp_scope
+{
+public:
+    bbi_tmp_scope() : _mark(bbi_tmp_save()) {}
+    ~bbi_tmp_scope() { bbi_tmp_restore(_mark); }
+
+    BBI_BASE_TYPE *alloc(unsigned long n) { return bbi_tmp_alloc(n); }
+
+private:
+    bbi_tmp_mark _mark;
+
+    bbi_tmp_scope(const bbi_tmp_scope &);
+    bbi_tmp_scope &operator =(const bbi_tmp_scope &);
+};
+
+#endif
@@ -0,0 +1,2023 @@
+// ------------------------------------------------------------
+//  BigBigIntTest.cpp
+//
+//  Created by Richard Andrasek
+//
+//  Purpose:
+//      Regression tests for the bigbigint class.  Each test_ function
+//  checks one behaviour; every failed CHECK is printed, and the 
+//  program exits with 1 if there were any.
+//
+//  Build it with the library and run it, e.g.
+//
+//      g++ -std=c++14 -Wall -Werror BigBigIntTest.cpp BigBigInt.cpp
+//          BigBigIntMpn.cpp -pthread -o bbi_test
+//      bbi_test
+//
+// ------------------------------------------------------------
+#include "BigBigInt.h"
+#include "FixedBigBigInt.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#if !defined(WIN32)
+    #include <stdlib.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+#endif
+
+static int failures = 0;
+
+#define CHECK(__cond)                                                   \
+    do {                                                                \
+        if (!(__cond)) {                                                \
+            printf("%s:%d:  CHECK(%s) failed\n", __FILE__, __LINE__, #__cond); \
+            failures++;                                                 \
+        }                                                               \
+    } while (0)
+
+
+/*******************************************
+ *                HELPERS                  *
+ *******************************************/
+
+//
+//  Test values come from a fixed xorshift sequence, so a failure 
+//  shows up the same way on every run.  A quarter of the limbs are 
+//  all zeros or all ones, which is where carries and borrows go wrong.
+static uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t random_limb()
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    switch (random_state % 8) {
+        case 0:  return 0;
+        case 1:  return ~(uint64_t)0;
+        default: return random_state;
+    }
+}
+
+//  A value of exactly num_limbs limbs (the top one isn't zero)
+static bigbigint random_value(unsigned long num_limbs, bool negative)
+{
+    std::vector<uint64_t> limbs(num_limbs);
+    bigbigint value;
+    unsigned long i;
+
+    for (i = 0; i < num_limbs; i++) {
+        limbs[i] = random_limb();
+    }
+    limbs[num_limbs - 1] |= 1;
+    value.import_words(num_limbs, -1, sizeof(uint64_t), 0, &limbs[0]);
+    if (negative) {
+        value = -value;
+    }
+    return value;
+}
+
+static const char digit_chars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+//
+//  The digits of |value| the slow way, a division by the base per 
+//  digit, which has nothing in common with to_string's split
+static std::string reference_digits(bigbigint value, int base)
+{
+    std::string digits;
+    long digit;
+
+    if (value < 0L) {
+        value = -value;
+    }
+    do {
+        digit = (long)(value % (long)base);
+        value /= (long)base;
+        digits += digit_chars[digit];
+    } while (value != 0L);
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+//
+//  The value of a string of digits the slow way, a multiply and add 
+//  per digit
+static bigbigint reference_value(const std::string &digits, int base)
+{
+    bigbigint value;
+    unsigned long i;
+
+    value = 0L;
+    for (i = 0; i < digits.size(); i++) {
+        value *= (long)base;
+        value += (long)(strchr(digit_chars, digits[i]) - digit_chars);
+    }
+    return value;
+}
+
+//  length random digits in the given base (the first one not 0)
+static std::string random_digits(unsigned long length, int base)
+{
+    std::string digits;
+    unsigned long i;
+
+    for (i = 0; i < length; i++) {
+        digits += digit_chars[random_limb() % (uint64_t)base];
+    }
+    if (digits[0] == '0') {
+        digits[0] = '1';
+    }
+    return digits;
+}
+
+//
+//  hi:lo = a * b from 32-bit halves, which has nothing in common with
+//  the library's kernels (mulx, or a 128-bit type)
+static uint64_t reference_mul(uint64_t a, uint64_t b, uint64_t &hi)
+{
+    uint64_t p0, p1, p2, mid;
+
+    p0 = (a & 0xFFFFFFFFULL) * (b & 0xFFFFFFFFULL);
+    p1 = (a & 0xFFFFFFFFULL) * (b >> 32);
+    p2 = (a >> 32) * (b & 0xFFFFFFFFULL);
+    mid = (p0 >> 32) + (p1 & 0xFFFFFFFFULL) + (p2 & 0xFFFFFFFFULL);
+    hi = ((a >> 32) * (b >> 32)) + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+    return (mid << 32) | (p0 & 0xFFFFFFFFULL);
+}
+
+//
+//  r +/-= a * b (n limbs), returning the carry or borrow out, one 
+//  limb product at a time
+static uint64_t reference_addmul_1(uint64_t *r, const uint64_t *a, unsigned long n, 
+                                   uint64_t b, bool subtract)
+{
+    uint64_t carry, lo, hi, sum;
+    unsigned long i;
+
+    carry = 0;
+    for (i = 0; i < n; i++) {
+        lo = reference_mul(a[i], b, hi);
+        lo += carry;
+        hi += (lo < carry);
+        if (subtract) {
+            sum = r[i] - lo;
+            hi += (sum > r[i]);
+        }
+        else {
+            sum = r[i] + lo;
+            hi += (sum < lo);
+        }
+        r[i] = sum;
+        carry = hi;
+    }
+    return carry;
+}
+
+//  r = a * b (an + bn limbs), schoolbook
+static void reference_product(uint64_t *r, const uint64_t *a, unsigned long an, 
+                              const uint64_t *b, unsigned long bn)
+{
+    unsigned long j;
+
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+    for (j = 0; j < bn; j++) {
+        r[an + j] = reference_addmul_1(r + j, a, an, b[j], false);
+    }
+}
+
+//  n random limbs, with room for one more so that n can be 0
+static std::vector<uint64_t> random_limbs(unsigned long n)
+{
+    std::vector<uint64_t> limbs(n + 1);
+    unsigned long i;
+
+    for (i = 0; i < n; i++) {
+        limbs[i] = random_limb();
+    }
+    return limbs;
+}
+
+
+/*******************************************
+ *                 TESTS                   *
+ *******************************************/
+
+//
+//  Limbs are 64 bits with the sign kept apart from the magnitude:  
+//  carries and borrows cross limb boundaries, and zero never comes 
+//  out negative.
+static void test_limb_storage()
+{
+    bigbigint x, y, z;
+
+    x.from_string("18446744073709551615");
+    x += 1L;
+    CHECK(x.to_string() == "18446744073709551616");
+    x -= 1L;
+    CHECK(x.to_string() == "18446744073709551615");
+
+    x.from_string("-18446744073709551616");
+    x += 1L;
+    CHECK(x.to_string() == "-18446744073709551615");
+
+    x.from_string("115792089237316195423570985008687907853269984665640564039457584007913129639935");
+    x += 1L;
+    CHECK(x.to_string() == "115792089237316195423570985008687907853269984665640564039457584007913129639936");
+
+    x.from_string("18446744073709551616");
+    y = x * x;
+    CHECK(y.to_string() == "340282366920938463463374607431768211456");
+
+    // The sign is a flag, not part of the limbs
+    x = (long)(-9223372036854775807L - 1);
+    CHECK(x.to_string() == "-9223372036854775808");
+    CHECK((long)x == (-9223372036854775807L - 1));
+    x = 18446744073709551615UL;
+    CHECK(x.to_string() == "18446744073709551615");
+    CHECK((unsigned long)x == 18446744073709551615UL);
+
+    // Zero is never negative, however it's reached
+    x = 5L;
+    y = -5L;
+    z = x + y;
+    CHECK(z.to_string() == "0");
+    z = y - y;
+    CHECK(z.to_string() == "0");
+    x = 0L;
+    z = y * x;
+    CHECK(z.to_string() == "0");
+    z = x * y;
+    CHECK(z.to_string() == "0");
+    z = y * y;
+    CHECK(z.to_string() == "25");
+    z = x - y;
+    CHECK(z.to_string() == "5");
+}
+
+//
+//  An expression is evaluated straight into its destination.  It has
+//  to give what the same steps one at a time give, including when the
+//  destination is also one of the operands.
+static void test_expression_templates()
+{
+    bigbigint a, b, c, d, e, x, step;
+
+    a.from_string("123456789012345678901234567890123");
+    b.from_string("-98765432109876543210987");
+    c.from_string("340282366920938463463374607431768211457");
+    d.from_string("-18446744073709551615");
+    e = -5L;
+
+    x = a*b + c*d - e;
+    step = a*b;
+    step += c*d;
+    step -= e;
+    CHECK(x == step);
+    CHECK(x.to_string() == "-6289294998500382943018125478779732749791763877966198234451");
+
+    bigbigint y(c*d - a*b);
+    CHECK(y.to_string() == "-6264908472272978583972888633793723155523091284245753471654");
+    x = a*b - c;
+    CHECK(x.to_string() == "-12193263113702179862900789413943260597710904291990592858");
+
+    // The destination on the right hand side too
+    x = a;
+    x = x*b + x;
+    CHECK(x.to_string() == "-12193263113702179522618299036215784788657395625654491278");
+    x = a;
+    x = b*c - x;
+    CHECK(x.to_string() == "-33608135008318047382301837711587907286762117853295867349568182");
+    x = a;
+    x = x*x;
+    CHECK(x.to_string() == "15241578753238836750495351562566569157598942236884722755800955129");
+    x = a;
+    x += x*x;
+    CHECK(x.to_string() == "15241578753238836750495351562566692614387954582563623990368845252");
+    x = a;
+    x -= b*x;
+    CHECK(x.to_string() == "12193263113702179522618545949793809480015198094790271524");
+    x = a;
+    x = (x + b)*x;
+    CHECK(x.to_string() == "15241578741045573636793172039948146664594145102548425895578573728");
+    x = a;
+    x = x - x;
+    CHECK(x.to_string() == "0");
+}
+
+//
+//  <native> *= bigbigint and /= bigbigint store the result back in 
+//  the native variable.  The unsigned short pair used to be declared
+//  taking the unsigned short by value, which matched no definition, 
+//  so r *= b did not link.
+static void test_compound_assign()
+{
+    unsigned short r;
+    short s;
+    bigbigint b;
+
+    r = 6;
+    b = 3L;
+    r *= b;
+    CHECK(r == 18);
+    r /= b;
+    CHECK(r == 6);
+
+    s = -6;
+    s *= b;
+    CHECK(s == -18);
+    s /= b;
+    CHECK(s == -6);
+}
+
+//
+//  compare() and the comparison operators go by sign first, then 
+//  magnitude, so a longer negative is the smaller one.  Every way of 
+//  reaching zero from a negative value compares equal to plain 0.
+static void test_compare()
+{
+    static const char *const ordered[] = {
+        "-340282366920938463463374607431768211456",
+        "-18446744073709551617",
+        "-18446744073709551616",
+        "-9223372036854775808",
+        "-5",
+        "0",
+        "3",
+        "18446744073709551615",
+        "18446744073709551616",
+        "340282366920938463463374607431768211456",
+    };
+    const int count = (int)(sizeof(ordered) / sizeof(ordered[0]));
+    bigbigint x, y, zero;
+    int i, j, expect;
+
+    for (i = 0; i < count; i++) {
+        x.from_string(ordered[i]);
+        for (j = 0; j < count; j++) {
+            y.from_string(ordered[j]);
+            expect = (i < j ? -1 : (i > j ? 1 : 0));
+            CHECK(x.compare(y) == expect);
+            CHECK((x < y) == (expect < 0));
+            CHECK((x <= y) == (expect <= 0));
+            CHECK((x > y) == (expect > 0));
+            CHECK((x >= y) == (expect >= 0));
+            CHECK((x == y) == (expect == 0));
+            CHECK((x != y) == (expect != 0));
+        }
+    }
+
+    // Against native integers
+    x = -5L;
+    CHECK(x < 0L && x < -4L && x == -5L && x > -6L && x > (-9223372036854775807L - 1));
+    x.from_string("-18446744073709551616");
+    CHECK(x < (-9223372036854775807L - 1) && x < -1L);
+    x.from_string("18446744073709551616");
+    CHECK(x > 18446744073709551615UL && x > -1L);
+
+    // Limbs left over from a bigger value don't count
+    x.from_string("340282366920938463463374607431768211459");
+    y.from_string("340282366920938463463374607431768211456");
+    x -= y;
+    y = 3L;
+    CHECK(x == 3L && x < 4L && x.compare(y) == 0);
+    x -= 3L;
+    CHECK(x == 0L && x.compare(zero) == 0);
+
+    // -0 is 0
+    x.from_string("-0");
+    CHECK(x.compare(zero) == 0 && x == 0L && !(x < 0L) && x.to_string() == "0");
+    x = 0L;
+    x = -x;
+    CHECK(x.compare(zero) == 0 && x == 0L && !(x < 0L) && x.to_string() == "0");
+    x = -3L;
+    x += 3L;
+    CHECK(x.compare(zero) == 0 && x == 0L && !(x < 0L) && x.to_string() == "0");
+    x = -7L;
+    x /= 100L;
+    CHECK(x.compare(zero) == 0 && x == 0L && !(x < 0L) && x.to_string() == "0");
+    x = -7L;
+    x %= 7L;
+    CHECK(x.compare(zero) == 0 && x == 0L && !(x < 0L) && x.to_string() == "0");
+    x = -5L;
+    x *= 0L;
+    CHECK(x.compare(zero) == 0 && x == 0L && !(x < 0L) && x.to_string() == "0");
+    x = -0.5;
+    CHECK(x.compare(zero) == 0 && x == 0L && !(x < 0L) && x.to_string() == "0");
+    x.from_string("-18446744073709551616");
+    y = x;
+    x -= y;
+    CHECK(x.compare(zero) == 0 && x == 0L && !(x < 0L) && x.to_string() == "0");
+}
+
+//
+//  &, |, ^ and ~ act on negative values as if they were two's 
+//  complement with the sign bit repeated forever (as Python's ints 
+//  do, which is where these values come from)
+static void test_bitwise()
+{
+    static const char *const table[][5] = {
+        // x, y, x & y, x | y, x ^ y
+        { "-6", "5", "0", "-1", "-1" },
+        { "6", "-5", "2", "-1", "-3" },
+        { "-6", "-5", "-6", "-5", "1" },
+        { "-1", "12345", "12345", "-1", "-12346" },
+        { "-18446744073709551616", "18446744073709551615", "0", "-1", "-1" },
+        { "-18446744073709551617", "1180591620717411303427", "1180591620717411303427", "-18446744073709551617", "-1199038364791120855044" },
+        { "-340282366920938463463374607431768211449", "-36893488147419103241", "-340282366920938463463374607431768211449", "-36893488147419103241", "340282366920938463426481119284349108208" },
+        { "-3", "1361129467683753853853498429727072845829", "1361129467683753853853498429727072845829", "-3", "-1361129467683753853853498429727072845832" },
+        { "170141183460469231731687303715884105729", "-18446744073709551616", "170141183460469231731687303715884105728", "-18446744073709551615", "-170141183460469231750134047789593657343" },
+        { "-123456789012345678901234567890", "98765432109876543210", "20213295392617428010", "-123456788933793542183975452690", "-123456788954006837576592880700" },
+        { "-74567682366366435382159012080", "90144042682896311822508713865", "80162695396208831902628775680", "-64586335079678955462279073895", "-144749030475887787364907849575" },
+        { "-1606938044258990275541962092339894951921974764381296132095999", "-1427247692705959881058287150041115853794050048", "-1606938044258990275541962092339894951921974764381296132096000", "-1427247692705959881058287150041115853794050047", "1606938044258988848294269386380013893634824723265442338045953" },
+    };
+    const int count = (int)(sizeof(table) / sizeof(table[0]));
+    bigbigint x, y, z, minus_one;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        x.from_string(table[i][0]);
+        y.from_string(table[i][1]);
+        CHECK((x & y).to_string() == table[i][2]);
+        CHECK((x | y).to_string() == table[i][3]);
+        CHECK((x ^ y).to_string() == table[i][4]);
+        CHECK((y & x).to_string() == table[i][2]);
+        CHECK((y | x).to_string() == table[i][3]);
+        CHECK((y ^ x).to_string() == table[i][4]);
+
+        z = x;
+        z &= y;
+        CHECK(z.to_string() == table[i][2]);
+        z = x;
+        z |= y;
+        CHECK(z.to_string() == table[i][3]);
+        z = x;
+        z ^= y;
+        CHECK(z.to_string() == table[i][4]);
+    }
+
+    // ~x == -x - 1, and -1 ^ x == ~x
+    minus_one = -1L;
+    for (i = 0; i < count; i++) {
+        x.from_string(table[i][0]);
+        z = -x;
+        z -= 1L;
+        CHECK(~x == z);
+        CHECK((minus_one ^ x) == z);
+        CHECK((x & minus_one) == x);
+        CHECK((x | minus_one) == minus_one);
+        CHECK(~~x == x);
+    }
+    x = 0L;
+    CHECK(~x == minus_one);
+    x.from_string("-340282366920938463463374607431768211449");
+    CHECK((~x).to_string() == "340282366920938463463374607431768211448");
+
+    // Native operands are sign extended the same way
+    x = -6L;
+    CHECK((x & 5L) == 0L);
+    CHECK((x | 5L) == -1L);
+    CHECK((x ^ -1L) == 5L);
+    x.from_string("-18446744073709551617");
+    CHECK((x & -1L) == x);
+    CHECK((x & 255L) == 255L);
+    CHECK((x | -256L) == -1L);
+    z = x;
+    z &= -65536L;
+    CHECK(z.to_string() == "-18446744073709617152");
+    z = x;
+    z ^= 7L;
+    CHECK(z.to_string() == "-18446744073709551624");
+}
+
+//
+//  bit_length, popcount and count_trailing_zeros describe the 
+//  magnitude; test_bit and the bit setters see a negative value as 
+//  two's complement, the same as & | ^ (values from Python)
+static void test_bit_queries()
+{
+    static const unsigned long bits[] = { 0, 1, 2, 3, 63, 64, 65, 127, 128, 129, 200 };
+    static const struct {
+        const char *value;
+        unsigned long bit_length, popcount, trailing_zeros;
+        const char *test_bits;      // test_bit() of each of bits[]
+    } table[] = {
+        { "0", 0, 0, 0, "00000000000" },
+        { "1", 1, 1, 0, "10000000000" },
+        { "-1", 1, 1, 0, "11111111111" },
+        { "-6", 3, 2, 1, "01011111111" },
+        { "12", 4, 2, 2, "00110000000" },
+        { "-12", 4, 2, 2, "00101111111" },
+        { "18446744073709551616", 65, 1, 64, "00000100000" },
+        { "-18446744073709551616", 65, 1, 64, "00000111111" },
+        { "-340282366920938463463374607431768211455", 128, 128, 0, "10000000111" },
+        { "1361129467683753853853498429727072845829", 131, 3, 0, "10100000000" },
+        { "-170141183460469231750134047789593657344", 128, 2, 64, "00000110111" },
+    };
+    const int num_bits = (int)(sizeof(bits) / sizeof(bits[0]));
+    const int count = (int)(sizeof(table) / sizeof(table[0]));
+    bigbigint x, z, power;
+    int i, j;
+
+    for (i = 0; i < count; i++) {
+        x.from_string(table[i].value);
+        CHECK(x.bit_length() == table[i].bit_length);
+        CHECK(x.popcount() == table[i].popcount);
+        CHECK(x.count_trailing_zeros() == table[i].trailing_zeros);
+
+        for (j = 0; j < num_bits; j++) {
+            CHECK(x.test_bit(bits[j]) == (table[i].test_bits[j] == '1'));
+
+            // Setting, clearing and flipping a bit are | & ^ with 2^bit
+            power = 1L;
+            power <<= bits[j];
+            z = x;
+            z.set_bit(bits[j]);
+            CHECK(z == (x | power));
+            z = x;
+            z.clear_bit(bits[j]);
+            CHECK(z == (x & ~power));
+            z = x;
+            z.flip_bit(bits[j]);
+            CHECK(z == (x ^ power));
+            CHECK(z.test_bit(bits[j]) != x.test_bit(bits[j]));
+            z.flip_bit(bits[j]);
+            CHECK(z == x);
+        }
+    }
+
+    x = -6L;
+    x.flip_bit(64);
+    CHECK(x.to_string() == "-18446744073709551622");
+    x = -6L;
+    x.clear_bit(1);
+    CHECK((long)x == -8);
+    x = -6L;
+    x.set_bit(0);
+    CHECK((long)x == -5);
+    x.from_string("-340282366920938463463374607431768211455");
+    x.clear_bit(0);
+    CHECK(x.to_string() == "-340282366920938463463374607431768211456");
+    x.from_string("-18446744073709551616");
+    x.set_bit(100);
+    CHECK(x.to_string() == "-18446744073709551616");
+    x.clear_bit(100);
+    CHECK(x.to_string() == "-1267650600246676145570412756992");
+
+    // Clearing the last bit of a positive value leaves a plain 0
+    x = 1L;
+    x.flip_bit(0);
+    CHECK(x == 0L && x.to_string() == "0");
+}
+
+//
+//  to_string in bases 2 - 36, against small known values and the slow
+//  reference conversion, from one limb up to sizes that go through 
+//  several levels of the divide-and-conquer split
+static void test_to_string()
+{
+    static const int bases[] = { 2, 8, 10, 16, 36 };
+    static const unsigned long sizes[] = { 1, 2, 23, 24, 25, 60, 300, 600 };
+    bigbigint x, y;
+    std::string text;
+    unsigned long i, j;
+    int k;
+
+    x = 0L;
+    CHECK(x.to_string() == "0" && x.to_string(2) == "0" && x.to_string(36) == "0");
+    x = 255L;
+    CHECK(x.to_string(16) == "ff" && x.to_string(2) == "11111111" && x.to_string(8) == "377");
+    x = 35L;
+    CHECK(x.to_string(36) == "z");
+    x = 36L;
+    CHECK(x.to_string(36) == "10");
+    x = (-9223372036854775807L - 1);
+    CHECK(x.to_string(16) == "-8000000000000000");
+    CHECK(x.to_string() == "-9223372036854775808");
+    x.from_string("18446744073709551616");
+    CHECK(x.to_string(36) == "3w5e11264sgsg");
+    x -= 1L;
+    CHECK(x.to_string(36) == "3w5e11264sgsf");
+    CHECK(x.to_string(16) == "ffffffffffffffff");
+    CHECK(x.to_string(1) == "" && x.to_string(37) == "");
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (j = 0; j < sizeof(bases) / sizeof(bases[0]); j++) {
+            for (k = 0; k < 2; k++) {
+                x = random_value(sizes[i], k == 1);
+                text = x.to_string(bases[j]);
+                CHECK(text == (k == 1 ? "-" : "") + reference_digits(x, bases[j]));
+                CHECK(y.from_string(text, bases[j]) && y == x);
+            }
+        }
+    }
+
+    // Remainders that come out small get padded with zeros
+    x = 1L;
+    for (k = 0; k < 2000; k++) {
+        x *= 10L;
+    }
+    text = x.to_string();
+    CHECK(text.size() == 2001 && text[0] == '1' && 
+          text.find_first_not_of('0', 1) == std::string::npos);
+    x -= 1L;
+    text = x.to_string();
+    CHECK(text.size() == 2000 && text.find_first_not_of('9') == std::string::npos);
+
+    // Bigger than the reference can do in good time:  back and forth
+    x = random_value(3000, true);
+    CHECK(y.from_string(x.to_string()) && y == x);
+    CHECK(y.from_string(x.to_string(36), 36) && y == x);
+
+    // Past the FFT threshold, where the split's products change over
+    text.assign(40 * BBI_MUL_FFT_THRESHOLD, '9');
+    CHECK(x.from_string(text) && x.to_string() == text);
+    x += 1L;
+    text = x.to_string();
+    CHECK(text.size() == (40 * BBI_MUL_FFT_THRESHOLD) + 1 && text[0] == '1' && 
+          text.find_first_not_of('0', 1) == std::string::npos);
+}
+
+//
+//  Products from BBI_MUL_FFT_THRESHOLD limbs up go through the FFT.
+//  Cutting y into pieces below the threshold gets the same product 
+//  through Karatsuba to check it against.  All ones limbs make the 
+//  biggest coefficients the transforms have to hold.
+static void test_fft_multiply()
+{
+    // Sizes of x and y, as a multiple of the threshold plus some limbs
+    static const long sizes[][4] = {
+        { 1, 0, 1, 0 }, { 1, 1, 1, 1 }, { 2, -3, 2, -3 }, { 3, 0, 1, 5 }
+    };
+    bigbigint x, y, low, high, product, expected;
+    unsigned long threshold, cut, i;
+
+    threshold = BBI_MUL_FFT_THRESHOLD;
+    cut = threshold - 1;
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        x = random_value((sizes[i][0] * threshold) + sizes[i][1], false);
+        y = random_value((sizes[i][2] * threshold) + sizes[i][3], i == 2);
+        high = y;
+        high >>= 64 * cut;
+        low = high;
+        low <<= 64 * cut;
+        low = y - low;
+
+        product = x * y;
+        expected = x * low;
+        high = x * high;
+        high <<= 64 * cut;
+        expected += high;
+        CHECK(product == expected);
+
+        // Squared, with one transform per prime
+        y = x;
+        product = x * x;
+        expected = x * y;
+        CHECK(product == expected);
+    }
+
+    // (2^64n - 1)^2 = 2^128n - 2^(64n + 1) + 1
+    x = 1L;
+    x <<= 64 * (threshold + 7);
+    x -= 1L;
+    product = x * x;
+    expected = 1L;
+    expected <<= 128 * (threshold + 7);
+    high = 1L;
+    high <<= (64 * (threshold + 7)) + 1;
+    expected -= high;
+    expected += 1L;
+    CHECK(product == expected);
+}
+
+//
+//  from_string:  signs, prefixes, either case, and strings that aren't
+//  numbers (which leave the value alone).  Then random digits of 
+//  lengths around BBI_SET_STR_DC_THRESHOLD and well past it, against 
+//  the slow reference.
+static void test_from_string()
+{
+    static const char *const bad[] = { 
+        "", "-", "+", "0x", "-0x", "+-5", "-+5", "--5", "12_", "12 ", " 12", "1.5", "0x1g"
+    };
+    static const int bases[] = { 2, 8, 10, 16, 36 };
+    static const unsigned long lengths[] = { 1, 19, 20, 455, 456, 457, 2000, 12000 };
+    bigbigint x;
+    std::string digits;
+    unsigned long i, j;
+
+    CHECK(x.from_string("12345") && x == 12345L);
+    CHECK(x.from_string("-12345") && x == -12345L);
+    CHECK(x.from_string("+12345") && x == 12345L);
+    CHECK(x.from_string("000000000000000000000000000000012") && x == 12L);
+    CHECK(x.from_string("-000") && x == 0L && x.to_string() == "0");
+    CHECK(x.from_string("ff", 16) && x == 255L);
+    CHECK(x.from_string("FF", 16) && x == 255L);
+    CHECK(x.from_string("0xFF", 16) && x == 255L);
+    CHECK(x.from_string("-0XfF", 16) && x == -255L);
+    CHECK(x.from_string("0b11", 16) && x == 0xb11L);
+    CHECK(x.from_string("Zz", 36) && x == 1295L);
+    CHECK(x.from_string("0x1F", 0) && x == 31L);
+    CHECK(x.from_string("0b101", 0) && x == 5L);
+    CHECK(x.from_string("-017", 0) && x == -15L);
+    CHECK(x.from_string("0", 0) && x == 0L);
+    CHECK(x.from_string("987", 0) && x == 987L);
+    CHECK(x.from_string(std::string("-18446744073709551616")) && 
+          x.to_string() == "-18446744073709551616");
+
+    x = 77L;
+    for (i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        CHECK(!x.from_string(bad[i]));
+        CHECK(!x.from_string(bad[i], 16));
+        CHECK(!x.from_string(bad[i], 0));
+    }
+    CHECK(!x.from_string("12a"));
+    CHECK(!x.from_string("0b2", 0));
+    CHECK(!x.from_string("09", 0));
+    CHECK(!x.from_string("2", 2));
+    CHECK(!x.from_string("z", 35));
+    CHECK(!x.from_string("1", 1));
+    CHECK(!x.from_string("1", 37));
+    CHECK(!x.from_string("1", -1));
+    CHECK(!x.from_string((const char *)NULL));
+    CHECK(x == 77L);
+
+    for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        for (j = 0; j < sizeof(bases) / sizeof(bases[0]); j++) {
+            digits = random_digits(lengths[i], bases[j]);
+            CHECK(x.from_string(digits, bases[j]) && x == reference_value(digits, bases[j]));
+            CHECK(x.to_string(bases[j]) == digits);
+            CHECK(x.from_string("-" + digits, bases[j]) && x == -reference_value(digits, bases[j]));
+        }
+    }
+}
+
+//
+//  to_chars / from_chars behave as std::to_chars / std::from_chars 
+//  do, and digits_upper_bound is never short (and at most one over)
+static void test_chars()
+{
+    char buffer[4096];
+    bbi_to_chars_result out;
+    bbi_from_chars_result in;
+    bigbigint x, y;
+    std::string text;
+    unsigned long size, i;
+    int base;
+
+    for (i = 0; i < 40; i++) {
+        x = random_value(1 + (i * 7) % 60, (i & 1) != 0);
+        for (base = 2; base <= 36; base++) {
+            text = x.to_string(base);
+            size = x.digits_upper_bound(base);
+            CHECK(size == text.size() || size == text.size() + 1);
+            if ((base & (base - 1)) == 0) {
+                CHECK(size == text.size());
+            }
+
+            // Room for exactly the text, and then one less
+            out = to_chars(buffer, buffer + text.size(), x, base);
+            CHECK(out.ec == std::errc() && out.ptr == buffer + text.size());
+            CHECK(std::string(buffer, out.ptr) == text);
+            out = to_chars(buffer, buffer + text.size() - 1, x, base);
+            CHECK(out.ec == std::errc::value_too_large && out.ptr == buffer + text.size() - 1);
+
+            in = from_chars(text.data(), text.data() + text.size(), y, base);
+            CHECK(in.ec == std::errc() && in.ptr == text.data() + text.size() && y == x);
+        }
+        out = to_chars(buffer, buffer + sizeof(buffer), bigbigint_view(x));
+        CHECK(std::string(buffer, out.ptr) == x.to_string());
+    }
+
+    x = -5L;
+    out = to_chars(buffer, buffer, x);
+    CHECK(out.ec == std::errc::value_too_large && out.ptr == buffer);
+    out = to_chars(buffer, buffer + sizeof(buffer), x, 1);
+    CHECK(out.ec == std::errc::invalid_argument && out.ptr == buffer);
+    out = to_chars(buffer, buffer + sizeof(buffer), x, 37);
+    CHECK(out.ec == std::errc::invalid_argument && out.ptr == buffer);
+    x = 0L;
+    out = to_chars(buffer, buffer + 1, x);
+    CHECK(out.ec == std::errc() && out.ptr == buffer + 1 && buffer[0] == '0');
+    CHECK(x.digits_upper_bound() >= 1);
+
+    // from_chars stops at the first character that isn't a digit, 
+    // takes no '+' and no prefix, and leaves the value alone when 
+    // there are no digits
+    const char *number = "123abc";
+    in = from_chars(number, number + 6, y);
+    CHECK(in.ec == std::errc() && in.ptr == number + 3 && y == 123L);
+    in = from_chars(number, number + 6, y, 16);
+    CHECK(in.ec == std::errc() && in.ptr == number + 6 && y == 0x123abcL);
+    number = "0x10";
+    in = from_chars(number, number + 4, y, 16);
+    CHECK(in.ec == std::errc() && in.ptr == number + 1 && y == 0L);
+    number = "-0";
+    in = from_chars(number, number + 2, y);
+    CHECK(in.ec == std::errc() && y == 0L && y.to_string() == "0");
+    number = "-17 ";
+    in = from_chars(number, number + 4, y);
+    CHECK(in.ec == std::errc() && in.ptr == number + 3 && y == -17L);
+
+    y = 77L;
+    number = "-+5";
+    in = from_chars(number, number + 1, y);
+    CHECK(in.ec == std::errc::invalid_argument && in.ptr == number);
+    in = from_chars(number, number + 3, y);
+    CHECK(in.ec == std::errc::invalid_argument && in.ptr == number);
+    in = from_chars(number + 1, number + 3, y);
+    CHECK(in.ec == std::errc::invalid_argument && in.ptr == number + 1);
+    in = from_chars(number, number, y);
+    CHECK(in.ec == std::errc::invalid_argument && in.ptr == number);
+    number = " 5";
+    in = from_chars(number, number + 2, y);
+    CHECK(in.ec == std::errc::invalid_argument && in.ptr == number);
+    number = "5";
+    in = from_chars(number, number + 1, y, 37);
+    CHECK(in.ec == std::errc::invalid_argument && in.ptr == number);
+    CHECK(y == 77L);
+}
+
+//
+//  << formats the way it does a built-in integer (only a negative
+//  value in hex or octal differs:  it's a sign and a magnitude), and 
+//  >> reads what << writes
+static void test_streams()
+{
+    static const long values[] = { 0, 1, 42, 255, 123456789, -1, -42, -123456789 };
+    static const std::ios_base::fmtflags bases[] = { 
+        std::ios_base::dec, std::ios_base::hex, std::ios_base::oct 
+    };
+    static const std::ios_base::fmtflags adjusts[] = { 
+        std::ios_base::right, std::ios_base::left, std::ios_base::internal 
+    };
+    static const std::ios_base::fmtflags extras[] = { 
+        std::ios_base::fmtflags(0), std::ios_base::showbase, std::ios_base::showpos, 
+        std::ios_base::uppercase, std::ios_base::showbase | std::ios_base::uppercase, 
+        std::ios_base::showbase | std::ios_base::showpos 
+    };
+    bigbigint x, y;
+    std::string text;
+    unsigned long v, b, a, e, i;
+
+    for (v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+        x = values[v];
+        for (b = 0; b < sizeof(bases) / sizeof(bases[0]); b++) {
+            if (values[v] < 0 && bases[b] != std::ios_base::dec) {
+                continue;
+            }
+            for (a = 0; a < sizeof(adjusts) / sizeof(adjusts[0]); a++) {
+                for (e = 0; e < sizeof(extras) / sizeof(extras[0]); e++) {
+                    std::ostringstream expect, got;
+                    expect.setf(bases[b] | adjusts[a] | extras[e]);
+                    got.setf(bases[b] | adjusts[a] | extras[e]);
+                    expect.fill('*');
+                    got.fill('*');
+                    expect << std::setw(14) << values[v] << "|" << values[v];
+                    got << std::setw(14) << x << "|" << x;
+                    CHECK(got.str() == expect.str());
+                }
+            }
+        }
+    }
+
+    // Negative values in hex and octal, and more than one limb
+    {
+        std::ostringstream out;
+        x = -255L;
+        out << std::hex << x << " " << std::showbase << x << " " << std::uppercase << x;
+        out << " " << std::nouppercase << std::internal << std::setfill('*') << std::setw(10) << x;
+        out << " " << std::oct << x << " " << std::noshowbase << x;
+        CHECK(out.str() == "-ff -0xff -0XFF -0x*****ff -0377 -377");
+    }
+    {
+        std::ostringstream out;
+        x.from_string("18446744073709551616");
+        out << x << " " << std::hex << std::showbase << std::uppercase << x << " " << std::oct << x;
+        CHECK(out.str() == "18446744073709551616 0X10000000000000000 02000000000000000000000");
+    }
+
+    // Reading
+    {
+        std::istringstream in("  123 -456 +7");
+        CHECK((in >> x) && x == 123L);
+        CHECK((in >> x) && x == -456L);
+        CHECK((in >> x) && x == 7L && in.eof());
+        CHECK(!(in >> x) && x == 7L);
+    }
+    {
+        std::istringstream in("0x1F ff -0XA 0g");
+        in >> std::hex;
+        CHECK((in >> x) && x == 31L);
+        CHECK((in >> x) && x == 255L);
+        CHECK((in >> x) && x == -10L);
+        CHECK((in >> x) && x == 0L && in.peek() == 'g');
+    }
+    {
+        std::istringstream in("17 0x10 0b11 010 99 0");
+        CHECK((in >> std::oct >> x) && x == 15L);
+        in.unsetf(std::ios_base::basefield);
+        CHECK((in >> x) && x == 16L);
+        CHECK((in >> x) && x == 3L);
+        CHECK((in >> x) && x == 8L);
+        CHECK((in >> x) && x == 99L);
+        CHECK((in >> x) && x == 0L);
+    }
+    {
+        std::istringstream in("abc");
+        x = 5L;
+        CHECK(!(in >> x) && in.fail() && x == 5L);
+    }
+    {
+        std::istringstream in(" 5");
+        in >> std::noskipws;
+        CHECK(!(in >> x) && x == 5L);
+    }
+
+    // Round trips, long enough that >> has to move its buffer to the heap
+    for (i = 0; i < 6; i++) {
+        std::stringstream io;
+        x = random_value(10 + i * 40, (i & 1) != 0);
+        io.setf(bases[i % 3], std::ios_base::basefield);
+        io << std::showbase << x << " " << x;
+        io.unsetf(std::ios_base::basefield);
+        CHECK((io >> y) && y == x);
+        io.setf(bases[i % 3], std::ios_base::basefield);
+        CHECK((io >> y) && y == x);
+    }
+}
+
+//
+//  Against values worked out separately (Python's pow)
+static void test_powmod()
+{
+    bigbigint base, exponent, modulus;
+
+    base = 3L;
+    exponent = 200L;
+    modulus = 1000003L;
+    CHECK((long)base.powmod(exponent, modulus) == 333986);
+
+    // A negative base or modulus still lands in 0 .. |modulus| - 1
+    base = -7L;
+    exponent = 13L;
+    modulus = 97L;
+    CHECK((long)base.powmod(exponent, modulus) == 59);
+    modulus = -97L;
+    CHECK((long)base.powmod(exponent, modulus) == 59);
+
+    // x^0 is 1, anything mod 1 is 0, and a negative exponent gives 0
+    exponent = 0L;
+    CHECK((long)base.powmod(exponent, modulus) == 1);
+    exponent = 13L;
+    modulus = 1L;
+    CHECK((long)base.powmod(exponent, modulus) == 0);
+    exponent = -1L;
+    modulus = 97L;
+    CHECK((long)base.powmod(exponent, modulus) == 0);
+
+    // Several limbs, so every window gets used
+    base.from_string("123456789012345678901234567890");
+    exponent = 65537L;
+    modulus.from_string("170141183460469231731687303715884105727");
+    CHECK(base.powmod(exponent, modulus).to_string() == "43089841487593468092862748681566865937");
+}
+
+//
+//  >> on a negative value rounds down, like a two's complement shift
+static void test_shift_right()
+{
+    bigbigint x;
+
+    x = -5L;
+    CHECK((long)(x >> 1) == -3);
+    CHECK((long)(x << -1) == -3);
+    x = -4L;
+    CHECK((long)(x >> 1) == -2);
+    x = 5L;
+    CHECK((long)(x >> 1) == 2);
+    x = -12345L;
+    x >>= 3;
+    CHECK((long)x == -1544);
+
+    // All the bits shifted out
+    x = -1L;
+    CHECK((long)(x >> 100) == -1);
+    x = 7L;
+    CHECK((long)(x >> 100) == 0);
+
+    // Rounding down carries into a limb the shift emptied
+    x.from_string("-340282366920938463463374607431768211455");
+    CHECK((x >> 64).to_string() == "-18446744073709551616");
+    x.from_string("-340282366920938463463374607431768211457");
+    CHECK((x >> 64).to_string() == "-18446744073709551617");
+    x.from_string("-1606938044258990275541962092341162602522202993782792835313721");
+    CHECK((x >> 67).to_string() == "-10889035741470030830827987437816582766593");
+}
+
+//
+//  fixed_bigbigint is constexpr, so most of its checks are made by 
+//  the compiler.  2^bit, for building values past the first limb:
+template <unsigned int Bits>
+constexpr fixed_bigbigint<Bits> fixed_bit(unsigned int bit)
+{
+    fixed_bigbigint<Bits> value;
+    value.set_limb(bit / 64, (uint64_t)1 << (bit % 64));
+    return value;
+}
+
+typedef fixed_bigbigint<256> fixed256;
+
+// Signed values sign extend into every limb, unsigned ones don't
+static_assert(fixed256(-1).limb(0) == ~0ULL && fixed256(-1).limb(3) == ~0ULL, "-1 is all ones");
+static_assert(fixed256(-2L) == fixed256(0) - fixed256(2), "-2");
+static_assert(fixed256((long long)INT64_MIN).limb(0) == 0x8000000000000000ULL && 
+              fixed256((long long)INT64_MIN).limb(1) == ~0ULL, "INT64_MIN");
+static_assert(fixed256(~0ULL).limb(0) == ~0ULL && fixed256(~0ULL).limb(1) == 0, "2^64 - 1");
+static_assert(fixed256(~0U).limb(0) == 0xFFFFFFFFULL, "2^32 - 1");
+
+// +, - and * carry across limbs and wrap at 2^256
+static_assert(fixed256(~0ULL) + fixed256(1) == fixed_bit<256>(64), "carry");
+static_assert(fixed_bit<256>(64) - fixed256(1) == fixed256(~0ULL), "borrow");
+static_assert(fixed256(-1) + fixed256(1) == fixed256(0), "wraps up");
+static_assert(fixed256(0) - fixed256(1) == fixed256(-1), "wraps down");
+static_assert(fixed256(3) - fixed256(5) == -fixed256(2), "negation");
+static_assert(fixed256(-3) * fixed256(-5) == fixed256(15), "signs multiply");
+static_assert(fixed256(-3) * 5 == fixed256(-15), "mixed");
+static_assert((fixed256(~0ULL) * fixed256(~0ULL)).limb(0) == 1 && 
+              (fixed256(~0ULL) * fixed256(~0ULL)).limb(1) == ~0ULL - 1, "(2^64 - 1)^2");
+static_assert(fixed_bit<256>(128) * fixed_bit<256>(128) == fixed256(0), "2^256 wraps");
+static_assert(fixed_bit<256>(200) * fixed_bit<256>(55) == fixed_bit<256>(255), "2^255");
+static_assert(fixed_bit<256>(255) + fixed_bit<256>(255) == fixed256(0), "2^255 + 2^255");
+
+// Comparison is unsigned
+static_assert(fixed256(2).compare(fixed256(1)) == 1 && fixed256(1).compare(fixed256(2)) == -1, "compare");
+static_assert(fixed256(7).compare(fixed256(7)) == 0, "compare equal");
+static_assert(fixed256(-1) > fixed256(1) && fixed_bit<256>(200) > fixed256(~0ULL), "unsigned");
+static_assert(fixed_bit<256>(64) < fixed_bit<256>(65) && fixed256(0) <= fixed256(0), "ordering");
+
+//
+//  Round trips through bigbigint, negative values included:  they come
+//  back as their two's complement, and big ones are cut to 256 bits.
+static void test_fixed()
+{
+    bigbigint x, y, wrap;
+    fixed256 f;
+
+    wrap = 1L;
+    wrap <<= 256;
+
+    x = -5L;
+    f = fixed256(x);
+    CHECK(f == fixed256(-5));
+    y = f.to_bigbigint();
+    CHECK(y == wrap - 5L);
+
+    x = random_value(3, true);
+    f = fixed256(x);
+    CHECK(-f == fixed256(-x));
+    y = f;
+    CHECK(y == wrap + x);
+
+    x = random_value(6, false);
+    y = x;
+    y >>= 256;
+    y <<= 256;
+    y = x - y;
+    CHECK(fixed256(x).to_bigbigint() == y);
+
+    x = 1L;
+    x <<= 64 * 3;
+    CHECK(fixed256(x) == fixed_bit<256>(192) && fixed256(x).to_bigbigint() == x);
+}
+
+//
+//  Copying a zero view, including one with no limbs behind it
+static void test_view_zero()
+{
+    bigbigint_view none;
+    bigbigint x(none);
+    CHECK(x.to_string() == "0");
+    x += 5L;
+    CHECK((long)x == 5);
+
+    BBI_BASE_TYPE limbs[3] = { 0, 0, 0 };
+    bigbigint y(bigbigint_view(limbs, 3, true));
+    CHECK(y.to_string() == "0" && !bigbigint_view(y).is_negative());
+
+    bigbigint zero;
+    bigbigint z((bigbigint_view(zero)));
+    CHECK(z == 0L);
+}
+
+//
+//  Views compare and hash the same as the bigbigints they show, 
+//  whether they're made from one or from a slice of limbs with zeros
+//  on top, and a negative zero is just zero.
+static void test_view_compare_hash()
+{
+    static const unsigned long sizes[] = { 0, 1, 2, 5, 40 };
+    std::vector<uint64_t> limbs;
+    bigbigint values[10], x, y, big;
+    unsigned long count;
+    unsigned int i, j;
+    int expect;
+
+    for (i = 0; i < 10; i++) {
+        if (sizes[i / 2] == 0) {
+            values[i] = 0L;
+        }
+        else {
+            values[i] = random_value(sizes[i / 2], (i & 1) != 0);
+        }
+    }
+
+    for (i = 0; i < 10; i++) {
+        bigbigint_view view(values[i]);
+
+        // The same limbs in an array with three zero limbs over them
+        limbs.assign(sizes[i / 2] + 3, 0);
+        count = values[i].export_words(&limbs[0], -1, sizeof(uint64_t), 0);
+        CHECK(count == sizes[i / 2]);
+        bigbigint_view slice(&limbs[0], limbs.size(), (i & 1) != 0);
+
+        CHECK(slice.size() == sizes[i / 2] && slice.is_negative() == (values[i] < 0L));
+        CHECK(view.compare(slice) == 0 && slice == view);
+        CHECK(slice.hash() == view.hash());
+        CHECK(std::hash<bigbigint_view>()(slice) == std::hash<bigbigint>()(values[i]));
+        CHECK(slice.to_string(16) == values[i].to_string(16));
+
+        for (j = 0; j < 10; j++) {
+            expect = values[i].compare(values[j]);
+            CHECK(slice.compare(bigbigint_view(values[j])) == expect);
+            CHECK((slice < bigbigint_view(values[j])) == (expect < 0));
+        }
+    }
+
+    // Negative zero, with and without limbs behind it
+    limbs.assign(4, 0);
+    bigbigint_view negative_zero(&limbs[0], 4, true), none;
+    x = 0L;
+    CHECK(!negative_zero.is_negative() && negative_zero == none && negative_zero == bigbigint_view(x));
+    CHECK(negative_zero.hash() == none.hash() && none.hash() == std::hash<bigbigint>()(x));
+
+    // A value that's shrunk, so there are zero limbs over it
+    x = random_value(10, true);
+    big = 1L;
+    big <<= 64 * 20;
+    y = x + big;
+    y -= big;
+    CHECK(y == x && bigbigint_view(y).size() == 10);
+    CHECK(std::hash<bigbigint>()(y) == std::hash<bigbigint>()(x));
+}
+
+//
+//  export_words writes, and import_words reads, the bytes of the 
+//  magnitude in every word size, word order and byte order.  Two 
+//  layouts are written out by hand; the rest are built a byte at a 
+//  time from where byte k of the magnitude belongs.
+static void test_import_export()
+{
+    static const unsigned char words_be[12] = {        // size 4, order 1, endian 1
+        0x00, 0x00, 0x01, 0x02,  0x03, 0x04, 0x05, 0x06,  0x07, 0x08, 0x09, 0x0A
+    };
+    static const unsigned char words_le[12] = {        // size 4, order -1, endian -1
+        0x0A, 0x09, 0x08, 0x07,  0x06, 0x05, 0x04, 0x03,  0x02, 0x01, 0x00, 0x00
+    };
+    static const unsigned long sizes[] = { 1, 2, 3, 4, 5, 8, 9, 16 };
+    static const int orders[] = { 1, -1 };
+    static const int endians[] = { 1, -1, 0 };
+    unsigned char buffer[64], expect[64];
+    bigbigint x, y;
+    unsigned long size, count, word, byte, k;
+    unsigned int i, j, e;
+    int order, endian;
+
+    x.from_string("0102030405060708090a", 16);
+    memset(buffer, 0xEE, sizeof(buffer));
+    CHECK(x.export_count(4) == 3 && x.export_words(buffer, 1, 4, 1) == 3);
+    CHECK(memcmp(buffer, words_be, sizeof(words_be)) == 0 && buffer[12] == 0xEE);
+    CHECK(x.export_words(buffer, -1, 4, -1) == 3);
+    CHECK(memcmp(buffer, words_le, sizeof(words_le)) == 0);
+    y.import_words(3, 1, 4, 1, words_be);
+    CHECK(y == x);
+    y.import_words(3, -1, 4, -1, words_le);
+    CHECK(y == x);
+
+    // 23 bytes, 0x01 (the most significant) to 0x17, negative:  only
+    // the magnitude goes out, and it comes back positive
+    x.from_string("-0102030405060708090a0b0c0d0e0f1011121314151617", 16);
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (j = 0; j < 2; j++) {
+            for (e = 0; e < 3; e++) {
+                size = sizes[i];
+                order = orders[j];
+                endian = (endians[e] == 0 ? BBI_HOST_ENDIAN : endians[e]);
+                count = (23 + size - 1) / size;
+
+                memset(expect, 0, sizeof(expect));
+                for (k = 0; k < 23; k++) {
+                    word = (order == -1 ? k / size : count - 1 - (k / size));
+                    byte = (endian == -1 ? k % size : size - 1 - (k % size));
+                    expect[(word * size) + byte] = (unsigned char)(23 - k);
+                }
+
+                memset(buffer, 0xEE, sizeof(buffer));
+                CHECK(x.export_count(size) == count);
+                CHECK(x.export_words(buffer, order, size, endians[e]) == count);
+                CHECK(memcmp(buffer, expect, count * size) == 0 && buffer[count * size] == 0xEE);
+
+                y = -5L;
+                y.import_words(count, order, size, endians[e], expect);
+                CHECK(y == -x);
+            }
+        }
+    }
+
+    // Zero words on top import to the same value, and zero exports none
+    memset(expect, 0, sizeof(expect));
+    memcpy(expect + 4, words_be, sizeof(words_be));
+    y.import_words(4, 1, 4, 1, expect);
+    x.from_string("0102030405060708090a", 16);
+    CHECK(y == x);
+    x = 0L;
+    CHECK(x.export_count(8) == 0 && x.export_words(buffer, 1, 8, 1) == 0);
+    y.import_words(0, 1, 8, 1, expect);
+    CHECK(y == 0L);
+}
+
+//
+//  The carry chain kernels (bbi_add_n, bbi_sub_n, bbi_mul_1, 
+//  bbi_addmul_1, bbi_submul_1) are the ADX/MULX ones on a processor 
+//  that has them and the portable loops otherwise.  Either way they
+//  have to match plain arithmetic, at every length the unrolled loops
+//  can end on and with multipliers that make the carries run.
+static void test_kernels()
+{
+    static const uint64_t multipliers[] = { 0, 1, ~0ULL, 0x8000000000000001ULL, 0 };
+    std::vector<uint64_t> a, b, r, expect;
+    uint64_t carry, expect_carry, sum, m;
+    unsigned long n, i;
+    unsigned int k;
+
+    for (n = 0; n <= 70; n++) {
+        a = random_limbs(n);
+        b = random_limbs(n);
+
+        r = random_limbs(n);
+        expect = r;
+        expect_carry = 0;
+        for (i = 0; i < n; i++) {
+            sum = a[i] + b[i];
+            expect[i] = sum + expect_carry;
+            expect_carry = (sum < a[i]) + (expect[i] < sum);
+        }
+        carry = bbi_add_n(&r[0], &a[0], &b[0], n);
+        CHECK(carry == expect_carry && r == expect);
+
+        expect_carry = 0;
+        for (i = 0; i < n; i++) {
+            sum = a[i] - b[i];
+            expect[i] = sum - expect_carry;
+            expect_carry = (a[i] < b[i]) + (sum < expect_carry);
+        }
+        carry = bbi_sub_n(&r[0], &a[0], &b[0], n);
+        CHECK(carry == expect_carry && r == expect);
+
+        for (k = 0; k < sizeof(multipliers) / sizeof(multipliers[0]); k++) {
+            m = (k == 4 ? random_limb() : multipliers[k]);
+
+            r = random_limbs(n);
+            expect.assign(n + 1, 0);
+            expect_carry = reference_addmul_1(&expect[0], &a[0], n, m, false);
+            carry = bbi_mul_1(&r[0], &a[0], n, m);
+            CHECK(carry == expect_carry && std::equal(r.begin(), r.begin() + n, expect.begin()));
+
+            r = random_limbs(n);
+            expect = r;
+            expect_carry = reference_addmul_1(&expect[0], &a[0], n, m, false);
+            carry = bbi_addmul_1(&r[0], &a[0], n, m);
+            CHECK(carry == expect_carry && r == expect);
+
+            expect = r;
+            expect_carry = reference_addmul_1(&expect[0], &a[0], n, m, true);
+            carry = bbi_submul_1(&r[0], &a[0], n, m);
+            CHECK(carry == expect_carry && r == expect);
+        }
+    }
+}
+
+//
+//  The mpn layer on its own.  bbi_mul against schoolbook on both 
+//  sides of the Karatsuba threshold, balanced and not;  bbi_sqr 
+//  against bbi_mul;  and bbi_divrem giving q d + r = a with r < d, 
+//  for divisors whose top limb is 1 (the biggest normalizing shift),
+//  all ones (none) and random.
+static void test_mpn()
+{
+    const unsigned long threshold = BBI_MUL_KARATSUBA_THRESHOLD;
+    const unsigned long lengths[] = {
+        1, 2, 3, threshold - 1, threshold, threshold + 1, (2 * threshold) + 1, 100
+    };
+    std::vector<uint64_t> a, b, r, expect, q, rem, scratch;
+    unsigned long an, bn, dn, n, i, j;
+    uint64_t carry;
+    unsigned int k, top;
+
+    for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        bn = lengths[i];
+        for (k = 0; k < 3; k++) {
+            an = (k == 0 ? bn : k == 1 ? bn + 1 : (3 * bn) + 7);
+            a = random_limbs(an);
+            b = random_limbs(bn);
+            r.assign(an + bn, 0);
+            expect.assign(an + bn, 0);
+            bbi_mul(&r[0], &a[0], an, &b[0], bn);
+            reference_product(&expect[0], &a[0], an, &b[0], bn);
+            CHECK(r == expect);
+        }
+    }
+
+    for (n = 1; n <= 2 * BBI_SQR_KARATSUBA_THRESHOLD + 3; n++) {
+        a = random_limbs(n);
+        b = a;
+        r.assign(2 * n, 0);
+        expect.assign(2 * n, 0);
+        bbi_sqr(&r[0], &a[0], n);
+        bbi_mul(&expect[0], &a[0], n, &b[0], n);
+        CHECK(r == expect);
+    }
+
+    for (dn = 1; dn <= 40; dn += (dn < 6 ? 1 : 17)) {
+        for (an = dn; an <= dn + 40; an += 13) {
+            for (top = 0; top < 3; top++) {
+                a = random_limbs(an);
+                b = random_limbs(dn);
+                b[dn - 1] = (top == 0 ? 1 : top == 1 ? ~0ULL : (b[dn - 1] | 1));
+                q.assign(an - dn + 1, 0);
+                rem.assign(dn, 0);
+                scratch.assign(BBI_DIVREM_SCRATCH(an, dn), 0);
+                bbi_divrem(&q[0], &rem[0], &a[0], an, &b[0], dn, &scratch[0]);
+
+                // r < d, and q d + r is a (with nothing above it)
+                CHECK(bbi_cmp(&rem[0], dn, &b[0], dn) < 0);
+                expect.assign(an + 1, 0);
+                reference_product(&expect[0], &q[0], an - dn + 1, &b[0], dn);
+                carry = bbi_add(&expect[0], &expect[0], an + 1, &rem[0], dn);
+                CHECK(carry == 0 && expect[an] == 0);
+                CHECK(std::equal(a.begin(), a.begin() + an, expect.begin()));
+            }
+        }
+    }
+
+    // And by one limb
+    a = random_limbs(50);
+    q.assign(50, 0);
+    for (j = 0; j < 3; j++) {
+        b.assign(1, j == 0 ? 1 : j == 1 ? ~0ULL : random_limb() | 1);
+        carry = bbi_divrem_1(&q[0], &a[0], 50, b[0]);
+        CHECK(carry < b[0] && carry == bbi_mod_1(&a[0], 50, b[0]));
+        expect.assign(51, 0);
+        expect[50] = reference_addmul_1(&expect[0], &q[0], 50, b[0], false);
+        CHECK(bbi_add_1(&expect[0], &expect[0], 51, carry) == 0 && expect[50] == 0);
+        CHECK(std::equal(a.begin(), a.begin() + 50, expect.begin()));
+    }
+}
+
+//
+//  The scratch stack hands out space in LIFO order:  what a scope 
+//  allocates is gone when it ends, without touching what was there 
+//  before it, and the same request afterwards gets the same space 
+//  back rather than new memory.  A product leaves the stack where it
+//  found it.
+static void test_scratch()
+{
+    std::vector<uint64_t> a, b, r;
+    bbi_tmp_mark mark, after;
+    uint64_t *outer, *inner, *again, *big;
+    unsigned long n, i;
+    bool intact;
+
+    mark = bbi_tmp_save();
+    {
+        bbi_tmp_scope tmp;
+        outer = tmp.alloc(100);
+        for (i = 0; i < 100; i++) {
+            outer[i] = i;
+        }
+
+        {
+            bbi_tmp_scope nested;
+            inner = nested.alloc(100);
+            memset(inner, 0xFF, 100 * sizeof(uint64_t));
+            CHECK(inner + 100 <= outer || inner >= outer + 100);
+
+            // Past the first block, so it takes another
+            big = nested.alloc(1UL << 20);
+            memset(big, 0xFF, (1UL << 20) * sizeof(uint64_t));
+        }
+        {
+            bbi_tmp_scope nested;
+            again = nested.alloc(100);
+            CHECK(again == inner);
+            CHECK(nested.alloc(1UL << 20) == big);
+        }
+
+        intact = true;
+        for (i = 0; i < 100; i++) {
+            intact = intact && (outer[i] == i);
+        }
+        CHECK(intact);
+    }
+    after = bbi_tmp_save();
+    CHECK(after.block == mark.block && after.used == mark.used);
+
+    // Karatsuba and FFT products run on it
+    n = 3 * BBI_MUL_FFT_THRESHOLD;
+    a = random_limbs(n);
+    b = random_limbs(300);
+    r.assign(2 * n, 0);
+    bbi_mul(&r[0], &a[0], n, &b[0], 300);
+    bbi_mul(&r[0], &a[0], n, &a[0], n);
+    after = bbi_tmp_save();
+    CHECK(after.block == mark.block && after.used == mark.used);
+}
+
+//
+//  Products split across threads (Karatsuba's subproducts below the
+//  FFT, the FFT's points above it) match the same products done on
+//  one thread:  balanced, unbalanced, squares and all ones (whose
+//  carries run from one Garner piece well into the next), and with
+//  two threads multiplying at once.
+static void test_parallel_mul()
+{
+    static const unsigned long sizes[][2] = {
+        { 600, 600 }, { 1000, 999 }, { 2047, 2047 }, { 3000, 700 }, 
+        { 5000, 5000 }, { 20000, 4500 }, { 40000, 40000 }
+    };
+    const unsigned int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    bigbigint a[num_sizes], b[num_sizes], expect[num_sizes], squares[num_sizes];
+    bigbigint ones, ones_copy, ones_square, product;
+    unsigned int i;
+
+    for (i = 0; i < num_sizes; i++) {
+        a[i] = random_value(sizes[i][0], (i % 2) == 1);
+        b[i] = random_value(sizes[i][1], false);
+        expect[i] = a[i] * b[i];
+        squares[i] = a[i] * a[i];
+    }
+    ones = 1L;
+    ones <<= 64 * 5000;
+    ones -= 1L;
+    ones_copy = ones;
+    ones_square = ones * ones;
+
+    bigbigint::set_mul_threads(4, 64);
+    CHECK(bigbigint::mul_threads() == 4);
+    for (i = 0; i < num_sizes; i++) {
+        product = a[i] * b[i];
+        CHECK(product == expect[i]);
+        product = b[i] * a[i];
+        CHECK(product == expect[i]);
+        product = a[i] * a[i];
+        CHECK(product == squares[i]);
+    }
+    product = ones * ones;
+    CHECK(product == ones_square);
+    product = ones * ones_copy;
+    CHECK(product == ones_square);
+
+    std::thread other([&a, &b, &expect]() {
+        bigbigint other_product;
+        unsigned int k;
+
+        for (k = 0; k < num_sizes; k++) {
+            other_product = a[k] * b[k];
+            CHECK(other_product == expect[k]);
+        }
+    });
+    for (i = num_sizes; i-- > 0; ) {
+        product = a[i] * a[i];
+        CHECK(product == squares[i]);
+    }
+    other.join();
+
+    bigbigint::set_mul_threads(1, BBI_MUL_PARALLEL_THRESHOLD);
+    CHECK(bigbigint::mul_threads() == 1);
+}
+
+#if defined(BBI_ENABLE_STATS)
+//
+//  Each thread counts its own operations, and a thread's counts are 
+//  kept in the all-threads total after it exits.
+static void test_stats()
+{
+    bigbigint x, y, z;
+    bbi_stats counts;
+
+    x = random_value(40, false);
+    y = random_value(30, true);
+    bigbigint::reset_stats(true);
+    counts = bigbigint::stats();
+    CHECK(counts.calls[BBI_STAT_MUL] == 0 && counts.limbs[BBI_STAT_MUL] == 0);
+
+    z = x * y;
+    counts = bigbigint::stats();
+    CHECK(counts.calls[BBI_STAT_MUL] == 1 && counts.limbs[BBI_STAT_MUL] == 70);
+    CHECK(counts.calls[BBI_STAT_ADD] == 0 && counts.calls[BBI_STAT_DIV] == 0);
+    z *= x;
+    z += y;
+    counts = bigbigint::stats();
+    CHECK(counts.calls[BBI_STAT_MUL] == 2 && counts.calls[BBI_STAT_ADD] == 1);
+
+    std::thread other([&x, &y]() {
+        bigbigint product;
+
+        product = x * y;
+        CHECK(bigbigint::stats().calls[BBI_STAT_MUL] == 1);
+    });
+    other.join();
+    CHECK(bigbigint::stats().calls[BBI_STAT_MUL] == 2);
+    CHECK(bigbigint::stats(true).calls[BBI_STAT_MUL] == 3);
+
+    bigbigint::reset_stats(true);
+    counts = bigbigint::stats(true);
+    CHECK(counts.calls[BBI_STAT_MUL] == 0 && counts.calls[BBI_STAT_ADD] == 0);
+}
+#endif
+
+#if !defined(WIN32)
+//
+//  An empty temporary file, already unlinked (it goes when it's closed)
+static int temp_file()
+{
+    char path[] = "/tmp/bbi_test_XXXXXX";
+    int fd;
+
+    fd = mkstemp(path);
+    if (fd >= 0) {
+        unlink(path);
+    }
+    return fd;
+}
+
+//
+//  A header that claims more limbs than there are has to fail (not
+//  try to allocate them all), from a file or a pipe, and leave the 
+//  value alone.
+static void test_load_forged()
+{
+    unsigned char data[72];
+    bigbigint x, y;
+    int fd, fds[2];
+
+    fd = temp_file();
+    CHECK(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+
+    // A good one round trips
+    x.from_string("123456789012345678901234567890123456789012345678901234567890");
+    CHECK(x.save(fd));
+    lseek(fd, 0, SEEK_SET);
+    CHECK(y.load(fd) && y == x);
+
+    // A one limb value (64 byte header, 8 byte limb) whose header 
+    // says 2^46 limbs
+    CHECK(ftruncate(fd, 0) == 0);
+    lseek(fd, 0, SEEK_SET);
+    x = 12345L;
+    CHECK(x.save(fd));
+    lseek(fd, 0, SEEK_SET);
+    CHECK(read(fd, data, sizeof(data)) == (long)sizeof(data));
+    memset(data + 16, 0, 8);
+    data[21] = 0x40;
+    lseek(fd, 0, SEEK_SET);
+    CHECK(write(fd, data, sizeof(data)) == (long)sizeof(data));
+    lseek(fd, 0, SEEK_SET);
+
+    y = 7L;
+    CHECK(!y.load(fd));
+    CHECK((long)y == 7);
+    close(fd);
+
+    // The same through a pipe, where the size isn't known up front
+    CHECK(pipe(fds) == 0);
+    CHECK(write(fds[1], data, sizeof(data)) == (long)sizeof(data));
+    close(fds[1]);
+    CHECK(!y.load(fds[0]));
+    CHECK((long)y == 7);
+    close(fds[0]);
+}
+//
+//  A read-only mapping (load_mapped(path, false)) has to move to the
+//  heap on its first change, however it's changed, and leave the file
+//  alone.  Each change is made to a fresh mapping and to a heap copy.
+static void test_load_mapped_read_only()
+{
+    char path[] = "/tmp/bbi_test_XXXXXX";
+    bigbigint x, expect, big, small;
+    int fd, op;
+
+    big.from_string("-123456789012345678901234567890123456789012345678901234567890");
+    small = 1000003L;
+    fd = mkstemp(path);
+    CHECK(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+    CHECK(big.save(fd));
+    close(fd);
+
+    for (op = 0; op < 13; op++) {
+        CHECK(x.load_mapped(path, false));
+        expect = big;
+        switch (op) {
+        case 0:     x = 5L;                 expect = 5L;                break;
+        case 1:     x = small;              expect = small;             break;
+        case 2:     ++x;                    ++expect;                   break;
+        case 3:     x += small;             expect += small;            break;
+        case 4:     x <<= 3;                expect <<= 3;               break;
+        case 5:     x >>= 70;               expect >>= 70;              break;
+        case 6:     x &= small;             expect &= small;            break;
+        case 7:     x ^= x;                 expect ^= expect;           break;
+        case 8:     x.flip_bit(3);          expect.flip_bit(3);         break;
+        case 9:     x *= 3L;                expect *= 3L;               break;
+        case 10:    x /= 7L;                expect /= 7L;               break;
+        case 11:    x %= 7L;                expect %= 7L;               break;
+        case 12:    x.from_string("42");    expect.from_string("42");   break;
+        }
+        CHECK(x == expect);
+    }
+
+    CHECK(x.load_mapped(path, false) && x == big);
+    unlink(path);
+}
+
+//
+//  save and load round trip zero, small and multi-limb values of both
+//  signs, several to a file and one through a pipe.  Loading past the
+//  last one fails and leaves the value alone.
+static void test_save_load()
+{
+    bigbigint values[7], y;
+    unsigned int i;
+    int fd, fds[2];
+
+    values[0] = 0L;
+    values[1] = -1L;
+    values[2] = 12345L;
+    values[3].from_string("-18446744073709551616");
+    values[4] = random_value(300, false);
+    values[5] = random_value(300, true);
+    values[6] = random_value(2, true);
+
+    fd = temp_file();
+    CHECK(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+    for (i = 0; i < 7; i++) {
+        CHECK(values[i].save(fd));
+    }
+    lseek(fd, 0, SEEK_SET);
+    for (i = 0; i < 7; i++) {
+        y = 99L;
+        CHECK(y.load(fd) && y == values[i] && (y < 0L) == (values[i] < 0L));
+    }
+    y = 99L;
+    CHECK(!y.load(fd) && y == 99L);
+    close(fd);
+
+    // A pipe has no size to check against, so it's read in pieces
+    CHECK(pipe(fds) == 0);
+    CHECK(values[5].save(fds[1]));
+    close(fds[1]);
+    CHECK(y.load(fds[0]) && y == values[5]);
+    close(fds[0]);
+}
+
+//
+//  A writable mapping (load_mapped's default) is copy-on-write:  a 
+//  change made in place stays in the mapping but never reaches the 
+//  file, another mapping of the file doesn't see it, and anything 
+//  that needs more room moves the value to the heap.
+static void test_load_mapped_writable()
+{
+    char path[] = "/tmp/bbi_test_XXXXXX";
+    const BBI_BASE_TYPE *limbs;
+    bigbigint original, x, y, expect;
+    unsigned long bit;
+    int fd;
+
+    original = random_value(1000, false);
+    fd = mkstemp(path);
+    CHECK(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+    CHECK(original.save(fd));
+
+    CHECK(x.load_mapped(path) && x == original);
+    CHECK(y.load_mapped(path) && y == original);
+
+    // Clearing a set bit can't carry, so it's done where the limbs are
+    bit = 64 * 500;
+    while (!original.test_bit(bit)) {
+        bit++;
+    }
+    limbs = bigbigint_view(x).limbs();
+    expect = original;
+    x.flip_bit(bit);
+    expect.flip_bit(bit);
+    CHECK(x == expect && bigbigint_view(x).limbs() == limbs);
+    CHECK(y == original);
+    x -= 1000003L;
+    expect -= 1000003L;
+    CHECK(x == expect);
+
+    // The file still has the original, mapped or read
+    lseek(fd, 0, SEEK_SET);
+    CHECK(y.load(fd) && y == original);
+    CHECK(y.load_mapped(path) && y == original);
+    close(fd);
+
+    x <<= 64 * 10;
+    expect <<= 64 * 10;
+    CHECK(x == expect);
+    x >>= 64 * 10;
+    CHECK(x.load_mapped(path) && x == original);
+
+    // Too small to map is read in, and works the same
+    fd = open(path, O_RDWR | O_TRUNC);
+    CHECK(fd >= 0);
+    expect = -7L;
+    CHECK(expect.save(fd));
+    close(fd);
+    CHECK(x.load_mapped(path) && x == expect);
+    x *= 3L;
+    CHECK(x == -21L);
+    unlink(path);
+}
+
+#if defined(BBI_ENABLE_TRACE)
+//
+//  Just enough of a JSON parser to say whether text is valid
+static bool json_value(const char *&p);
+
+static void json_space(const char *&p)
+{
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+        p++;
+    }
+}
+
+static bool json_string(const char *&p)
+{
+    if (*p != '"') return false;
+    for (p++; *p != '"'; p++) {
+        if ((unsigned char)*p < 0x20) return false;
+        if (*p == '\\') {
+            p++;
+            if (*p == '\0' || strchr("\"\\/bfnrtu", *p) == NULL) return false;
+        }
+    }
+    p++;
+    return true;
+}
+
+static bool json_digits(const char *&p)
+{
+    if (*p < '0' || *p > '9') return false;
+    while (*p >= '0' && *p <= '9') {
+        p++;
+    }
+    return true;
+}
+
+static bool json_number(const char *&p)
+{
+    if (*p == '-') p++;
+    if (*p == '0') {
+        p++;
+    }
+    else if (!json_digits(p)) {
+        return false;
+    }
+    if (*p == '.') {
+        p++;
+        if (!json_digits(p)) return false;
+    }
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        if (*p == '+' || *p == '-') p++;
+        if (!json_digits(p)) return false;
+    }
+    return true;
+}
+
+static bool json_word(const char *&p, const char *word)
+{
+    if (strncmp(p, word, strlen(word)) != 0) return false;
+    p += strlen(word);
+    return true;
+}
+
+//  An object or array:  values (with keys, for an object) between 
+//  open and close, separated by commas
+static bool json_list(const char *&p, char close, bool keys)
+{
+    p++;
+    json_space(p);
+    if (*p == close) {
+        p++;
+        return true;
+    }
+    for (;;) {
+        if (keys) {
+            if (!json_string(p)) return false;
+            json_space(p);
+            if (*p++ != ':') return false;
+            json_space(p);
+        }
+        if (!json_value(p)) return false;
+        json_space(p);
+        if (*p == close) {
+            p++;
+            return true;
+        }
+        if (*p++ != ',') return false;
+        json_space(p);
+    }
+}
+
+static bool json_value(const char *&p)
+{
+    switch (*p) {
+        case '{':  return json_list(p, '}', true);
+        case '[':  return json_list(p, ']', false);
+        case '"':  return json_string(p);
+        case 't':  return json_word(p, "true");
+        case 'f':  return json_word(p, "false");
+        case 'n':  return json_word(p, "null");
+        default:   return json_number(p);
+    }
+}
+
+static bool json_valid(const std::string &text)
+{
+    const char *p = text.c_str();
+
+    json_space(p);
+    if (!json_value(p)) return false;
+    json_space(p);
+    return *p == '\0';
+}
+
+static std::string write_chrome_trace_text()
+{
+    std::string text;
+    char buffer[4096];
+    ssize_t length;
+    int fd;
+
+    fd = temp_file();
+    CHECK(fd >= 0 && bigbigint::write_chrome_trace(fd));
+    lseek(fd, 0, SEEK_SET);
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+        text.append(buffer, (size_t)length);
+    }
+    close(fd);
+    return text;
+}
+
+static unsigned long count_of(const std::string &text, const char *part)
+{
+    unsigned long count = 0;
+    size_t at;
+
+    for (at = text.find(part); at != std::string::npos; at = text.find(part, at + 1)) {
+        count++;
+    }
+    return count;
+}
+
+static unsigned long trace_begins = 0, trace_ends = 0;
+
+static void count_trace_begin(int op, unsigned long limbs, void *user)
+{
+    (void)op;
+    (void)limbs;
+    (void)user;
+    trace_begins++;
+}
+
+static void count_trace_end(int op, unsigned long limbs, uint64_t ns, void *user)
+{
+    (void)op;
+    (void)limbs;
+    (void)ns;
+    (void)user;
+    trace_ends++;
+}
+
+//
+//  Traced operations go to the hooks and the event list, and 
+//  write_chrome_trace() saves the events as valid JSON with one "X"
+//  event each, the ones over max_events dropped and counted.  Nothing
+//  under min_limbs is recorded, or anything once tracing stops.
+static void test_trace()
+{
+    bigbigint x, y, w, z, q;
+    std::string text;
+
+    x = random_value(40, false);
+    y = random_value(30, true);
+    w = random_value(10, false);
+    bigbigint::set_trace_hooks(count_trace_begin, count_trace_end, NULL);
+    bigbigint::trace_start(60, 100);
+    z = x * y;
+    q = z / y;
+    CHECK(q == x);
+    q = x * w;
+    bigbigint::trace_stop();
+    z = x * y;
+    bigbigint::set_trace_hooks(NULL, NULL, NULL);
+    CHECK(trace_begins == 2 && trace_ends == 2);
+
+    text = write_chrome_trace_text();
+    CHECK(json_valid(text));
+    CHECK(count_of(text, "\"ph\":\"X\"") == 2);
+    CHECK(count_of(text, "\"name\":\"mul\"") == 1 && count_of(text, "\"limbs\":70") == 1);
+    CHECK(count_of(text, "\"name\":\"div\"") == 1);
+    CHECK(count_of(text, "\"dropped\":0") == 1);
+
+    bigbigint::trace_start(60, 1);
+    z = x * y;
+    z = x * y;
+    bigbigint::trace_stop();
+    text = write_chrome_trace_text();
+    CHECK(json_valid(text));
+    CHECK(count_of(text, "\"ph\":\"X\"") == 1 && count_of(text, "\"dropped\":1") == 1);
+
+    // No events at all is still a whole document
+    bigbigint::trace_start(60, 0);
+    bigbigint::trace_stop();
+    text = write_chrome_trace_text();
+    CHECK(json_valid(text) && count_of(text, "\"ph\"") == 0);
+
+    // and the checker isn't just saying yes
+    CHECK(!json_valid("{\"a\":[1,2,]}") && !json_valid("{\"a\":1} x") && !json_valid("[\"\n\"]"));
+}
+#endif
+#endif
+
+int main()
+{
+    test_limb_storage();
+    test_expression_templates();
+    test_compound_assign();
+    test_compare();
+    test_bitwise();
+    test_bit_queries();
+    test_to_string();
+    test_fft_multiply();
+    test_from_string();
+    test_chars();
+    test_streams();
+    test_powmod();
+    test_shift_right();
+    test_fixed();
+    test_view_zero();
+    test_view_compare_hash();
+    test_import_export();
+    test_kernels();
+    test_mpn();
+    test_scratch();
+    test_parallel_mul();
+#if defined(BBI_ENABLE_STATS)
+    test_stats();
+#endif
+#if !defined(WIN32)
+    test_load_forged();
+    test_load_mapped_read_only();
+    test_save_load();
+    test_load_mapped_writable();
+#if defined(BBI_ENABLE_TRACE)
+    test_trace();
+#endif
+#endif
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all passed\n");
+    return 0;
+}
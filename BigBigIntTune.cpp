@@ -0,0 +1,394 @@
+// ------------------------------------------------------------
+//  BigBigIntTune.cpp
+//
+//  Created by Richard Andrasek
+//
+//  Purpose:
+//      Measures where the algorithm thresholds belong on this
+//  machine and writes them to bbi_tune.h, which the library picks up
+//  the next time it's built (see BigBigIntMpn.h).  The defaults are
+//  a guess for a recent x86-64; the real crossovers move around by a
+//  factor of two or so between processors.
+//
+//  Build it with the library, using the same compiler and flags the
+//  library is normally built with, plus BBI_TUNE_PROGRAM (all three
+//  files need it), e.g.
+//
+//      g++ -O2 -march=native -DBBI_TUNE_PROGRAM BigBigIntTune.cpp
+//          BigBigInt.cpp BigBigIntMpn.cpp -o bbi_tune
+//
+//  then run it in the source directory and rebuild the library
+//  (without BBI_TUNE_PROGRAM):
+//
+//      bbi_tune [options]
+//          -o FILE     write the header to FILE (default bbi_tune.h)
+//          -v          print every timing
+//
+//  Each threshold is found the way GMP's tuneup finds them.  At a
+//  size n the operation is timed twice:  with the threshold at n + 1
+//  (the old method all the way down) and at n (the new method once,
+//  at the top, with the old one doing the pieces).  The threshold is
+//  the first size where the new method wins.  It's bracketed by
+//  doubling n and then bisected.  The thresholds are measured in
+//  order, each with the ones before it already set, since the
+//  string conversions run on top of the multiplication.
+//
+// ------------------------------------------------------------
+#include "BigBigInt.h"
+#include "BigBigIntMpn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #include <cpuid.h>
+#endif
+
+#if !defined(BBI_TUNE_PROGRAM)
+    #error Build the tuner and the library with -DBBI_TUNE_PROGRAM
+#endif
+
+
+/*******************************************
+ *               OPERANDS                  *
+ *******************************************/
+
+#define TUNE_MAX_LIMBS      16384
+
+static BBI_BASE_TYPE tune_a[TUNE_MAX_LIMBS];
+static BBI_BASE_TYPE tune_b[TUNE_MAX_LIMBS];
+static BBI_BASE_TYPE tune_r[2 * TUNE_MAX_LIMBS];
+
+static bigbigint tune_value;
+static std::string tune_decimal;
+static std::vector<char> tune_text;
+
+static BBI_BASE_TYPE tune_random_state = 0x9E3779B97F4A7C15ULL;
+
+static BBI_BASE_TYPE tune_random()
+{
+    // xorshift64*
+    tune_random_state ^= tune_random_state >> 12;
+    tune_random_state ^= tune_random_state << 25;
+    tune_random_state ^= tune_random_state >> 27;
+    return tune_random_state * 0x2545F4914F6CDD1DULL;
+}
+
+//  tune_value is the first n limbs of tune_a, tune_decimal its text
+static void tune_setup_value(unsigned long n)
+{
+    tune_value.import_words(n, -1, sizeof(BBI_BASE_TYPE), 0, tune_a);
+    tune_decimal = tune_value.to_string(10);
+    tune_text.resize(tune_decimal.size() + 1);
+}
+
+
+/*******************************************
+ *              OPERATIONS                 *
+ *******************************************/
+
+static void tune_mul(unsigned long n)
+{
+    bbi_mul(tune_r, tune_a, n, tune_b, n);
+}
+
+static void tune_sqr(unsigned long n)
+{
+    bbi_sqr(tune_r, tune_a, n);
+}
+
+static void tune_get_str(unsigned long n)
+{
+    (void)n;
+    to_chars(&tune_text[0], &tune_text[0] + tune_text.size(), tune_value, 10);
+}
+
+static void tune_set_str(unsigned long n)
+{
+    static bigbigint result;
+
+    (void)n;
+    result.from_string(tune_decimal, 10);
+}
+
+//
+//  One threshold:  the macro it becomes, the variable the library
+//  reads while we're timing, the range of sizes to look at (in limbs,
+//  the same units as the threshold), what to set up for a size (if 
+//  anything) and the operation that depends on it.  old_method gives
+//  the threshold that keeps the old method at size n; it's n + 1 
+//  unless the threshold is compared against something other than n.
+struct tune_param
+{
+    const char *macro;
+    unsigned long *value;
+    unsigned long min_size, max_size;
+    void (*setup)(unsigned long n);
+    void (*run)(unsigned long n);
+    unsigned long (*old_method)(unsigned long n);
+};
+
+static unsigned long tune_next_size(unsigned long n) { return n + 1; }
+
+//  set_str compares the number of digits with the threshold times the
+//  digits per limb, and n limbs' worth of digits is a little more 
+//  than n of those, so n + 1 can still split it
+static unsigned long tune_never(unsigned long n) { (void)n; return ULONG_MAX / 64; }
+
+static const tune_param tune_params[] = {
+    { "BBI_MUL_KARATSUBA_THRESHOLD", &bbi_tune.mul_karatsuba, 4, 512,
+      NULL, tune_mul, tune_next_size },
+    { "BBI_SQR_KARATSUBA_THRESHOLD", &bbi_tune.sqr_karatsuba, 4, 1024,
+      NULL, tune_sqr, tune_next_size },
+    { "BBI_MUL_FFT_THRESHOLD",       &bbi_tune.mul_fft,       512, TUNE_MAX_LIMBS,
+      NULL, tune_mul, tune_next_size },
+    { "BBI_GET_STR_DC_THRESHOLD",    &bbi_tune.get_str_dc,    4, BBI_TUNE_GET_STR_LIMIT - 1,
+      tune_setup_value, tune_get_str, tune_next_size },
+    { "BBI_SET_STR_DC_THRESHOLD",    &bbi_tune.set_str_dc,    4, 1024,
+      tune_setup_value, tune_set_str, tune_never },
+};
+
+#define TUNE_NUM_PARAMS     (sizeof(tune_params) / sizeof(tune_params[0]))
+
+
+/*******************************************
+ *                TIMING                   *
+ *******************************************/
+
+static bool tune_verbose = false;
+
+static double tune_seconds()
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//
+//  Seconds for batch calls of the operation at size n with the 
+//  threshold set to threshold
+static double tune_batch(const tune_param &param, unsigned long n, 
+                         unsigned long threshold, unsigned long batch)
+{
+    unsigned long i;
+    double start;
+
+    *param.value = threshold;
+    start = tune_seconds();
+    for (i = 0; i < batch; i++) {
+        param.run(n);
+    }
+    return tune_seconds() - start;
+}
+
+//
+//  Does the new method win at size n?
+//
+//  Near the crossover the two differ by a few percent, less than the
+//  machine drifts over a second or two, so the old and new batches 
+//  take turns and each pair gives a ratio.  The median of the ratios
+//  decides, so one disturbed batch on either side can't.
+#define TUNE_ROUNDS     7
+
+static bool tune_new_wins(const tune_param &param, unsigned long n)
+{
+    unsigned long old_threshold, batch;
+    double elapsed, old_time, new_time, ratio, ratios[TUNE_ROUNDS];
+    int round, i;
+
+    if (param.setup != NULL) {
+        param.setup(n);
+    }
+    old_threshold = param.old_method(n);
+    tune_batch(param, n, old_threshold, 1);
+    tune_batch(param, n, n, 1);
+
+    // Batches of about 10ms
+    batch = 1;
+    for (;;) {
+        elapsed = tune_batch(param, n, old_threshold, batch);
+        if (elapsed >= 0.01) {
+            break;
+        }
+        batch = (elapsed > 0.0001 ? (unsigned long)(batch * (0.01 / elapsed) * 1.1) + 1 : batch * 8);
+    }
+
+    // Insertion sort as they come in
+    for (round = 0; round < TUNE_ROUNDS; round++) {
+        old_time = tune_batch(param, n, old_threshold, batch);
+        new_time = tune_batch(param, n, n, batch);
+        ratio = new_time / old_time;
+        for (i = round; i > 0 && ratios[i - 1] > ratio; i--) {
+            ratios[i] = ratios[i - 1];
+        }
+        ratios[i] = ratio;
+    }
+    ratio = ratios[TUNE_ROUNDS / 2];
+
+    if (tune_verbose) {
+        fprintf(stderr, "    %-28s %6lu limbs:  new/old %6.3f  (%.1f ns)\n",
+                param.macro, n, ratio, (old_time * 1e9) / batch);
+    }
+    return (ratio < 1.0);
+}
+
+//
+//  The smallest size in the parameter's range where the new method
+//  wins, or the top of the range if it never does
+static unsigned long tune_crossover(const tune_param &param)
+{
+    unsigned long low, high, mid;
+
+    // Bracket:  old wins at low, new wins at high
+    low = param.min_size;
+    if (tune_new_wins(param, low)) {
+        return low;
+    }
+    high = low;
+    for (;;) {
+        high = MIN(high * 2, param.max_size);
+        if (tune_new_wins(param, high)) {
+            break;
+        }
+        if (high == param.max_size) {
+            return high;
+        }
+        low = high;
+    }
+
+    while (high - low > 1) {
+        mid = low + ((high - low) / 2);
+        if (tune_new_wins(param, mid)) {
+            high = mid;
+        }
+        else {
+            low = mid;
+        }
+    }
+    return high;
+}
+
+
+/*******************************************
+ *               OUTPUT                    *
+ *******************************************/
+
+//  The processor's name, for the header comment
+static std::string tune_cpu_name()
+{
+    std::string name;
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    unsigned int regs[12];
+    size_t start;
+
+    if (__get_cpuid_max(0x80000000, NULL) >= 0x80000004) {
+        __get_cpuid(0x80000002, &regs[0], &regs[1], &regs[2], &regs[3]);
+        __get_cpuid(0x80000003, &regs[4], &regs[5], &regs[6], &regs[7]);
+        __get_cpuid(0x80000004, &regs[8], &regs[9], &regs[10], &regs[11]);
+        name.assign((const char *)regs, sizeof(regs));
+        name.resize(strlen(name.c_str()));
+        start = name.find_first_not_of(' ');
+        name = (start == std::string::npos ? std::string() : name.substr(start));
+    }
+#endif
+    if (name.empty()) {
+        name = "this machine";
+    }
+    return name;
+}
+
+static bool tune_write_header(const char *path)
+{
+    char date[32];
+    time_t now;
+    FILE *file;
+    unsigned long i;
+
+    file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    now = time(NULL);
+    strftime(date, sizeof(date), "%d-%b-%Y", localtime(&now));
+    fprintf(file, "/*\n"
+                  " * Name:    bbi_tune.h\n"
+                  " * Purpose: Algorithm thresholds for %s\n"
+                  " *\n"
+                  " * Written by BigBigIntTune on %s.  Run it again to\n"
+                  " * update them.\n"
+                  " *\n"
+                  " */\n"
+                  "\n"
+                  "#ifndef __Andrasek_bbi_tune_h__\n"
+                  "#define __Andrasek_bbi_tune_h__\n"
+                  "\n", tune_cpu_name().c_str(), date);
+    for (i = 0; i < TUNE_NUM_PARAMS; i++) {
+        fprintf(file, "#ifndef %s\n"
+                      "    #define %-30s %lu\n"
+                      "#endif\n",
+                tune_params[i].macro, tune_params[i].macro, *tune_params[i].value);
+    }
+    fprintf(file, "\n#endif\n");
+    return (fclose(file) == 0);
+}
+
+
+/*******************************************
+ *                 MAIN                    *
+ *******************************************/
+
+static void tune_usage()
+{
+    fprintf(stderr, "usage: bbi_tune [-o FILE] [-v]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path;
+    unsigned long i;
+    int arg;
+
+    path = "bbi_tune.h";
+    for (arg = 1; arg < argc; arg++) {
+        if (strcmp(argv[arg], "-v") == 0) {
+            tune_verbose = true;
+        }
+        else if (strcmp(argv[arg], "-o") == 0 && arg + 1 < argc) {
+            path = argv[++arg];
+        }
+        else {
+            tune_usage();
+        }
+    }
+
+    for (i = 0; i < TUNE_MAX_LIMBS; i++) {
+        tune_a[i] = tune_random();
+        tune_b[i] = tune_random();
+    }
+
+    // Start from the defaults; each is replaced as it's measured
+    bbi_tune.mul_karatsuba = 32;
+    bbi_tune.sqr_karatsuba = 32;
+    bbi_tune.mul_fft = 4096;
+    bbi_tune.get_str_dc = 24;
+    bbi_tune.set_str_dc = 24;
+
+    printf("Tuning for %s\n", tune_cpu_name().c_str());
+    for (i = 0; i < TUNE_NUM_PARAMS; i++) {
+        *tune_params[i].value = tune_crossover(tune_params[i]);
+        printf("    %-30s %lu\n", tune_params[i].macro, *tune_params[i].value);
+        fflush(stdout);
+    }
+
+    if (!tune_write_header(path)) {
+        fprintf(stderr, "bbi_tune: can't write %s\n", path);
+        return 1;
+    }
+    printf("Wrote %s\n", path);
+    return 0;
+}
@@ -0,0 +1,322 @@
+/*
+ * Name:    FixedBigBigInt.h
+ * Purpose: Fixed-width (compile-time sized) companion to bigbigint
+ *
+ * Author:  Richard Andrasek
+ * Date:    18-Oct-2026
+ *
+ */
+
+#ifndef __Andrasek_FixedBigBigInt_hpp__
+#define __Andrasek_FixedBigBigInt_hpp__
+
+//-----------------------------------------------------------------------------
+//                            Required Includes
+//-----------------------------------------------------------------------------
+
+#include "BigBigInt.h"
+#include <stdint.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+//                          Notes
+//-----------------------------------------------------------------------------
+//
+//  fixed_bigbigint<Bits> is the stack-allocated cousin of bigbigint.  The
+//  width is a template parameter (a multiple of 64), so the limbs live in
+//  a plain array inside the object and nothing is ever malloc'd.  Every
+//  loop below runs a compile-time number of times, which lets the compiler
+//  unroll the carry chains completely and keep 256/512-bit values in
+//  registers.
+//
+//  The arithmetic is unsigned and wraps modulo 2^Bits, exactly like the
+//  built-in unsigned types.  A negative built-in integer or bigbigint
+//  converts to its two's complement value, sign extended across every
+//  limb, the same as assigning -1 to an unsigned int:  
+//  fixed_bigbigint<256>(-1) is 2^256 - 1.
+//
+//  The arithmetic is constexpr, so this header needs a C++14 compiler.
+//
+//      fixed_bigbigint<256> a(5), b(7);
+//      constexpr fixed_bigbigint<256> c = fixed_bigbigint<256>(3) * 4;
+//      bigbigint big = a * b;          // convert back to the dynamic type
+//
+
+//-----------------------------------------------------------------------------
+//                              Macros
+//-----------------------------------------------------------------------------
+//
+//  Ask the compiler to fully unroll the (fixed length) limb loops.
+#if defined(__clang__)
+    #define BBI_FIXED_UNROLL    _Pragma("unroll")
+#elif defined(__GNUC__) && (__GNUC__ >= 8)
+    #define BBI_FIXED_UNROLL    _Pragma("GCC unroll 64")
+#else
+    #define BBI_FIXED_UNROLL
+#endif
+
+
+//-----------------------------------------------------------------------------
+//                          Limb Helpers
+//-----------------------------------------------------------------------------
+
+namespace bbi_fixed_detail
+{
+    //  r = a + b + carry_in, returns the carry out (0 or 1)
+    constexpr uint64_t add_carry(uint64_t a, uint64_t b, uint64_t carry_in, uint64_t &r)
+    {
+        uint64_t sum = a + b;
+        uint64_t carry = (sum < a);
+        r = sum + carry_in;
+        return carry | (r < sum);
+    }
+
+    //  r = a - b - borrow_in, returns the borrow out (0 or 1)
+    constexpr uint64_t sub_borrow(uint64_t a, uint64_t b, uint64_t borrow_in, uint64_t &r)
+    {
+        uint64_t diff = a - b;
+        uint64_t borrow = (a < b);
+        r = diff - borrow_in;
+        return borrow | (diff < borrow_in);
+    }
+
+    //  hi:lo = a * b + c + d  (never overflows 128 bits)
+    constexpr uint64_t mul_add(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t &lo)
+    {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 result = (unsigned __int128)a * b + c + d;
+        lo = (uint64_t)result;
+        return (uint64_t)(result >> 64);
+#else
+        //  Portable version: split into 32-bit halves
+        uint64_t a_lo = a & 0xFFFFFFFFULL, a_hi = a >> 32;
+        uint64_t b_lo = b & 0xFFFFFFFFULL, b_hi = b >> 32;
+        uint64_t p0 = a_lo * b_lo;
+        uint64_t p1 = a_lo * b_hi;
+        uint64_t p2 = a_hi * b_lo;
+        uint64_t p3 = a_hi * b_hi;
+        uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFFULL) + (p2 & 0xFFFFFFFFULL);
+        uint64_t hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+        uint64_t low = (mid << 32) | (p0 & 0xFFFFFFFFULL);
+
+        low += c;
+        hi += (low < c);
+        low += d;
+        hi += (low < d);
+        lo = low;
+        return hi;
+#endif
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//                       Fixed BigBigInt Class
+//-----------------------------------------------------------------------------
+
+template <unsigned int Bits>
+class fixed_bigbigint
+{
+    static_assert(Bits > 0 && Bits % 64 == 0,
+        "fixed_bigbigint width must be a non-zero multiple of 64 bits");
+
+// ----
+public:
+// ----
+
+    static const unsigned int NUM_BITS = Bits;
+    static const unsigned int NUM_LIMBS = Bits / 64;
+
+//
+//  CON/DESTRUCTORS
+//
+    constexpr fixed_bigbigint() : _limbs() {}
+
+    //  One for each built-in integer type, so that none of them is 
+    //  ambiguous.  The signed ones sign extend.
+    constexpr fixed_bigbigint(int val) : fixed_bigbigint((long long)val) {}
+    constexpr fixed_bigbigint(long val) : fixed_bigbigint((long long)val) {}
+    constexpr fixed_bigbigint(long long val) : _limbs()
+    {
+        _limbs[0] = (uint64_t)val;
+        BBI_FIXED_UNROLL
+        for (unsigned int i = 1; i < NUM_LIMBS; i++) {
+            _limbs[i] = (val < 0 ? ~(uint64_t)0 : 0);
+        }
+    }
+    constexpr fixed_bigbigint(unsigned int val) : fixed_bigbigint((unsigned long long)val) {}
+    constexpr fixed_bigbigint(unsigned long val) : fixed_bigbigint((unsigned long long)val) {}
+    constexpr fixed_bigbigint(unsigned long long val) : _limbs()
+    {
+        _limbs[0] = val;
+    }
+
+    //  Truncates to Bits (two's complement for negative values)
+    explicit fixed_bigbigint(const bigbigint &val);
+
+//
+//  FUNCTIONS
+//
+    bigbigint to_bigbigint() const;
+    operator bigbigint() const { return to_bigbigint(); }
+
+    //  Limb access, least significant limb first
+    constexpr uint64_t limb(unsigned int index) const { return _limbs[index]; }
+    constexpr void set_limb(unsigned int index, uint64_t val) { _limbs[index] = val; }
+
+    constexpr bool is_zero() const
+    {
+        uint64_t bits = 0;
+        BBI_FIXED_UNROLL
+        for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+            bits |= _limbs[i];
+        }
+        return (bits == 0);
+    }
+
+    //  Returns -1, 0 or 1 (unsigned comparison)
+    constexpr int compare(const fixed_bigbigint &CompVal) const
+    {
+        //  Walk from the bottom limb up, letting each nonzero limb
+        //  difference overwrite the result, so the highest one that
+        //  differs decides.  Branch-free so the unrolled loop stays a
+        //  straight run of compares.
+        int result = 0;
+        BBI_FIXED_UNROLL
+        for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+            int limb_result = (_limbs[i] > CompVal._limbs[i]) - (_limbs[i] < CompVal._limbs[i]);
+            result = (limb_result != 0) ? limb_result : result;
+        }
+        return result;
+    }
+
+//
+//  OPERATOR OVERLOADS
+//
+    // Addition
+    constexpr fixed_bigbigint operator +(const fixed_bigbigint &PlusVal) const
+    {
+        fixed_bigbigint tVal;
+        uint64_t carry = 0;
+        BBI_FIXED_UNROLL
+        for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+            carry = bbi_fixed_detail::add_carry(_limbs[i], PlusVal._limbs[i], carry, tVal._limbs[i]);
+        }
+        return tVal;
+    }
+
+    // Subtraction
+    constexpr fixed_bigbigint operator -(const fixed_bigbigint &Subtrahend) const
+    {
+        fixed_bigbigint tVal;
+        uint64_t borrow = 0;
+        BBI_FIXED_UNROLL
+        for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+            borrow = bbi_fixed_detail::sub_borrow(_limbs[i], Subtrahend._limbs[i], borrow, tVal._limbs[i]);
+        }
+        return tVal;
+    }
+
+    // Negation (two's complement)
+    constexpr fixed_bigbigint operator -() const
+    {
+        return fixed_bigbigint() - *this;
+    }
+
+    // Multiplication (low Bits of the product)
+    //
+    //  Plain schoolbook; the partial products that land past the top
+    //  limb are never computed.
+    constexpr fixed_bigbigint operator *(const fixed_bigbigint &multiplier) const
+    {
+        fixed_bigbigint tVal;
+        BBI_FIXED_UNROLL
+        for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+            uint64_t carry = 0;
+            BBI_FIXED_UNROLL
+            for (unsigned int j = 0; j + i < NUM_LIMBS; j++) {
+                carry = bbi_fixed_detail::mul_add(_limbs[i], multiplier._limbs[j],
+                            tVal._limbs[i + j], carry, tVal._limbs[i + j]);
+            }
+        }
+        return tVal;
+    }
+
+    // Assignment variants
+    constexpr fixed_bigbigint &operator +=(const fixed_bigbigint &PlusVal)
+    {
+        *this = *this + PlusVal;
+        return *this;
+    }
+    constexpr fixed_bigbigint &operator -=(const fixed_bigbigint &Subtrahend)
+    {
+        *this = *this - Subtrahend;
+        return *this;
+    }
+    constexpr fixed_bigbigint &operator *=(const fixed_bigbigint &multiplier)
+    {
+        *this = *this * multiplier;
+        return *this;
+    }
+
+    // Comparison
+    constexpr bool operator ==(const fixed_bigbigint &CompVal) const
+    {
+        uint64_t diff = 0;
+        BBI_FIXED_UNROLL
+        for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+            diff |= _limbs[i] ^ CompVal._limbs[i];
+        }
+        return (diff == 0);
+    }
+    constexpr bool operator !=(const fixed_bigbigint &CompVal) const { return !(*this == CompVal); }
+    constexpr bool operator >(const fixed_bigbigint &CompVal) const  { return compare(CompVal) > 0; }
+    constexpr bool operator >=(const fixed_bigbigint &CompVal) const { return compare(CompVal) >= 0; }
+    constexpr bool operator <(const fixed_bigbigint &CompVal) const  { return compare(CompVal) < 0; }
+    constexpr bool operator <=(const fixed_bigbigint &CompVal) const { return compare(CompVal) <= 0; }
+
+
+// -----
+private:
+// -----
+
+    uint64_t _limbs[NUM_LIMBS];     // least significant limb first
+};
+
+
+//-----------------------------------------------------------------------------
+//                     Conversion to/from bigbigint
+//-----------------------------------------------------------------------------
+//
+//  bigbigint keeps its magnitude as 64-bit limbs (least significant
+//  first) with a separate sign flag, so this is a straight limb copy.
+//
+template <unsigned int Bits>
+fixed_bigbigint<Bits>::fixed_bigbigint(const bigbigint &val) : _limbs()
+{
+    unsigned long i, num_limbs;
+
+    num_limbs = MIN(val._length, (unsigned long)NUM_LIMBS);
+    for (i = 0; i < num_limbs; i++) {
+        _limbs[i] = val._limbs[i];
+    }
+
+    if (IS_NEGATIVE(val._flags)) {
+        *this = -*this;
+    }
+}
+
+template <unsigned int Bits>
+bigbigint fixed_bigbigint<Bits>::to_bigbigint() const
+{
+    bigbigint tVal((long)NUM_LIMBS);
+    unsigned long i;
+
+    tVal._flags = 0;
+    for (i = 0; i < NUM_LIMBS; i++) {
+        tVal._limbs[i] = _limbs[i];
+    }
+    return tVal;
+}
+
+#endif